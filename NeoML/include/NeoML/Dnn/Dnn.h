@@ -82,6 +82,7 @@ inline CLayerClassRegistrar<T>::~CLayerClassRegistrar()
 }
 
 class CDnn;
+class CDnnReference;
 class CDnnLayerGraph;
 class CBaseLayer;
 
@@ -263,6 +264,15 @@ protected:
 	// Fills with zeros the parameters that are less (but not equal) than a given threshold
 	virtual void FilterLayerParams( float /*threshold*/ ) {}
 
+	// Replaces the parameters with the ones of the same layer of another network (see CDnn::CreateReference)
+	// The layers that store the parameters outside of paramBlobs should override this method
+	virtual void ShareParams( const CBaseLayer& source );
+	// Moves the parameters into the storage and replaces them with nulls, so that only the architecture is serialized
+	// AttachParams takes them back from the storage starting at the given position (see CDnn::CreateReference)
+	// The layers that override ShareParams should override these methods as well
+	virtual void DetachParams( CObjectArray<IObject>& storage );
+	virtual void AttachParams( const CObjectArray<IObject>& storage, int& position );
+
 	// Retrieves the reference to the IMathEngine with which the layer was created
 	IMathEngine& MathEngine() const;
 
@@ -313,6 +323,8 @@ private:
 	CArray<int> outputs;
 	// The number of times each output was processed
 	CArray<int> outputProcessedCount;
+	// The output blobs placed in the arena of the network static memory plan
+	CObjectArray<CDnnBlob> plannedOutputBlobs;
 
 	// Indicates if the layer should be reshaped
 	bool isReshapeNeeded;
@@ -539,6 +551,21 @@ public:
 	// Enables profiling for all the layers in the network
 	void EnableProfile( bool profile );
 
+	// Enables static memory planning for inference
+	// After reshape RunOnce places all the intermediate output blobs into one preallocated arena:
+	// the blobs whose lifetimes don't overlap share memory and no memory is allocated for them during the run
+	void EnableStaticMemoryPlanning( bool enable );
+	bool IsStaticMemoryPlanningEnabled() const { return isStaticMemoryPlanningEnabled; }
+	// Gets the size of the planned arena in bytes (0 if there is no plan yet)
+	size_t GetPlannedMemorySize() const;
+
+	// Creates the network for concurrent inference: a copy of this network that shares the parameters (weights) with it
+	// Only the runtime blobs are allocated separately, so several copies may call RunOnce simultaneously
+	// in different threads with the same math engine
+	// The parameters must not be changed or trained while the copies are in use
+	// The parameters are not copied; the network must not be run in another thread while the copy is being created
+	CPtr<CDnnReference> CreateReference();
+
 private:
 	// Adds or deletes a layer
 	void AddLayerImpl(CBaseLayer& layer) override;
@@ -580,6 +607,10 @@ private:
 	bool autoRestartMode;
 	// The low memory use mode
 	bool isReuseMemoryMode;
+	// The static memory planning mode
+	bool isStaticMemoryPlanningEnabled;
+	// The arena for the planned output blobs; null if there is no valid plan
+	CPtr<CDnnBlob> memoryPlanArena;
 
 	void setProcessingParams(bool isRecurrentMode, int sequenceLength, bool isReverseSequense, bool isBackwardPerformed);
 	void runOnce(int curSequencePos);
@@ -587,12 +618,33 @@ private:
 	void reshape();
 	void rebuild();
 	size_t getOutputBlobsSize() const;
+	void planMemory();
+	void clearMemoryPlan();
+	void shareParams( const CDnn& source );
+	void detachParams( CObjectArray<IObject>& storage );
+	void attachParams( const CObjectArray<IObject>& storage, int& position );
 
 	friend class CBaseLayer;
 	friend class CCompositeLayer;
 	friend class CRecurrentLayer;
 };
 
+// The network created by CDnn::CreateReference
+// Has its own layers and runtime blobs but shares the parameters with the original network
+class NEOML_API CDnnReference : public IObject {
+public:
+	CDnn& Dnn() { return dnn; }
+	const CDnn& Dnn() const { return dnn; }
+
+private:
+	CRandom random;
+	CDnn dnn;
+
+	explicit CDnnReference( IMathEngine& mathEngine ) : dnn( random, mathEngine ) {}
+
+	friend class CDnn;
+};
+
 inline CArchive& operator<<( CArchive& archive, const CDnn& dnn)
 {
 	const_cast<CDnn&>(dnn).Serialize( archive );
@@ -0,0 +1,48 @@
+/* Copyright © 2017-2021 ABBYY Production LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+--------------------------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <NeoML/NeoMLDefs.h>
+
+namespace NeoML {
+
+class CDnn;
+
+// The statistics of the changes made by OptimizeForInference
+struct NEOML_API CDnnOptimizationReport {
+	// The number of batch normalization layers folded into the weights of the previous convolution or fully-connected layer
+	int FoldedBatchNormalizations;
+	// The number of activation layers folded into the previous convolution or fully-connected layer
+	int FusedActivations;
+	// The number of activation layers fused into the previous eltwise sum (residual blocks)
+	int FusedSumActivations;
+
+	CDnnOptimizationReport() : FoldedBatchNormalizations( 0 ), FusedActivations( 0 ), FusedSumActivations( 0 ) {}
+};
+
+// Optimizes the trained network for inference by merging the layers on the top level of the network:
+// - CBatchNormalizationLayer after CConvLayer or CFullyConnectedLayer is folded into their weights
+// - an activation layer (see CFusedActivation) after CConvLayer, CFullyConnectedLayer or CEltwiseSumLayer
+//   is folded into that layer, which applies the activation to its output
+//   For the convolution and fully-connected layers this removes only the separate layer and its output blob;
+//   the activation is still a separate pass over the output after the matrix product
+//   The eltwise sum on CPU applies the activation to every cache-sized part of the sum right after it is calculated
+// A layer is merged only if its input is not used by any other layer
+// The merged layers are deleted from the network, and their consumers are connected to the remaining layers
+// After the optimization the network may not be trained
+NEOML_API CDnnOptimizationReport OptimizeForInference( CDnn& dnn );
+
+} // namespace NeoML
@@ -0,0 +1,94 @@
+/* Copyright © 2017-2021 ABBYY Production LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+--------------------------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <NeoML/NeoMLDefs.h>
+#include <NeoML/Dnn/DnnBlob.h>
+
+namespace NeoML {
+
+class CDnn;
+
+// The int8 weights of a fully-connected or a convolution layer
+// Every object of the float weights blob (a neuron or a filter) is quantized symmetrically with its own scale
+// Int8 inference is supported only on CPU
+class NEOML_API CDnnInt8Weights : public IObject {
+public:
+	explicit CDnnInt8Weights( IMathEngine& mathEngine );
+	// Quantizes the float weights
+	// inputScale is the scale for quantizing the layer input; 0 means that it's calculated on every run
+	CDnnInt8Weights( const CDnnBlob& weights, float inputScale );
+
+	IMathEngine& MathEngine() const { return mathEngine; }
+
+	// The descriptor of the original float weights
+	const CBlobDesc& GetDesc() const { return desc; }
+	// The quantized data, of GetDesc().BlobSize() size
+	CConstInt8Handle GetData() const { return data->GetHandle(); }
+	// The scales of the weights objects, of GetDesc().ObjectCount() size
+	CConstFloatHandle GetScales() const { return scales->GetData(); }
+	// The scale for quantizing the layer input (0 for dynamic quantization)
+	float GetInputScale() const { return inputScale; }
+
+	// Restores the float weights (with the quantization error)
+	CPtr<CDnnBlob> Dequantize() const;
+
+	void Serialize( CArchive& archive );
+
+protected:
+	~CDnnInt8Weights() override;
+
+private:
+	IMathEngine& mathEngine;
+	CBlobDesc desc; // the original float weights descriptor
+	float inputScale; // the input quantization scale
+	CInt8HandleVar* data; // the quantized weights
+	CPtr<CDnnBlob> scales; // the scales of the weights objects
+};
+
+// Serializes the int8 weights which may be null
+NEOML_API void SerializeInt8Weights( IMathEngine& mathEngine, CArchive& archive, CPtr<CDnnInt8Weights>& weights );
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// CDnnInt8Quantizer converts the weights of the fully-connected and convolution layers of the network to int8
+// The layers are searched for on the top level of the network only
+// Usage: fill the source layers with a calibration batch and call Calibrate(), repeat for every batch,
+// then call Quantize()
+class NEOML_API CDnnInt8Quantizer {
+public:
+	explicit CDnnInt8Quantizer( CDnn& dnn );
+
+	// Runs the network on the current data of the source layers
+	// and collects the ranges of the inputs of the layers to be quantized
+	void Calibrate();
+	// The number of batches used for calibration
+	int GetCalibrationBatchCount() const { return calibrationBatchCount; }
+
+	// Quantizes the weights of the layers
+	// The layers that were calibrated get the static input scale, the others quantize their inputs on every run
+	// Returns the number of quantized layers
+	int Quantize();
+
+private:
+	CDnn& dnn;
+	int calibrationBatchCount; // the number of batches used for calibration
+	CMap<CString, float> inputRanges; // the maximum absolute value of the input for each layer
+
+	void getLayersToQuantize( CArray<CString>& layerNames ) const;
+};
+
+} // namespace NeoML
@@ -43,6 +43,28 @@ enum TActivationFunction {
 // Creates an activation layer using the specified activation function
 CPtr<CBaseLayer> NEOML_API CreateActivationLayer( IMathEngine& mathEngine, TActivationFunction type );
 
+// The activation applied by a layer to its own output (see OptimizeForInference)
+// Only the activations that do not need any data except the input may be fused
+struct NEOML_API CFusedActivation {
+	TActivationFunction Type; // AF_Linear means that there is no activation
+	float Param; // the upper threshold for AF_ReLU, alpha for AF_LeakyReLU and AF_ELU
+
+	CFusedActivation() : Type( AF_Linear ), Param( 0 ) {}
+
+	bool IsEmpty() const { return Type == AF_Linear; }
+
+	// Retrieves the description of the activation layer; returns false if the layer can't be fused
+	static bool FromLayer( const CBaseLayer& layer, CFusedActivation& result );
+
+	// Applies the activation to the data in place
+	void Apply( IMathEngine& mathEngine, const CFloatHandle& data, int dataSize ) const;
+	// The same, but the Param value is already stored in the math engine memory
+	// Use it when the activation is applied to the data by parts
+	void Apply( IMathEngine& mathEngine, const CFloatHandle& data, int dataSize, const CConstFloatHandle& param ) const;
+
+	void Serialize( CArchive& archive );
+};
+
 //------------------------------------------------------------------------------------------------------------
 
 // The layer that uses a linear activation function a*x + b
@@ -48,6 +48,12 @@ public:
 	const CPtr<CDnnBlob>& GetState() const;
 	void SetState(const CPtr<CDnnBlob>& state);
 
+	// Used by the recurrent layers which process the whole sequence at once instead of running the internal network
+	// Retrieves the state before the first step: the initial state (if any) at the start of a sequence, or the saved state
+	CConstFloatHandle GetInitialState( const CDnnBlob* initialState );
+	// Saves the state after the last step
+	void CompleteSequence( const CConstFloatHandle& lastState );
+
 protected:
 	// CBaseLayer methods
 	void Reshape() override;
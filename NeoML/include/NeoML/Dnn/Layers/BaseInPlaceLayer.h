@@ -22,6 +22,10 @@ namespace NeoML {
 
 // CBaseInPlaceLayer is the base class for an in-place processing layer
 class NEOML_API CBaseInPlaceLayer : public CBaseLayer {
+public:
+	// Indicates if the layer output blobs are its input blobs (valid after reshape)
+	bool IsInPlace() const { return isInPlace; }
+
 protected:
 	CBaseInPlaceLayer(IMathEngine& mathEngine, const char* name, bool isLearnable = false) : CBaseLayer(mathEngine, name, isLearnable), isInPlace( false ) {};
 
@@ -63,6 +63,9 @@ protected:
 	void RunOnce() override;
 	void BackwardOnce() override;
 	void LearnOnce() override;
+	void ShareParams( const CBaseLayer& source ) override;
+	void DetachParams( CObjectArray<IObject>& storage ) override;
+	void AttachParams( const CObjectArray<IObject>& storage, int& position ) override;
 
 private:
 	bool isChannelBased;
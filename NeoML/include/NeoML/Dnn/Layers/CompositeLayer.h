@@ -80,6 +80,9 @@ protected:
 	void LearnOnce() override;
 	void OnDnnChanged( CDnn* ) override;
 	void FilterLayerParams( float threshold ) override;
+	void ShareParams( const CBaseLayer& source ) override;
+	void DetachParams( CObjectArray<IObject>& storage ) override;
+	void AttachParams( const CObjectArray<IObject>& storage, int& position ) override;
 	
 	// The network object for the internal layers
 	const CDnn* GetInternalDnn() const { return internalDnn; }
@@ -17,7 +17,9 @@ limitations under the License.
 
 #include <NeoML/NeoMLDefs.h>
 #include <NeoML/Dnn/Layers/BatchNormalizationLayer.h>
+#include <NeoML/Dnn/Layers/ActivationLayers.h>
 #include <NeoML/Dnn/Dnn.h>
+#include <NeoML/Dnn/DnnQuantization.h>
 
 namespace NeoML {
 
@@ -119,6 +121,21 @@ public:
 
 	void Serialize( CArchive& archive ) override;
 
+	// Returns the dequantized filter for the quantized layer
+	CPtr<CDnnBlob> GetFilterData() const override;
+	void SetFilterData( const CPtr<CDnnBlob>& newFilter ) override;
+
+	// Converts the filter to int8; after that the layer may be used only for inference on CPU
+	// inputScale is the scale for quantizing the input; 0 means that every input window is quantized with its own scale
+	void QuantizeWeights( float inputScale = 0 );
+	bool IsQuantized() const { return int8Filter != nullptr; }
+	const CDnnInt8Weights* GetInt8Weights() const { return int8Filter; }
+
+	// The activation applied to the output after the layer is calculated (see OptimizeForInference)
+	// The layer with the fused activation may be used only for inference
+	const CFusedActivation& GetFusedActivation() const { return fusedActivation; }
+	void SetFusedActivation( const CFusedActivation& activation );
+
 protected:
 	virtual ~CConvLayer();
 
@@ -126,9 +143,14 @@ protected:
 	void RunOnce() override;
 	void BackwardOnce() override;
 	void LearnOnce() override;
+	void ShareParams( const CBaseLayer& source ) override;
+	void DetachParams( CObjectArray<IObject>& storage ) override;
+	void AttachParams( const CObjectArray<IObject>& storage, int& position ) override;
 
 private:
 	CConvolutionDesc* convDesc; // the convolution descriptor
+	CPtr<CDnnInt8Weights> int8Filter; // the quantized filter (instead of the float filter)
+	CFusedActivation fusedActivation; // the activation applied to the output
 
 	void calcOutputBlobSize(int& outputHeight, int& outputWidth) const;
 	void initConvDesc();
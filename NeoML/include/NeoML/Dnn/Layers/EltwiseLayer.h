@@ -17,6 +17,7 @@ limitations under the License.
 
 #include <NeoML/NeoMLDefs.h>
 #include <NeoML/Dnn/Dnn.h>
+#include <NeoML/Dnn/Layers/ActivationLayers.h>
 
 namespace NeoML {
 
@@ -40,9 +41,18 @@ public:
 
 	void Serialize( CArchive& archive ) override;
 
+	// The activation applied to the sum (see OptimizeForInference)
+	// The layer with the fused activation may be used only for inference
+	const CFusedActivation& GetFusedActivation() const { return fusedActivation; }
+	void SetFusedActivation( const CFusedActivation& activation );
+
 protected:
+	void Reshape() override;
 	void RunOnce() override;
 	void BackwardOnce() override;
+
+private:
+	CFusedActivation fusedActivation; // the activation applied to the sum
 };
 
 NEOML_API CLayerWrapper<CEltwiseSumLayer> Sum();
@@ -17,7 +17,9 @@ limitations under the License.
 
 #include <NeoML/NeoMLDefs.h>
 #include <NeoML/Dnn/Layers/BatchNormalizationLayer.h>
+#include <NeoML/Dnn/Layers/ActivationLayers.h>
 #include <NeoML/Dnn/Dnn.h>
+#include <NeoML/Dnn/DnnQuantization.h>
 
 namespace NeoML {
 
@@ -54,6 +56,18 @@ public:
 	bool IsZeroFreeTerm() const { return isZeroFreeTerm; }
 	void SetZeroFreeTerm(bool _isZeroFreeTerm);
 
+	// Converts the weights to int8; after that the layer may be used only for inference on CPU
+	// inputScale is the scale for quantizing the input; 0 means that every input vector is quantized with its own scale
+	// GetWeightsData returns the dequantized weights for the quantized layer
+	void QuantizeWeights( float inputScale = 0 );
+	bool IsQuantized() const { return int8Weights != nullptr; }
+	const CDnnInt8Weights* GetInt8Weights() const { return int8Weights; }
+
+	// The activation applied to the output after the layer is calculated (see OptimizeForInference)
+	// The layer with the fused activation may be used only for inference
+	const CFusedActivation& GetFusedActivation() const { return fusedActivation; }
+	void SetFusedActivation( const CFusedActivation& activation );
+
 protected:
 	virtual ~CFullyConnectedLayer();
 
@@ -62,6 +76,9 @@ protected:
 	void BackwardOnce() override;
 	void LearnOnce() override;
 	void FilterLayerParams( float threshold ) override;
+	void ShareParams( const CBaseLayer& source ) override;
+	void DetachParams( CObjectArray<IObject>& storage ) override;
+	void AttachParams( const CObjectArray<IObject>& storage, int& position ) override;
 
 	// The filter. The pointer is valid only if the desired parameters are known (either defined externally or obtained on reshape)
 	CPtr<CDnnBlob>& Weights() { return paramBlobs[0]; }
@@ -74,8 +91,14 @@ protected:
 	const CPtr<CDnnBlob>& FreeTerms() const { return paramBlobs[1]; }	// the free term matrix
 
 private:
+	// The recurrent layers use the weights directly when processing the whole sequence at once
+	friend class CLstmLayer;
+	friend class CGruLayer;
+
 	int numberOfElements; // the number of elements (neurons) of the fully-connected layer
 	bool isZeroFreeTerm; // indicates if the free term should be set to zero
+	CPtr<CDnnInt8Weights> int8Weights; // the quantized weights (instead of the float weights)
+	CFusedActivation fusedActivation; // the activation applied to the output
 };
 
 NEOML_API CLayerWrapper<CFullyConnectedLayer> FullyConnected(
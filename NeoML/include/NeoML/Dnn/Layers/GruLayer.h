@@ -38,15 +38,19 @@ public:
 	CPtr<CDnnBlob> GetMainWeightsData() const { return mainLayer->GetWeightsData(); }
 	CPtr<CDnnBlob> GetMainFreeTermData() const { return mainLayer->GetFreeTermData(); }
 
-	void SetMainWeightsData(CDnnBlob* newWeights) { mainLayer->SetWeightsData(newWeights); }
+	void SetMainWeightsData(CDnnBlob* newWeights) { mainLayer->SetWeightsData(newWeights); clearSplitWeights(); }
 	void SetMainFreeTermData(CDnnBlob* newFreeTerm) { mainLayer->SetFreeTermData(newFreeTerm); }
 
 	CPtr<CDnnBlob> GetGateWeightsData() const { return gateLayer->GetWeightsData(); }
 	CPtr<CDnnBlob> GetGateFreeTermData() const { return gateLayer->GetFreeTermData(); }
 
-	void SetGateWeightsData(CDnnBlob* newWeights) { gateLayer->SetWeightsData(newWeights); }
+	void SetGateWeightsData(CDnnBlob* newWeights) { gateLayer->SetWeightsData(newWeights); clearSplitWeights(); }
 	void SetGateFreeTermData(CDnnBlob* newFreeTerm) { gateLayer->SetFreeTermData(newFreeTerm); }
 
+protected:
+	// During inference the whole sequence is processed at once by IMathEngine::GruRecurrent
+	void RunOnce() override;
+
 private:
 	// The indices of the gates in the hidden layer output
 	enum TGateOut {
@@ -61,7 +65,21 @@ private:
 	CPtr<CSplitChannelsLayer> splitLayer;
 	CPtr<CBackLinkLayer> mainBackLink;
 
+	// The weights split into the input and the recurrent parts (used by processWholeSequence)
+	// Calculated again after the weights are set, learned or replaced by another blob
+	CPtr<CDnnBlob> gateInputWeights;
+	CPtr<CDnnBlob> gateRecurWeights;
+	CPtr<CDnnBlob> mainInputWeights;
+	CPtr<CDnnBlob> mainRecurWeights;
+	// The weights from which the split weights were calculated
+	CPtr<const CDnnBlob> splitGateWeights;
+	CPtr<const CDnnBlob> splitMainWeights;
+
 	void buildLayer();
+	bool canProcessWholeSequence() const;
+	void processWholeSequence();
+	void updateSplitWeights( int inputSize );
+	void clearSplitWeights();
 };
 
 NEOML_API CLayerWrapper<CGruLayer> Gru( int hiddenSize );
@@ -66,6 +66,10 @@ public:
 	bool IsInCompatibilityMode() const { return isInCompatibilityMode; }
 	void SetCompatibilityMode( bool compatibilityMode );
 
+protected:
+	// During inference the whole sequence is processed at once by IMathEngine::LstmRecurrent
+	void RunOnce() override;
+
 private:
 	// The gate numbers for the hidden layer output
 	enum TGateOut {
@@ -94,6 +98,8 @@ private:
 
 	void buildLayer(float dropout);
 	void setWeightsData(const CPtr<CDnnBlob>& newWeights);
+	bool canProcessWholeSequence() const;
+	void processWholeSequence();
 };
 
 NEOML_API CLayerWrapper<CLstmLayer> Lstm(
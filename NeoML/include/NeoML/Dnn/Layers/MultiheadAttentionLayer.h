@@ -20,6 +20,9 @@ limitations under the License.
 
 namespace NeoML {
 
+// Forward declaration(s)
+class CMultiheadAttentionFusedLayer;
+
 // Multihead Self Attention
 // UNIVERSAL TRANSFORMERS https://arxiv.org/pdf/1706.03762.pdf 
 // Attention Is All You Need https://arxiv.org/pdf/1807.03819.pdf
@@ -43,6 +46,9 @@ namespace NeoML {
 //  W_* - trainable parameters and W_O is an additional trainable matrix of size (GetHiddenSize() x GetOutputSize())
 //
 // Result has size (1, BatchWidth, ListSize_Q, 1, 1, 1, GetOutputSize())
+//
+// The layer has the second output with the attention matrix (after the dropout)
+// This output is unavailable when the fused kernel is used
 class NEOML_API CMultiheadAttentionLayer : public CCompositeLayer {
 	NEOML_DNN_LAYER( CMultiheadAttentionLayer )
 public:
@@ -73,6 +79,15 @@ public:
 	int GetOutputSize() const { return outputSize; }
 	void SetOutputSize( int _outputSize );
 
+	// Calculates the attention by a single IMathEngine::MultiheadAttention call
+	// instead of the chain of the matrix multiplications, transposes and softmax
+	// The whole attention matrix is never stored which saves memory and time on long sequences
+	// Inference only, the dropout is ignored and the second output is unavailable
+	// Switching this mode keeps the trained weights
+	// By default the fused kernel is not used
+	bool GetUseFusedKernel() const { return useFusedKernel; }
+	void SetUseFusedKernel( bool newValue );
+
 	void Serialize( CArchive& archive ) override;
 
 protected:
@@ -89,8 +104,11 @@ private:
 	bool useMask;
 	// Output size
 	int outputSize;
+	// Fused kernel usage
+	bool useFusedKernel;
 
 	void create();
+	void deleteAttentionLayers();
 
 	// Layer inputs
 	enum TInputs {
@@ -115,6 +133,39 @@ private:
 	CBaseLayer* prepareK( CBaseLayer* input );
 	CBaseLayer* prepareV( CBaseLayer* input );
 	CBaseLayer* prepareOutput( CBaseLayer* input );
+	CBaseLayer* fusedAttention( CBaseLayer* Q, CBaseLayer* K, CBaseLayer* V );
+};
+
+// The attention part of the multihead attention calculated by IMathEngine::MultiheadAttention
+//
+//  Inputs:
+//  #0 - matrix W_Q * Q (1 x BatchWidth x ListSize_Q x 1 x 1 x 1 x hiddenSize)
+//  #1 - matrix W_K * K (1 x BatchWidth x ListSize_V x 1 x 1 x 1 x hiddenSize)
+//  #2 - matrix W_V * V (1 x BatchWidth x ListSize_V x 1 x 1 x 1 x hiddenSize)
+//  #3 - mask (optional), a single object of ListSize_Q * ListSize_V elements
+//
+// Result is concat( head_1, ..., head_N ) of size (1 x BatchWidth x ListSize_Q x 1 x 1 x 1 x hiddenSize)
+// Inference only
+class NEOML_API CMultiheadAttentionFusedLayer : public CBaseLayer {
+	NEOML_DNN_LAYER( CMultiheadAttentionFusedLayer )
+public:
+	explicit CMultiheadAttentionFusedLayer( IMathEngine& mathEngine );
+
+	void Serialize( CArchive& archive ) override;
+
+	// The number of heads in attention
+	// The number of input channels must be a multiple of this value
+	int GetHeadCount() const { return headCount; }
+	void SetHeadCount( int headCount );
+
+protected:
+	void Reshape() override;
+	void RunOnce() override;
+	void BackwardOnce() override;
+
+private:
+	// The amount of heads
+	int headCount;
 };
 
 NEOML_API CLayerWrapper<CMultiheadAttentionLayer> MultiheadAttention(
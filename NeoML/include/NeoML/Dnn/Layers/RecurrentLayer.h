@@ -55,6 +55,10 @@ protected:
 	void RunInternalDnnBackward() override;
 	void SetInternalDnnParams() override;
 
+	// Checks if the layer may process the whole sequence at once instead of running the internal network step by step
+	// That is possible only for inference over the whole sequence with the initial states of 1 step length
+	bool CanProcessWholeSequence() const;
+
 private:
 	// The backward links
 	CObjectArray<CBackLinkLayer> backLinks;
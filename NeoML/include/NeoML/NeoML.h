@@ -38,6 +38,8 @@ limitations under the License.
 #include <NeoML/Dnn/AutoDiff.h>
 #include <NeoML/Dnn/AutoDiffFunctions.h>
 #include <NeoML/Dnn/Dnn.h>
+#include <NeoML/Dnn/DnnOptimization.h>
+#include <NeoML/Dnn/DnnQuantization.h>
 #include <NeoML/Dnn/Layers/BaseInPlaceLayer.h>
 #include <NeoML/Dnn/Layers/SourceLayer.h>
 #include <NeoML/Dnn/Layers/SinkLayer.h>
@@ -201,6 +201,10 @@ void CBaseLayer::AllocateOutputBlobs()
 	CMemoryModeSwitcher switcher( MathEngine(), GetDnn()->isReuseMemoryMode );
 
 	for( int i = 0; i < outputDescs.Size(); ++i ) {
+		if( outputBlobs[i] == 0 && i < plannedOutputBlobs.Size() ) {
+			// The blob has been placed in the network memory plan
+			outputBlobs[i] = plannedOutputBlobs[i];
+		}
 		if( outputBlobs[i] == 0 ) {
 			outputBlobs[i] = CDnnBlob::CreateBlob( MathEngine(), outputDescs[i].GetDataType(), outputDescs[i] );
 		} else {
@@ -339,6 +343,9 @@ void CBaseLayer::reshape()
 	// Reshaping the layer
 	forcedReshape = false;
 
+	// The memory plan was built for the previous sizes
+	dnn->clearMemoryPlan();
+
 	inputBlobs.DeleteAll();
 	outputBlobs.DeleteAll();
 
@@ -688,6 +695,29 @@ void CBaseLayer::LearnOnce()
 	NeoAssert( false );	// by default learning is disabled
 }
 
+void CBaseLayer::ShareParams( const CBaseLayer& source )
+{
+	CheckArchitecture( source.paramBlobs.Size() == paramBlobs.Size(), GetName(), "the number of parameters mismatch" );
+	for( int i = 0; i < paramBlobs.Size(); ++i ) {
+		paramBlobs[i] = source.paramBlobs[i];
+	}
+}
+
+void CBaseLayer::DetachParams( CObjectArray<IObject>& storage )
+{
+	for( int i = 0; i < paramBlobs.Size(); ++i ) {
+		storage.Add( paramBlobs[i].Ptr() );
+		paramBlobs[i] = nullptr;
+	}
+}
+
+void CBaseLayer::AttachParams( const CObjectArray<IObject>& storage, int& position )
+{
+	for( int i = 0; i < paramBlobs.Size(); ++i ) {
+		paramBlobs[i] = static_cast<CDnnBlob*>( storage[position++].Ptr() );
+	}
+}
+
 void CBaseLayer::InitializeParamBlob(int input, CDnnBlob& blob, int inputCount)
 {
 	NeoAssert(GetDnn() != 0);
@@ -315,6 +315,7 @@ REGISTER_NEOML_LAYER( CAttentionSumLayer, "FmlCnnAttentionSumLayer" )
 REGISTER_NEOML_LAYER( CAddToObjectLayer, "NeoMLDnnAddToObjectLayer" )
 REGISTER_NEOML_LAYER( CMatrixMultiplicationLayer, "NeoMLDnnMatrixMultiplicationLayer" )
 REGISTER_NEOML_LAYER( CMultiheadAttentionLayer, "NeoMLDnnMultiheadAttentionLayer" )
+REGISTER_NEOML_LAYER( CMultiheadAttentionFusedLayer, "NeoMLDnnMultiheadAttentionFusedLayer" )
 REGISTER_NEOML_LAYER( CPositionalEmbeddingLayer, "NeoMLDnnPositionalEmbeddingLayer" )
 REGISTER_NEOML_LAYER( CGELULayer, "NeoMLDnnGELULayer" )
 REGISTER_NEOML_LAYER( CProjectionPoolingLayer, "FmlCnnProjectionPoolingLayerClass" )
@@ -347,7 +348,8 @@ CDnn::CDnn( CRandom& _random, IMathEngine& _mathEngine ) :
 	currentSequencePos( 0 ),
 	isReverseSequense( false ),
 	autoRestartMode( true ),
-	isReuseMemoryMode( false )
+	isReuseMemoryMode( false ),
+	isStaticMemoryPlanningEnabled( false )
 {
 	solver = FINE_DEBUG_NEW CDnnSimpleGradientSolver( mathEngine );
 	initializer = FINE_DEBUG_NEW CDnnXavierInitializer( random );
@@ -413,6 +415,8 @@ void CDnn::DeleteLayerImpl( CBaseLayer& layer )
 
 	// Set the flag that indicates the network should be rebuilt (configuration has changed)
 	ForceRebuild();
+	// The layer must not keep the blobs from the network arena
+	clearMemoryPlan();
 	// Unlink all layer connections
 	layer.unlink();
 	// Delete the layer from the table
@@ -524,6 +528,9 @@ void CDnn::RunOnce()
 			RestartSequence();
 		}
 		reshape(); // rebuild the network if necessary
+		if( isStaticMemoryPlanningEnabled && memoryPlanArena == 0 ) {
+			planMemory();
+		}
 		
 		isReuseMemoryMode = ( getOutputBlobsSize() > MinReuseMemoryModeNetSize );
 		runOnce(0);
@@ -560,6 +567,8 @@ void CDnn::RunAndBackwardOnce()
 			RestartSequence();
 		}
 		reshape(); // rebuild the network if necessary
+		// The planned blobs are shared, but backpropagation needs all the outputs
+		clearMemoryPlan();
 		isReuseMemoryMode = false;
 		runOnce(0);
 		backwardRunAndLearnOnce(0);
@@ -584,6 +593,7 @@ void CDnn::RunAndLearnOnce()
 
 void CDnn::CleanUp()
 {
+	clearMemoryPlan();
 	for( int i = 0; i < layers.Size(); i++ ) {
 		layers[i]->CleanUp();
 	}
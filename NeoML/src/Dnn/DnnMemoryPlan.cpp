@@ -0,0 +1,235 @@
+/* Copyright © 2017-2021 ABBYY Production LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+--------------------------------------------------------------------------------------------------------------*/
+
+#include <common.h>
+#pragma hdrstop
+
+#include <NeoML/Dnn/Dnn.h>
+#include <NeoML/Dnn/Layers/BaseInPlaceLayer.h>
+#include <NeoML/Dnn/Layers/CompositeLayer.h>
+#include <climits>
+
+namespace NeoML {
+
+// The alignment of the blobs in the arena, in elements
+static const int MemoryPlanAlignment = 64;
+
+// The blob placed in the memory plan arena
+// Doesn't own its data and keeps the arena alive instead
+class CDnnPlannedBlob : public CDnnBlob {
+public:
+	CDnnPlannedBlob( const CPtr<CDnnBlob>& _arena, const CBlobDesc& desc, int offset ) :
+		CDnnBlob( _arena->GetMathEngine(), desc, _arena->GetData() + offset, false ),
+		arena( _arena )
+	{
+	}
+
+private:
+	CPtr<CDnnBlob> arena;
+};
+
+// A block of the memory plan: the output blob of a layer together with the in-place outputs that share its data
+struct CMemoryPlanBlock {
+	CBaseLayer* Layer;
+	int Output;
+	int Size; // the aligned size in elements
+	int Start; // the first step when the block is used
+	int End; // the last step when the block is used
+	int Offset; // the position in the arena
+
+	CMemoryPlanBlock() : Layer( 0 ), Output( 0 ), Size( 0 ), Start( 0 ), End( 0 ), Offset( 0 ) {}
+	CMemoryPlanBlock( CBaseLayer* layer, int output, int size, int step ) :
+		Layer( layer ), Output( output ), Size( size ), Start( step ), End( step ), Offset( 0 ) {}
+
+	bool Intersects( const CMemoryPlanBlock& other ) const { return Start <= other.End && other.Start <= End; }
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+
+void CDnn::EnableStaticMemoryPlanning( bool enable )
+{
+	isStaticMemoryPlanningEnabled = enable;
+	if( !enable ) {
+		clearMemoryPlan();
+	}
+}
+
+size_t CDnn::GetPlannedMemorySize() const
+{
+	return memoryPlanArena == 0 ? 0 : memoryPlanArena->GetDataSize() * sizeof( float );
+}
+
+// Places the output blobs of all layers in one arena
+// The layers are processed in the same order as in runOnce; a blob lives from the step of the layer that creates it
+// to the step of its last consumer. The blobs with non-overlapping lifetimes may share memory
+void CDnn::planMemory()
+{
+	clearMemoryPlan();
+	if( isRecurrentMode || isBackwardPerformed ) {
+		return;
+	}
+
+	// The layers in the order of execution
+	CArray<CBaseLayer*> order;
+	CMap<const CBaseLayer*, int> steps;
+	CArray<CBaseLayer*> stack;
+	CArray<int> nextInput;
+	for( int i = 0; i < sinkLayers.Size(); ++i ) {
+		if( steps.Has( sinkLayers[i] ) ) {
+			continue;
+		}
+		stack.Add( sinkLayers[i] );
+		nextInput.Add( 0 );
+		while( !stack.IsEmpty() ) {
+			CBaseLayer* layer = stack.Last();
+			if( nextInput.Last() < layer->GetInputCount() ) {
+				CBaseLayer* inputLayer = layer->GetInputLayer( nextInput.Last()++ );
+				if( !steps.Has( inputLayer ) ) {
+					stack.Add( inputLayer );
+					nextInput.Add( 0 );
+				}
+				continue;
+			}
+			steps.Add( layer, order.Size() );
+			order.Add( layer );
+			stack.DeleteLast();
+			nextInput.DeleteLast();
+		}
+	}
+
+	// The lifetimes of the blocks
+	CArray<CMemoryPlanBlock> blocks;
+	CArray<int> outputBlocks; // the block of each layer output (NotFound if the output is not planned)
+	CMap<const CBaseLayer*, int> firstOutputBlock; // the position of the layer outputs in outputBlocks
+	for( int step = 0; step < order.Size(); ++step ) {
+		CBaseLayer* layer = order[step];
+		// The inputs of the layers without outputs (sinks, losses) may be read after the run
+		const int lastUse = layer->GetOutputCount() == 0 ? INT_MAX : step;
+		for( int i = 0; i < layer->GetInputCount(); ++i ) {
+			const int block = outputBlocks[firstOutputBlock.Get( layer->GetInputLayer( i ) ) + layer->inputLinks[i].OutputNumber];
+			if( block != NotFound ) {
+				blocks[block].End = max( blocks[block].End, lastUse );
+			}
+		}
+
+		const CBaseInPlaceLayer* inPlaceLayer = dynamic_cast<const CBaseInPlaceLayer*>( layer );
+		const bool isInPlace = inPlaceLayer != 0 && inPlaceLayer->IsInPlace();
+		// The source layers and the composite layers don't use the standard output blobs allocation
+		const bool isPlanned = !isInPlace && layer->GetInputCount() != 0 && dynamic_cast<CCompositeLayer*>( layer ) == 0;
+
+		firstOutputBlock.Add( layer, outputBlocks.Size() );
+		for( int output = 0; output < layer->GetOutputCount(); ++output ) {
+			int block = NotFound;
+			if( isInPlace && output < layer->GetInputCount() ) {
+				block = outputBlocks[firstOutputBlock.Get( layer->GetInputLayer( output ) ) + layer->inputLinks[output].OutputNumber];
+			} else if( isPlanned ) {
+				const int size = ( layer->outputDescs[output].BlobSize() + MemoryPlanAlignment - 1 )
+					/ MemoryPlanAlignment * MemoryPlanAlignment;
+				block = blocks.Size();
+				blocks.Add( CMemoryPlanBlock( layer, output, size, step ) );
+			}
+			if( block != NotFound && layer->outputs[output] == 0 ) {
+				// The output is not connected and stays available after the run
+				blocks[block].End = INT_MAX;
+			}
+			outputBlocks.Add( block );
+		}
+	}
+
+	// Place the blocks starting from the largest ones, at the lowest offset
+	// that doesn't overlap the already placed blocks with intersecting lifetimes
+	CArray<int> sortedBlocks;
+	for( int i = 0; i < blocks.Size(); ++i ) {
+		sortedBlocks.Add( i );
+	}
+	std::stable_sort( sortedBlocks.GetPtr(), sortedBlocks.GetPtr() + sortedBlocks.Size(),
+		[&blocks]( int left, int right ) { return blocks[left].Size > blocks[right].Size; } );
+
+	long long arenaSize = 0;
+	CArray<int> placed; // the placed blocks sorted by offset
+	for( int i = 0; i < sortedBlocks.Size(); ++i ) {
+		CMemoryPlanBlock& block = blocks[sortedBlocks[i]];
+		long long offset = 0;
+		for( int j = 0; j < placed.Size(); ++j ) {
+			const CMemoryPlanBlock& other = blocks[placed[j]];
+			if( !block.Intersects( other ) ) {
+				continue;
+			}
+			if( offset + block.Size <= other.Offset ) {
+				break;
+			}
+			offset = max( offset, static_cast<long long>( other.Offset ) + other.Size );
+		}
+		if( offset + block.Size > INT_MAX ) {
+			// The arena would be too large for one blob; keep the usual allocation
+			return;
+		}
+		block.Offset = static_cast<int>( offset );
+		int insertPos = 0;
+		while( insertPos < placed.Size() && blocks[placed[insertPos]].Offset <= block.Offset ) {
+			++insertPos;
+		}
+		placed.InsertAt( sortedBlocks[i], insertPos );
+		arenaSize = max( arenaSize, offset + block.Size );
+	}
+	if( arenaSize == 0 ) {
+		return;
+	}
+
+	memoryPlanArena = CDnnBlob::CreateVector( mathEngine, CT_Float, static_cast<int>( arenaSize ) );
+	for( int i = 0; i < blocks.Size(); ++i ) {
+		CBaseLayer* layer = blocks[i].Layer;
+		layer->plannedOutputBlobs.SetSize( layer->GetOutputCount() );
+		layer->plannedOutputBlobs[blocks[i].Output] = FINE_DEBUG_NEW CDnnPlannedBlob( memoryPlanArena,
+			layer->outputDescs[blocks[i].Output], blocks[i].Offset );
+	}
+
+	// Release the blobs left from the previous runs so that the planned blobs are used
+	for( int i = 0; i < order.Size(); ++i ) {
+		CBaseLayer* layer = order[i];
+		for( int j = 0; j < layer->inputBlobs.Size(); ++j ) {
+			layer->inputBlobs[j] = 0;
+		}
+		for( int j = 0; j < layer->outputBlobs.Size(); ++j ) {
+			layer->outputBlobs[j] = 0;
+		}
+	}
+}
+
+// Releases the arena and all the references to the planned blobs
+void CDnn::clearMemoryPlan()
+{
+	if( memoryPlanArena == 0 ) {
+		return;
+	}
+	memoryPlanArena = 0;
+
+	for( int i = 0; i < layers.Size(); ++i ) {
+		CBaseLayer& layer = *layers[i];
+		for( int j = 0; j < layer.inputBlobs.Size(); ++j ) {
+			if( dynamic_cast<CDnnPlannedBlob*>( layer.inputBlobs[j].Ptr() ) != 0 ) {
+				layer.inputBlobs[j] = 0;
+			}
+		}
+		for( int j = 0; j < layer.outputBlobs.Size(); ++j ) {
+			if( dynamic_cast<CDnnPlannedBlob*>( layer.outputBlobs[j].Ptr() ) != 0 ) {
+				layer.outputBlobs[j] = 0;
+			}
+		}
+		layer.plannedOutputBlobs.DeleteAll();
+	}
+}
+
+} // namespace NeoML
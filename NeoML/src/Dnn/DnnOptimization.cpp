@@ -0,0 +1,195 @@
+/* Copyright © 2017-2021 ABBYY Production LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+--------------------------------------------------------------------------------------------------------------*/
+
+#include <common.h>
+#pragma hdrstop
+
+#include <NeoML/Dnn/DnnOptimization.h>
+#include <NeoML/Dnn/Dnn.h>
+#include <NeoML/Dnn/Layers/ActivationLayers.h>
+#include <NeoML/Dnn/Layers/BatchNormalizationLayer.h>
+#include <NeoML/Dnn/Layers/ConvLayer.h>
+#include <NeoML/Dnn/Layers/EltwiseLayer.h>
+#include <NeoML/Dnn/Layers/FullyConnectedLayer.h>
+
+namespace NeoML {
+
+// The layer input connected to the output of another layer
+struct CLayerInputLink {
+	CBaseLayer* Layer;
+	int InputNumber;
+};
+
+// Finds all the layer inputs connected to the outputs of the given layer
+static void getConsumers( CDnn& dnn, const char* layerName, CArray<CLayerInputLink>& consumers )
+{
+	consumers.DeleteAll();
+
+	CArray<const char*> layerList;
+	dnn.GetLayerList( layerList );
+	for( int i = 0; i < layerList.Size(); ++i ) {
+		CPtr<CBaseLayer> layer = dnn.GetLayer( layerList[i] );
+		for( int input = 0; input < layer->GetInputCount(); ++input ) {
+			if( strcmp( layer->GetInputName( input ), layerName ) == 0 ) {
+				CLayerInputLink link;
+				link.Layer = layer;
+				link.InputNumber = input;
+				consumers.Add( link );
+			}
+		}
+	}
+}
+
+// Gets the layer connected to the single input of the given layer
+// Returns null if the layer has several inputs or if the input layer has other consumers
+static CBaseLayer* getSingleUseProducer( CDnn& dnn, const CBaseLayer& layer )
+{
+	if( layer.GetInputCount() != 1 || !dnn.HasLayer( layer.GetInputName( 0 ) ) ) {
+		return nullptr;
+	}
+
+	CArray<CLayerInputLink> consumers;
+	getConsumers( dnn, layer.GetInputName( 0 ), consumers );
+	if( consumers.Size() != 1 ) {
+		return nullptr;
+	}
+	return dnn.GetLayer( layer.GetInputName( 0 ) );
+}
+
+// Deletes the layer with a single input from the network and connects its consumers to its input
+static void bypassLayer( CDnn& dnn, CBaseLayer& layer )
+{
+	const CString inputName = layer.GetInputName( 0 );
+	const int inputOutputNumber = layer.GetInputOutputNumber( 0 );
+
+	CArray<CLayerInputLink> consumers;
+	getConsumers( dnn, layer.GetName(), consumers );
+	for( int i = 0; i < consumers.Size(); ++i ) {
+		NeoAssert( consumers[i].Layer->GetInputOutputNumber( consumers[i].InputNumber ) == 0 );
+		consumers[i].Layer->Connect( consumers[i].InputNumber, inputName, inputOutputNumber );
+	}
+	dnn.DeleteLayer( layer );
+}
+
+// Folds the batch normalization into the previous layer weights
+static bool foldBatchNormalization( CDnn& dnn, CBatchNormalizationLayer& batchNorm )
+{
+	CBaseLayer* producer = getSingleUseProducer( dnn, batchNorm );
+	CPtr<CDnnBlob> params = batchNorm.GetFinalParams();
+	if( producer == nullptr || params == nullptr ) {
+		return false;
+	}
+
+	CConvLayer* conv = dynamic_cast<CConvLayer*>( producer );
+	CFullyConnectedLayer* fc = dynamic_cast<CFullyConnectedLayer*>( producer );
+	if( conv != nullptr ) {
+		// The free term is changed by the folding, so it can't be done after the activation
+		if( conv->IsQuantized() || !conv->GetFusedActivation().IsEmpty() || params->GetObjectSize() != conv->GetFilterCount()
+			|| conv->GetFilterData() == nullptr || conv->GetFreeTermData() == nullptr )
+		{
+			return false;
+		}
+		conv->ApplyBatchNormalization( batchNorm );
+		conv->SetZeroFreeTerm( false );
+	} else if( fc != nullptr ) {
+		if( fc->IsQuantized() || !fc->GetFusedActivation().IsEmpty() || params->GetObjectSize() != fc->GetNumberOfElements()
+			|| fc->GetWeightsData() == nullptr || fc->GetFreeTermData() == nullptr )
+		{
+			return false;
+		}
+		fc->ApplyBatchNormalization( batchNorm );
+		fc->SetZeroFreeTerm( false );
+	} else {
+		return false;
+	}
+
+	bypassLayer( dnn, batchNorm );
+	return true;
+}
+
+// Fuses the activation into the previous layer
+// Returns the fused layer or null if the activation can't be fused
+static CBaseLayer* fuseActivation( CDnn& dnn, CBaseLayer& activationLayer )
+{
+	CFusedActivation activation;
+	if( !CFusedActivation::FromLayer( activationLayer, activation ) ) {
+		return nullptr;
+	}
+	CBaseLayer* producer = getSingleUseProducer( dnn, activationLayer );
+	if( producer == nullptr ) {
+		return nullptr;
+	}
+
+	CConvLayer* conv = dynamic_cast<CConvLayer*>( producer );
+	CFullyConnectedLayer* fc = dynamic_cast<CFullyConnectedLayer*>( producer );
+	CEltwiseSumLayer* sum = dynamic_cast<CEltwiseSumLayer*>( producer );
+	if( conv != nullptr && conv->GetFusedActivation().IsEmpty() ) {
+		conv->SetFusedActivation( activation );
+	} else if( fc != nullptr && fc->GetFusedActivation().IsEmpty() ) {
+		fc->SetFusedActivation( activation );
+	} else if( sum != nullptr && sum->GetFusedActivation().IsEmpty() ) {
+		sum->SetFusedActivation( activation );
+	} else {
+		return nullptr;
+	}
+
+	bypassLayer( dnn, activationLayer );
+	return producer;
+}
+
+CDnnOptimizationReport OptimizeForInference( CDnn& dnn )
+{
+	CDnnOptimizationReport report;
+
+	// The names are copied because the list is changed when the layers are deleted
+	CArray<const char*> layerList;
+	dnn.GetLayerList( layerList );
+	CArray<CString> layerNames;
+	for( int i = 0; i < layerList.Size(); ++i ) {
+		layerNames.Add( layerList[i] );
+	}
+
+	// Batch normalization must be folded before the activations are fused
+	for( int i = 0; i < layerNames.Size(); ++i ) {
+		if( !dnn.HasLayer( layerNames[i] ) ) {
+			continue;
+		}
+		CPtr<CBaseLayer> layer = dnn.GetLayer( layerNames[i] );
+		CBatchNormalizationLayer* batchNorm = dynamic_cast<CBatchNormalizationLayer*>( layer.Ptr() );
+		if( batchNorm != nullptr && foldBatchNormalization( dnn, *batchNorm ) ) {
+			report.FoldedBatchNormalizations++;
+		}
+	}
+
+	for( int i = 0; i < layerNames.Size(); ++i ) {
+		if( !dnn.HasLayer( layerNames[i] ) ) {
+			continue;
+		}
+		CPtr<CBaseLayer> layer = dnn.GetLayer( layerNames[i] );
+		CBaseLayer* fusedLayer = fuseActivation( dnn, *layer );
+		if( fusedLayer == nullptr ) {
+			continue;
+		}
+		if( dynamic_cast<CEltwiseSumLayer*>( fusedLayer ) != nullptr ) {
+			report.FusedSumActivations++;
+		} else {
+			report.FusedActivations++;
+		}
+	}
+
+	return report;
+}
+
+} // namespace NeoML
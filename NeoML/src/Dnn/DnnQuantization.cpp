@@ -0,0 +1,234 @@
+/* Copyright © 2017-2021 ABBYY Production LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+--------------------------------------------------------------------------------------------------------------*/
+
+#include <common.h>
+#pragma hdrstop
+
+#include <NeoML/Dnn/DnnQuantization.h>
+#include <NeoML/Dnn/Dnn.h>
+#include <NeoML/Dnn/Layers/FullyConnectedLayer.h>
+#include <NeoML/Dnn/Layers/ConvLayer.h>
+#include <NeoML/Dnn/Layers/SinkLayer.h>
+
+namespace NeoML {
+
+CDnnInt8Weights::CDnnInt8Weights( IMathEngine& _mathEngine ) :
+	mathEngine( _mathEngine ),
+	inputScale( 0 ),
+	data( nullptr )
+{
+}
+
+CDnnInt8Weights::CDnnInt8Weights( const CDnnBlob& weights, float _inputScale ) :
+	mathEngine( weights.GetMathEngine() ),
+	desc( weights.GetDesc() ),
+	inputScale( _inputScale ),
+	data( nullptr )
+{
+	NeoAssert( weights.GetDataType() == CT_Float );
+	NeoAssert( inputScale >= 0 );
+
+	data = FINE_DEBUG_NEW CInt8HandleVar( mathEngine, desc.BlobSize() );
+	scales = CDnnBlob::CreateVector( mathEngine, CT_Float, desc.ObjectCount() );
+	mathEngine.QuantizeMatrixRowsInt8( weights.GetData(), desc.ObjectCount(), desc.ObjectSize(),
+		data->GetHandle(), scales->GetData() );
+}
+
+CDnnInt8Weights::~CDnnInt8Weights()
+{
+	delete data;
+}
+
+CPtr<CDnnBlob> CDnnInt8Weights::Dequantize() const
+{
+	NeoAssert( data != nullptr );
+
+	CArray<signed char> quantized;
+	quantized.SetSize( desc.BlobSize() );
+	mathEngine.DataExchangeTyped<signed char>( quantized.GetPtr(), data->GetHandle(), quantized.Size() );
+	CArray<float> objectScales;
+	objectScales.SetSize( desc.ObjectCount() );
+	scales->CopyTo( objectScales.GetPtr() );
+
+	CArray<float> result;
+	result.SetSize( desc.BlobSize() );
+	const int objectSize = desc.ObjectSize();
+	for( int i = 0; i < result.Size(); ++i ) {
+		result[i] = quantized[i] * objectScales[i / objectSize];
+	}
+
+	CPtr<CDnnBlob> weights = CDnnBlob::CreateBlob( mathEngine, CT_Float, desc );
+	weights->CopyFrom( result.GetPtr() );
+	return weights;
+}
+
+static const int DnnInt8WeightsVersion = 0;
+
+void CDnnInt8Weights::Serialize( CArchive& archive )
+{
+	archive.SerializeVersion( DnnInt8WeightsVersion );
+
+	if( archive.IsStoring() ) {
+		NeoAssert( data != nullptr );
+		for( TBlobDim d = TBlobDim( 0 ); d < BD_Count; ++d ) {
+			archive << desc.DimSize( d );
+		}
+		archive << inputScale;
+
+		void* ptr = mathEngine.GetBuffer( data->GetHandle(), 0, desc.BlobSize(), true );
+		archive.Write( ptr, desc.BlobSize() );
+		mathEngine.ReleaseBuffer( data->GetHandle(), ptr, false );
+	} else if( archive.IsLoading() ) {
+		desc = CBlobDesc( CT_Float );
+		for( TBlobDim d = TBlobDim( 0 ); d < BD_Count; ++d ) {
+			int size = 0;
+			archive >> size;
+			check( size > 0, ERR_BAD_ARCHIVE, archive.Name() );
+			desc.SetDimSize( d, size );
+		}
+		archive >> inputScale;
+		check( inputScale >= 0, ERR_BAD_ARCHIVE, archive.Name() );
+
+		delete data;
+		data = FINE_DEBUG_NEW CInt8HandleVar( mathEngine, desc.BlobSize() );
+		void* ptr = mathEngine.GetBuffer( data->GetHandle(), 0, desc.BlobSize(), false );
+		archive.Read( ptr, desc.BlobSize() );
+		mathEngine.ReleaseBuffer( data->GetHandle(), ptr, true );
+	} else {
+		NeoAssert( false );
+	}
+
+	SerializeBlob( mathEngine, archive, scales );
+	check( scales != nullptr && scales->GetDataSize() == desc.ObjectCount(), ERR_BAD_ARCHIVE, archive.Name() );
+}
+
+void SerializeInt8Weights( IMathEngine& mathEngine, CArchive& archive, CPtr<CDnnInt8Weights>& weights )
+{
+	if( archive.IsStoring() ) {
+		bool isNull = ( weights == nullptr );
+		archive << isNull;
+		if( !isNull ) {
+			weights->Serialize( archive );
+		}
+	} else if( archive.IsLoading() ) {
+		bool isNull = false;
+		archive >> isNull;
+		if( isNull ) {
+			weights = nullptr;
+		} else {
+			weights = FINE_DEBUG_NEW CDnnInt8Weights( mathEngine );
+			weights->Serialize( archive );
+		}
+	} else {
+		NeoAssert( false );
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// The prefix of the names of the sinks that are temporarily added during calibration
+static const char* const CalibrationSinkPrefix = "Int8CalibrationSink.";
+
+CDnnInt8Quantizer::CDnnInt8Quantizer( CDnn& _dnn ) :
+	dnn( _dnn ),
+	calibrationBatchCount( 0 )
+{
+}
+
+void CDnnInt8Quantizer::Calibrate()
+{
+	CArray<CString> layerNames;
+	getLayersToQuantize( layerNames );
+	if( layerNames.IsEmpty() ) {
+		return;
+	}
+
+	// Connect a sink to the input of every layer to be quantized
+	CObjectArray<CSinkLayer> sinks;
+	for( int i = 0; i < layerNames.Size(); ++i ) {
+		CPtr<CBaseLayer> layer = dnn.GetLayer( layerNames[i] );
+		for( int input = 0; input < layer->GetInputCount(); ++input ) {
+			CPtr<CSinkLayer> sink = new CSinkLayer( dnn.GetMathEngine() );
+			sink->SetName( CalibrationSinkPrefix + layerNames[i] + "." + Str( input ) );
+			sink->Connect( 0, layer->GetInputName( input ), layer->GetInputOutputNumber( input ) );
+			dnn.AddLayer( *sink );
+			sinks.Add( sink );
+		}
+	}
+
+	dnn.RunOnce();
+
+	int sinkIndex = 0;
+	CArray<float> buffer;
+	for( int i = 0; i < layerNames.Size(); ++i ) {
+		const int inputCount = dnn.GetLayer( layerNames[i] )->GetInputCount();
+		float& range = inputRanges.GetOrCreateValue( layerNames[i], 0.f );
+		for( int input = 0; input < inputCount; ++input ) {
+			const CPtr<CDnnBlob>& blob = sinks[sinkIndex++]->GetBlob();
+			buffer.SetSize( blob->GetDataSize() );
+			blob->CopyTo( buffer.GetPtr() );
+			for( int j = 0; j < buffer.Size(); ++j ) {
+				range = max( range, fabsf( buffer[j] ) );
+			}
+		}
+	}
+
+	for( int i = 0; i < sinks.Size(); ++i ) {
+		dnn.DeleteLayer( *sinks[i] );
+	}
+	calibrationBatchCount++;
+}
+
+int CDnnInt8Quantizer::Quantize()
+{
+	CArray<CString> layerNames;
+	getLayersToQuantize( layerNames );
+
+	for( int i = 0; i < layerNames.Size(); ++i ) {
+		float range = 0;
+		inputRanges.Lookup( layerNames[i], range );
+		const float inputScale = range > 0 ? range / 127.f : 0.f;
+
+		CPtr<CBaseLayer> layer = dnn.GetLayer( layerNames[i] );
+		CFullyConnectedLayer* fc = dynamic_cast<CFullyConnectedLayer*>( layer.Ptr() );
+		if( fc != nullptr ) {
+			fc->QuantizeWeights( inputScale );
+		} else {
+			CheckCast<CConvLayer>( layer )->QuantizeWeights( inputScale );
+		}
+	}
+	return layerNames.Size();
+}
+
+// Gets the names of the layers that may be quantized (with initialized float weights)
+void CDnnInt8Quantizer::getLayersToQuantize( CArray<CString>& layerNames ) const
+{
+	layerNames.DeleteAll();
+
+	CArray<const char*> allLayers;
+	dnn.GetLayerList( allLayers );
+	for( int i = 0; i < allLayers.Size(); ++i ) {
+		CPtr<CBaseLayer> layer = dnn.GetLayer( allLayers[i] );
+		const CFullyConnectedLayer* fc = dynamic_cast<const CFullyConnectedLayer*>( layer.Ptr() );
+		const CConvLayer* conv = dynamic_cast<const CConvLayer*>( layer.Ptr() );
+		if( ( fc != nullptr && !fc->IsQuantized() && fc->GetWeightsData() != nullptr )
+			|| ( conv != nullptr && !conv->IsQuantized() && conv->GetFilterData() != nullptr ) )
+		{
+			layerNames.Add( allLayers[i] );
+		}
+	}
+}
+
+} // namespace NeoML
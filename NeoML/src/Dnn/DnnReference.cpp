@@ -0,0 +1,145 @@
+/* Copyright © 2017-2021 ABBYY Production LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+--------------------------------------------------------------------------------------------------------------*/
+
+#include <common.h>
+#pragma hdrstop
+
+#include <NeoML/Dnn/Dnn.h>
+
+namespace NeoML {
+
+// The file in memory used to copy the network architecture
+class CDnnMemoryFile : public CBaseFile {
+public:
+	CDnnMemoryFile() : pos( 0 ) {}
+
+	// CBaseFile class methods
+#ifdef FINEOBJ_VERSION
+	CUnicodeString GetFileName() const override { return CUnicodeString( L"Memory" ); }
+#else
+	const char* GetFileName() const override { return "Memory"; }
+#endif
+	int Read( void* result, int bytesCount ) override;
+	void Write( const void* data, int bytesCount ) override;
+	__int64 GetPosition() const override { return pos; }
+	__int64 Seek( __int64 offset, TSeekPosition from ) override;
+	void SetLength( __int64 newLength ) override { buffer.SetSize( static_cast<int>( newLength ) ); }
+	__int64 GetLength() const override { return buffer.Size(); }
+	void Abort() override {}
+	void Flush() override {}
+	void Close() override {}
+
+private:
+	CArray<char> buffer;
+	int pos;
+};
+
+int CDnnMemoryFile::Read( void* result, int bytesCount )
+{
+	const int len = min( bytesCount, buffer.Size() - pos );
+	if( len <= 0 ) {
+		return 0;
+	}
+	::memcpy( result, buffer.GetPtr() + pos, len );
+	pos += len;
+	return len;
+}
+
+void CDnnMemoryFile::Write( const void* data, int bytesCount )
+{
+	if( pos + bytesCount > buffer.Size() ) {
+		buffer.SetSize( pos + bytesCount );
+	}
+	::memcpy( buffer.GetPtr() + pos, data, bytesCount );
+	pos += bytesCount;
+}
+
+__int64 CDnnMemoryFile::Seek( __int64 offset, TSeekPosition from )
+{
+	switch( from ) {
+		case begin:
+			pos = static_cast<int>( offset );
+			break;
+		case current:
+			pos += static_cast<int>( offset );
+			break;
+		case end:
+			pos = buffer.Size() + static_cast<int>( offset );
+			break;
+		default:
+			NeoAssert( false );
+	}
+	NeoAssert( 0 <= pos && pos <= buffer.Size() );
+	return pos;
+}
+
+//------------------------------------------------------------------------------------------------------------
+
+CPtr<CDnnReference> CDnn::CreateReference()
+{
+	CPtr<CDnnReference> reference = FINE_DEBUG_NEW CDnnReference( mathEngine );
+
+	// The architecture is copied via serialization without the parameters, which are shared afterwards
+	// So the memory file holds only the layer settings and no weights are copied
+	CDnnMemoryFile file;
+	{
+		CObjectArray<IObject> params;
+		int position = 0;
+		detachParams( params );
+		try {
+			CArchive archive( &file, CArchive::SD_Storing );
+			Serialize( archive );
+		} catch( ... ) {
+			attachParams( params, position );
+			throw;
+		}
+		attachParams( params, position );
+		NeoAssert( position == params.Size() );
+	}
+	file.SeekToBegin();
+	{
+		CArchive archive( &file, CArchive::SD_Loading );
+		reference->dnn.Serialize( archive );
+	}
+
+	reference->dnn.shareParams( *this );
+	reference->dnn.DisableLearning();
+	return reference;
+}
+
+void CDnn::shareParams( const CDnn& source )
+{
+	NeoAssert( &source.mathEngine == &mathEngine );
+	for( int i = 0; i < layers.Size(); ++i ) {
+		CPtr<const CBaseLayer> sourceLayer = source.GetLayer( layers[i]->GetName() );
+		layers[i]->ShareParams( *sourceLayer );
+	}
+}
+
+void CDnn::detachParams( CObjectArray<IObject>& storage )
+{
+	for( int i = 0; i < layers.Size(); ++i ) {
+		layers[i]->DetachParams( storage );
+	}
+}
+
+void CDnn::attachParams( const CObjectArray<IObject>& storage, int& position )
+{
+	for( int i = 0; i < layers.Size(); ++i ) {
+		layers[i]->AttachParams( storage, position );
+	}
+}
+
+} // namespace NeoML
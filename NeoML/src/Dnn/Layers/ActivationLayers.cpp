@@ -57,6 +57,80 @@ CPtr<CBaseLayer> CreateActivationLayer( IMathEngine& mathEngine, TActivationFunc
 	return 0;
 }
 
+bool CFusedActivation::FromLayer( const CBaseLayer& layer, CFusedActivation& result )
+{
+	result = CFusedActivation();
+	if( dynamic_cast<const CReLULayer*>( &layer ) != nullptr ) {
+		result.Type = AF_ReLU;
+		result.Param = static_cast<const CReLULayer&>( layer ).GetUpperThreshold();
+	} else if( dynamic_cast<const CLeakyReLULayer*>( &layer ) != nullptr ) {
+		result.Type = AF_LeakyReLU;
+		result.Param = static_cast<const CLeakyReLULayer&>( layer ).GetAlpha();
+	} else if( dynamic_cast<const CELULayer*>( &layer ) != nullptr ) {
+		result.Type = AF_ELU;
+		result.Param = static_cast<const CELULayer&>( layer ).GetAlpha();
+	} else if( dynamic_cast<const CAbsLayer*>( &layer ) != nullptr ) {
+		result.Type = AF_Abs;
+	} else if( dynamic_cast<const CSigmoidLayer*>( &layer ) != nullptr ) {
+		result.Type = AF_Sigmoid;
+	} else if( dynamic_cast<const CTanhLayer*>( &layer ) != nullptr ) {
+		result.Type = AF_Tanh;
+	} else if( dynamic_cast<const CHardTanhLayer*>( &layer ) != nullptr ) {
+		result.Type = AF_HardTanh;
+	} else if( dynamic_cast<const CHSwishLayer*>( &layer ) != nullptr ) {
+		result.Type = AF_HSwish;
+	}
+	return !result.IsEmpty();
+}
+
+void CFusedActivation::Apply( IMathEngine& mathEngine, const CFloatHandle& data, int dataSize ) const
+{
+	CFloatHandleStackVar param( mathEngine );
+	param.SetValue( Param );
+	Apply( mathEngine, data, dataSize, param );
+}
+
+void CFusedActivation::Apply( IMathEngine& mathEngine, const CFloatHandle& data, int dataSize,
+	const CConstFloatHandle& param ) const
+{
+	switch( Type ) {
+		case AF_Linear:
+			break;
+		case AF_ReLU:
+			mathEngine.VectorReLU( data, data, dataSize, param );
+			break;
+		case AF_LeakyReLU:
+			mathEngine.VectorLeakyReLU( data, data, dataSize, param );
+			break;
+		case AF_ELU:
+			mathEngine.VectorELU( data, data, dataSize, param );
+			break;
+		case AF_Abs:
+			mathEngine.VectorAbs( data, data, dataSize );
+			break;
+		case AF_Sigmoid:
+			mathEngine.VectorSigmoid( data, data, dataSize );
+			break;
+		case AF_Tanh:
+			mathEngine.VectorTanh( data, data, dataSize );
+			break;
+		case AF_HardTanh:
+			mathEngine.VectorHardTanh( data, data, dataSize );
+			break;
+		case AF_HSwish:
+			mathEngine.VectorHSwish( data, data, dataSize );
+			break;
+		default:
+			NeoAssert( false );
+	}
+}
+
+void CFusedActivation::Serialize( CArchive& archive )
+{
+	archive.SerializeEnum( Type );
+	archive.Serialize( Param );
+}
+
 ///////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////
 CLinearLayer::CLinearLayer( IMathEngine& mathEngine ) :
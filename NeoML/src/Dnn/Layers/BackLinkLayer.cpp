@@ -120,6 +120,25 @@ void CBackLinkLayer::SetState(const CPtr<CDnnBlob>& state)
 	captureSink->SetBlob(state);
 }
 
+CConstFloatHandle CBackLinkLayer::GetInitialState( const CDnnBlob* initialState )
+{
+	// The same as RunOnce on the first step of the sequence
+	if( GetDnn()->IsReverseSequense() ) {
+		RestartSequence();
+	}
+	if( initialState != nullptr && isProcessingFirstPosition ) {
+		return initialState->GetData();
+	}
+	return captureSink->GetBlob()->GetData();
+}
+
+void CBackLinkLayer::CompleteSequence( const CConstFloatHandle& lastState )
+{
+	const CPtr<CDnnBlob>& state = captureSink->GetBlob();
+	MathEngine().VectorCopy( state->GetData(), lastState, state->GetDataSize() );
+	isProcessingFirstPosition = false;
+}
+
 static const int BackLinkLayerVersion = 2000;
 
 void CBackLinkLayer::Serialize( CArchive& archive )
@@ -446,6 +446,32 @@ void CBatchNormalizationLayer::LearnOnce()
 	isFinalParamDirty = true;
 }
 
+void CBatchNormalizationLayer::ShareParams( const CBaseLayer& source )
+{
+	CBaseLayer::ShareParams( source );
+	const CBatchNormalizationLayer* batchNorm = CheckCast<const CBatchNormalizationLayer>( &source );
+	finalParams = batchNorm->finalParams;
+	internalParams = batchNorm->internalParams;
+}
+
+void CBatchNormalizationLayer::DetachParams( CObjectArray<IObject>& storage )
+{
+	// Serialize calculates the final parameters if they are out of date
+	updateFinalParams();
+	CBaseLayer::DetachParams( storage );
+	storage.Add( finalParams.Ptr() );
+	storage.Add( internalParams.Ptr() );
+	finalParams = nullptr;
+	internalParams = nullptr;
+}
+
+void CBatchNormalizationLayer::AttachParams( const CObjectArray<IObject>& storage, int& position )
+{
+	CBaseLayer::AttachParams( storage, position );
+	finalParams = static_cast<CDnnBlob*>( storage[position++].Ptr() );
+	internalParams = static_cast<CDnnBlob*>( storage[position++].Ptr() );
+}
+
 void CBatchNormalizationLayer::SetFinalParams(const CPtr<CDnnBlob>& _params)
 {
 	if(finalParams != 0) {
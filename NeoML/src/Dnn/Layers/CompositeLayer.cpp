@@ -398,6 +398,31 @@ void CCompositeLayer::FilterLayerParams( float threshold )
 	}
 }
 
+void CCompositeLayer::ShareParams( const CBaseLayer& source )
+{
+	CBaseLayer::ShareParams( source );
+	const CCompositeLayer* composite = CheckCast<const CCompositeLayer>( &source );
+	if( internalDnn != 0 && composite->internalDnn != 0 ) {
+		internalDnn->shareParams( *composite->internalDnn );
+	}
+}
+
+void CCompositeLayer::DetachParams( CObjectArray<IObject>& storage )
+{
+	CBaseLayer::DetachParams( storage );
+	if( internalDnn != 0 ) {
+		internalDnn->detachParams( storage );
+	}
+}
+
+void CCompositeLayer::AttachParams( const CObjectArray<IObject>& storage, int& position )
+{
+	CBaseLayer::AttachParams( storage, position );
+	if( internalDnn != 0 ) {
+		internalDnn->attachParams( storage, position );
+	}
+}
+
 void CCompositeLayer::SetInternalDnnParams()
 {
 	NeoAssert(internalDnn != 0);
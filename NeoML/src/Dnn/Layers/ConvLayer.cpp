@@ -37,7 +37,7 @@ void CConvLayer::initConvDesc()
 	if( convDesc == 0 ) {
 		convDesc = MathEngine().InitBlobConvolution( inputBlobs[0]->GetDesc(),
 			paddingHeight, paddingWidth, strideHeight, strideWidth, dilationHeight, dilationWidth,
-			Filter()->GetDesc(), outputBlobs[0]->GetDesc() );
+			IsQuantized() ? int8Filter->GetDesc() : Filter()->GetDesc(), outputBlobs[0]->GetDesc() );
 	}
 }
 void CConvLayer::destroyConvDesc()
@@ -67,6 +67,14 @@ void CConvLayer::Reshape()
 	CheckArchitecture( paddingHeight < filterHeight * dilationHeight && paddingWidth < filterWidth * dilationWidth,
 		GetName(), "padding is more or equal to receptive field size" );
 
+	if( IsQuantized() ) {
+		CheckArchitecture( MathEngine().GetType() == MET_Cpu,
+			GetName(), "int8 convolution is supported only on CPU" );
+		CheckArchitecture( !IsBackwardPerformed(), GetName(), "int8 convolution supports only inference" );
+	}
+	CheckArchitecture( fusedActivation.IsEmpty() || !IsBackwardPerformed(),
+		GetName(), "convolution with fused activation supports only inference" );
+
 	int outputHeight, outputWidth;
 	calcOutputBlobSize(outputHeight, outputWidth);
 	for(int i = 0; i < GetInputCount(); i++) {
@@ -74,7 +82,14 @@ void CConvLayer::Reshape()
 			&& filterWidth <= inputDescs[i].Width() + 2 * paddingWidth,
 			GetName(), "filter is bigger than input" );
 
-		if(Filter() == 0) {
+		if( IsQuantized() ) {
+			const CBlobDesc& filterDesc = int8Filter->GetDesc();
+			NeoAssert(filterDesc.ObjectCount() == filterCount);
+			NeoAssert(filterDesc.Height() == filterHeight);
+			NeoAssert(filterDesc.Width() == filterWidth);
+			NeoAssert(filterDesc.Depth() == inputDescs[i].Depth());
+			NeoAssert(filterDesc.Channels() == inputDescs[i].Channels());
+		} else if(Filter() == 0) {
 			// Create a weights matrix
 			Filter() = CDnnBlob::Create3DImageBlob( MathEngine(), CT_Float, 1, filterCount, filterHeight, filterWidth,
 				inputDescs[i].Depth(), inputDescs[i].Channels() );
@@ -114,8 +129,14 @@ void CConvLayer::RunOnce()
 
 	for( int i = 0; i < outputBlobs.Size(); ++i ) {
 		CFloatHandle freeTerm = FreeTerms()->GetData();
-		MathEngine().BlobConvolution( *convDesc, inputBlobs[i]->GetData(),
-			Filter()->GetData(), &freeTerm, outputBlobs[i]->GetData() );
+		if( IsQuantized() ) {
+			MathEngine().BlobConvolutionInt8( *convDesc, inputBlobs[i]->GetData(), int8Filter->GetInputScale(),
+				int8Filter->GetData(), int8Filter->GetScales(), &freeTerm, outputBlobs[i]->GetData() );
+		} else {
+			MathEngine().BlobConvolution( *convDesc, inputBlobs[i]->GetData(),
+				Filter()->GetData(), &freeTerm, outputBlobs[i]->GetData() );
+		}
+		fusedActivation.Apply( MathEngine(), outputBlobs[i]->GetData(), outputBlobs[i]->GetDataSize() );
 	}
 }
 
@@ -140,12 +161,73 @@ void CConvLayer::LearnOnce()
 	}
 }
 
-static const int ConvLayerVersion = 2000;
+void CConvLayer::ShareParams( const CBaseLayer& source )
+{
+	CBaseLayer::ShareParams( source );
+	int8Filter = CheckCast<const CConvLayer>( &source )->int8Filter;
+}
+
+void CConvLayer::DetachParams( CObjectArray<IObject>& storage )
+{
+	CBaseLayer::DetachParams( storage );
+	storage.Add( int8Filter.Ptr() );
+	int8Filter = nullptr;
+}
+
+void CConvLayer::AttachParams( const CObjectArray<IObject>& storage, int& position )
+{
+	CBaseLayer::AttachParams( storage, position );
+	int8Filter = static_cast<CDnnInt8Weights*>( storage[position++].Ptr() );
+}
+
+CPtr<CDnnBlob> CConvLayer::GetFilterData() const
+{
+	if( IsQuantized() ) {
+		return int8Filter->Dequantize();
+	}
+	return CBaseConvLayer::GetFilterData();
+}
+
+void CConvLayer::SetFilterData( const CPtr<CDnnBlob>& newFilter )
+{
+	NeoAssert( !IsQuantized() );
+	CBaseConvLayer::SetFilterData( newFilter );
+}
+
+void CConvLayer::SetFusedActivation( const CFusedActivation& activation )
+{
+	fusedActivation = activation;
+	ForceReshape();
+}
+
+void CConvLayer::QuantizeWeights( float inputScale )
+{
+	NeoAssert( !IsQuantized() );
+	NeoAssert( Filter() != 0 );
+
+	int8Filter = FINE_DEBUG_NEW CDnnInt8Weights( *Filter(), inputScale );
+	Filter() = 0;
+	DisableLearning();
+	ForceReshape();
+}
+
+static const int ConvLayerVersion = 2002;
 
 void CConvLayer::Serialize( CArchive& archive )
 {
-	archive.SerializeVersion( ConvLayerVersion, CDnn::ArchiveMinSupportedVersion );
+	const int version = archive.SerializeVersion( ConvLayerVersion, CDnn::ArchiveMinSupportedVersion );
 	CBaseConvLayer::Serialize( archive );
+
+	if( version >= 2001 ) {
+		SerializeInt8Weights( MathEngine(), archive, int8Filter );
+	} else {
+		int8Filter = nullptr;
+	}
+	if( version >= 2002 ) {
+		fusedActivation.Serialize( archive );
+	} else {
+		fusedActivation = CFusedActivation();
+	}
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////
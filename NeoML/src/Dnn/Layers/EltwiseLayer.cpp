@@ -46,14 +46,34 @@ void CEltwiseBaseLayer::Serialize( CArchive& archive )
 ///////////////////////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void CEltwiseSumLayer::RunOnce()
+// The number of elements processed at once by the sum with the fused activation on CPU
+// The part of the sum must stay in cache while the activation is applied
+static const int EltwiseSumActivationChunkSize = 32 * 1024;
+
+void CEltwiseSumLayer::Reshape()
 {
-	CFloatHandle output = outputBlobs[0]->GetData();
-	int dataSize = outputBlobs[0]->GetDataSize();
+	CEltwiseBaseLayer::Reshape();
+	CheckArchitecture( fusedActivation.IsEmpty() || !IsBackwardPerformed(),
+		GetName(), "eltwise sum with fused activation supports only inference" );
+}
 
-	MathEngine().VectorAdd( inputBlobs[0]->GetData(), inputBlobs[1]->GetData(), output, dataSize );
-	for( int i = 2; i < inputBlobs.Size(); ++i ) {
-		MathEngine().VectorAdd( output, inputBlobs[i]->GetData(), output, dataSize );
+void CEltwiseSumLayer::RunOnce()
+{
+	const int dataSize = outputBlobs[0]->GetDataSize();
+	const int chunkSize = fusedActivation.IsEmpty() || MathEngine().GetType() != MET_Cpu
+		? dataSize : EltwiseSumActivationChunkSize;
+	CFloatHandleStackVar activationParam( MathEngine() );
+	activationParam.SetValue( fusedActivation.Param );
+
+	for( int start = 0; start < dataSize; start += chunkSize ) {
+		const int size = min( chunkSize, dataSize - start );
+		CFloatHandle output = outputBlobs[0]->GetData() + start;
+
+		MathEngine().VectorAdd( inputBlobs[0]->GetData() + start, inputBlobs[1]->GetData() + start, output, size );
+		for( int i = 2; i < inputBlobs.Size(); ++i ) {
+			MathEngine().VectorAdd( output, inputBlobs[i]->GetData() + start, output, size );
+		}
+		fusedActivation.Apply( MathEngine(), output, size, activationParam );
 	}
 }
 
@@ -65,12 +85,24 @@ void CEltwiseSumLayer::BackwardOnce()
 	}
 }
 
-static const int EltwiseSumLayerVersion = 2000;
+void CEltwiseSumLayer::SetFusedActivation( const CFusedActivation& activation )
+{
+	fusedActivation = activation;
+	ForceReshape();
+}
+
+static const int EltwiseSumLayerVersion = 2001;
 
 void CEltwiseSumLayer::Serialize( CArchive& archive )
 {
-	archive.SerializeVersion( EltwiseSumLayerVersion, CDnn::ArchiveMinSupportedVersion );
+	const int version = archive.SerializeVersion( EltwiseSumLayerVersion, CDnn::ArchiveMinSupportedVersion );
 	CEltwiseBaseLayer::Serialize( archive );
+
+	if( version >= 2001 ) {
+		fusedActivation.Serialize( archive );
+	} else {
+		fusedActivation = CFusedActivation();
+	}
 }
 
 CLayerWrapper<CEltwiseSumLayer> Sum()
@@ -38,8 +38,20 @@ void CFullyConnectedLayer::Reshape()
 	CheckInputs();
 	CheckArchitecture( GetInputCount() == GetOutputCount(),
 		GetName(), "fully connected layer with different numbers of input and output" );
+	if( IsQuantized() ) {
+		CheckArchitecture( MathEngine().GetType() == MET_Cpu,
+			GetName(), "int8 fully connected layer is supported only on CPU" );
+		CheckArchitecture( !IsBackwardPerformed(), GetName(), "int8 fully connected layer supports only inference" );
+	}
+	CheckArchitecture( fusedActivation.IsEmpty() || !IsBackwardPerformed(),
+		GetName(), "fully connected layer with fused activation supports only inference" );
 	for(int i = 0; i < GetInputCount(); i++) {
-		if(Weights() == 0) {
+		if( IsQuantized() ) {
+			CheckArchitecture( int8Weights->GetDesc().ObjectCount() == numberOfElements,
+				GetName(), "weights number is not equal to number of elements" );
+			CheckArchitecture( int8Weights->GetDesc().ObjectSize() == inputDescs[i].ObjectSize(),
+				GetName(), "weights size mismatch" );
+		} else if(Weights() == 0) {
 			// Create a weights matrix
 			CBlobDesc weightsDesc = inputDescs[i];
 			weightsDesc.SetDimSize(BD_BatchLength, 1);
@@ -78,17 +90,24 @@ void CFullyConnectedLayer::RunOnce()
 	for( int i = 0; i < GetInputCount(); i++ ) {
 		CConstFloatHandle inputData = inputBlobs[i]->GetData();
 		CFloatHandle outputData = outputBlobs[i]->GetData();
-		CConstFloatHandle weightData = Weights()->GetData();
 
-		MathEngine().MultiplyMatrixByTransposedMatrix(inputData, inputBlobs[i]->GetObjectCount(),
-			inputBlobs[i]->GetObjectSize(), inputBlobs[i]->GetObjectSize(),
-			weightData, numberOfElements, Weights()->GetObjectSize(),
-			outputData, outputBlobs[i]->GetObjectSize(), outputBlobs[i]->GetObjectSize() * inputBlobs[i]->GetObjectCount());
+		if( IsQuantized() ) {
+			MathEngine().MultiplyMatrixByTransposedInt8Matrix( inputData, inputBlobs[i]->GetObjectCount(),
+				inputBlobs[i]->GetObjectSize(), int8Weights->GetInputScale(), int8Weights->GetData(),
+				int8Weights->GetScales(), numberOfElements, outputData );
+		} else {
+			CConstFloatHandle weightData = Weights()->GetData();
+			MathEngine().MultiplyMatrixByTransposedMatrix(inputData, inputBlobs[i]->GetObjectCount(),
+				inputBlobs[i]->GetObjectSize(), inputBlobs[i]->GetObjectSize(),
+				weightData, numberOfElements, Weights()->GetObjectSize(),
+				outputData, outputBlobs[i]->GetObjectSize(), outputBlobs[i]->GetObjectSize() * inputBlobs[i]->GetObjectCount());
+		}
 
 		if( !isZeroFreeTerm ) {
 			MathEngine().AddVectorToMatrixRows(1, outputData, outputData, inputBlobs[i]->GetObjectCount(),
 				outputBlobs[i]->GetObjectSize(), FreeTerms()->GetData());
 		}
+		fusedActivation.Apply( MathEngine(), outputData, outputBlobs[i]->GetDataSize() );
 	}
 }
 
@@ -126,6 +145,25 @@ void CFullyConnectedLayer::FilterLayerParams( float threshold )
 	}
 }
 
+void CFullyConnectedLayer::ShareParams( const CBaseLayer& source )
+{
+	CBaseLayer::ShareParams( source );
+	int8Weights = CheckCast<const CFullyConnectedLayer>( &source )->int8Weights;
+}
+
+void CFullyConnectedLayer::DetachParams( CObjectArray<IObject>& storage )
+{
+	CBaseLayer::DetachParams( storage );
+	storage.Add( int8Weights.Ptr() );
+	int8Weights = nullptr;
+}
+
+void CFullyConnectedLayer::AttachParams( const CObjectArray<IObject>& storage, int& position )
+{
+	CBaseLayer::AttachParams( storage, position );
+	int8Weights = static_cast<CDnnInt8Weights*>( storage[position++].Ptr() );
+}
+
 void CFullyConnectedLayer::SetNumberOfElements(int newNumberOfElements)
 {
 	NeoAssert( ( Weights() == 0 && FreeTerms() == 0 ) || numberOfElements == newNumberOfElements );
@@ -134,6 +172,9 @@ void CFullyConnectedLayer::SetNumberOfElements(int newNumberOfElements)
 
 CPtr<CDnnBlob> CFullyConnectedLayer::GetWeightsData() const
 {
+	if( IsQuantized() ) {
+		return int8Weights->Dequantize();
+	}
 	if(Weights() == 0) {
 		return 0;
 	}
@@ -143,6 +184,7 @@ CPtr<CDnnBlob> CFullyConnectedLayer::GetWeightsData() const
 
 void CFullyConnectedLayer::SetWeightsData(const CDnnBlob* newWeights)
 {
+	NeoAssert( !IsQuantized() );
 	if(newWeights == 0) {
 		NeoAssert(Weights() == 0 || GetDnn() == 0);
 		Weights() = 0;
@@ -195,6 +237,7 @@ void CFullyConnectedLayer::SetZeroFreeTerm(bool _isZeroFreeTerm)
 
 void CFullyConnectedLayer::ApplyBatchNormalization(CBatchNormalizationLayer& batchNorm)
 {
+	NeoAssert( !IsQuantized() );
 	CPtr<CDnnBlob> params = batchNorm.GetFinalParams();
 	if(params.Ptr() == 0 || Weights().Ptr() == 0) {
 		return;
@@ -214,16 +257,44 @@ void CFullyConnectedLayer::ApplyBatchNormalization(CBatchNormalizationLayer& bat
 	}
 }
 
-static const int FullyConnectedLayerVersion = 2000;
+void CFullyConnectedLayer::SetFusedActivation( const CFusedActivation& activation )
+{
+	fusedActivation = activation;
+	ForceReshape();
+}
+
+void CFullyConnectedLayer::QuantizeWeights( float inputScale )
+{
+	NeoAssert( !IsQuantized() );
+	NeoAssert( Weights() != 0 );
+
+	int8Weights = FINE_DEBUG_NEW CDnnInt8Weights( *Weights(), inputScale );
+	Weights() = 0;
+	DisableLearning();
+	ForceReshape();
+}
+
+static const int FullyConnectedLayerVersion = 2002;
 
 void CFullyConnectedLayer::Serialize( CArchive& archive )
 {
-	archive.SerializeVersion( FullyConnectedLayerVersion, CDnn::ArchiveMinSupportedVersion );
+	const int version = archive.SerializeVersion( FullyConnectedLayerVersion, CDnn::ArchiveMinSupportedVersion );
 	CBaseLayer::Serialize( archive );
 
 	archive.Serialize( numberOfElements );
 	archive.Serialize( isZeroFreeTerm );
 
+	if( version >= 2001 ) {
+		SerializeInt8Weights( MathEngine(), archive, int8Weights );
+	} else {
+		int8Weights = nullptr;
+	}
+	if( version >= 2002 ) {
+		fusedActivation.Serialize( archive );
+	} else {
+		fusedActivation = CFusedActivation();
+	}
+
 	if( archive.IsLoading() ) {
 		// Converts the free terms blob into a new tensor with the length in the first dimension not Channels
 		CDnnBlob* freeTerms = FreeTerms();
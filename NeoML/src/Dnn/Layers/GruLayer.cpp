@@ -127,6 +127,110 @@ void CGruLayer::SetHiddenSize(int size)
 	mainBackLink->SetDimSize(BD_Channels, size);
 }
 
+void CGruLayer::RunOnce()
+{
+	if( canProcessWholeSequence() ) {
+		processWholeSequence();
+	} else {
+		// The weights may be learned after this pass
+		clearSplitWeights();
+		CRecurrentLayer::RunOnce();
+	}
+}
+
+// Checks if the sequence may be processed by IMathEngine::GruRecurrent
+bool CGruLayer::canProcessWholeSequence() const
+{
+	return CanProcessWholeSequence()
+		&& !mainLayer->IsQuantized() && mainLayer->GetFusedActivation().IsEmpty()
+		&& !gateLayer->IsQuantized() && gateLayer->GetFusedActivation().IsEmpty();
+}
+
+// Splits the weights of the fully connected layer over the [x, h] concatenation
+// into the input and the recurrent parts
+static void splitGruWeights( IMathEngine& mathEngine, CDnnBlob& weights, int inputSize,
+	CPtr<CDnnBlob>& inputWeights, CPtr<CDnnBlob>& recurWeights )
+{
+	CBlobDesc weightsDesc( CT_Float );
+	weightsDesc.SetDimSize( BD_BatchWidth, weights.GetObjectCount() );
+	weightsDesc.SetDimSize( BD_Channels, weights.GetObjectSize() );
+
+	CBlobDesc splitDesc[2] = { weightsDesc, weightsDesc };
+	splitDesc[0].SetDimSize( BD_Channels, inputSize );
+	splitDesc[1].SetDimSize( BD_Channels, weights.GetObjectSize() - inputSize );
+	if( inputWeights == nullptr || !inputWeights->GetDesc().HasEqualDimensions( splitDesc[0] ) ) {
+		inputWeights = CDnnBlob::CreateBlob( mathEngine, splitDesc[0] );
+	}
+	if( recurWeights == nullptr || !recurWeights->GetDesc().HasEqualDimensions( splitDesc[1] ) ) {
+		recurWeights = CDnnBlob::CreateBlob( mathEngine, splitDesc[1] );
+	}
+	CFloatHandle splitData[2] = { inputWeights->GetData(), recurWeights->GetData() };
+
+	mathEngine.BlobSplitByDim( BD_Channels, weightsDesc, weights.GetData(), splitDesc, splitData, 2 );
+}
+
+// Splits the weights if they have changed since the last call
+void CGruLayer::updateSplitWeights( int inputSize )
+{
+	CDnnBlob* gateWeights = gateLayer->Weights();
+	if( splitGateWeights != gateWeights || gateInputWeights->GetObjectSize() != inputSize ) {
+		splitGruWeights( MathEngine(), *gateWeights, inputSize, gateInputWeights, gateRecurWeights );
+		splitGateWeights = gateWeights;
+	}
+	CDnnBlob* mainWeights = mainLayer->Weights();
+	if( splitMainWeights != mainWeights || mainInputWeights->GetObjectSize() != inputSize ) {
+		splitGruWeights( MathEngine(), *mainWeights, inputSize, mainInputWeights, mainRecurWeights );
+		splitMainWeights = mainWeights;
+	}
+}
+
+// The weights will be split again on the next call of processWholeSequence
+// The split blobs are kept to avoid the allocation
+void CGruLayer::clearSplitWeights()
+{
+	splitGateWeights = nullptr;
+	splitMainWeights = nullptr;
+}
+
+// Processes the whole sequence at once
+// The input projections are calculated for all the steps by single matrix multiplications,
+// the recurrent part is calculated by the math engine without running the internal network
+void CGruLayer::processWholeSequence()
+{
+	const int sequenceLength = inputBlobs[0]->GetBatchLength();
+	const int batchSize = inputBlobs[0]->GetBatchWidth();
+	const int objectCount = sequenceLength * batchSize;
+	const int inputSize = inputBlobs[0]->GetObjectSize();
+	const int hiddenSize = GetHiddenSize();
+	const int gateSize = G_Count * hiddenSize;
+
+	updateSplitWeights( inputSize );
+
+	CFloatHandleStackVar inputGates( MathEngine(), objectCount * gateSize );
+	MathEngine().MultiplyMatrixByTransposedMatrix( inputBlobs[0]->GetData(), objectCount, inputSize, inputSize,
+		gateInputWeights->GetData(), gateSize, inputSize, inputGates, gateSize, objectCount * gateSize );
+	if( !gateLayer->IsZeroFreeTerm() ) {
+		MathEngine().AddVectorToMatrixRows( 1, inputGates, inputGates, objectCount, gateSize,
+			gateLayer->FreeTerms()->GetData() );
+	}
+
+	CFloatHandleStackVar inputMain( MathEngine(), objectCount * hiddenSize );
+	MathEngine().MultiplyMatrixByTransposedMatrix( inputBlobs[0]->GetData(), objectCount, inputSize, inputSize,
+		mainInputWeights->GetData(), hiddenSize, inputSize, inputMain, hiddenSize, objectCount * hiddenSize );
+	if( !mainLayer->IsZeroFreeTerm() ) {
+		MathEngine().AddVectorToMatrixRows( 1, inputMain, inputMain, objectCount, hiddenSize,
+			mainLayer->FreeTerms()->GetData() );
+	}
+
+	const CConstFloatHandle initialHidden = mainBackLink->GetInitialState( inputBlobs.Size() > 1 ? inputBlobs[1].Ptr() : nullptr );
+	const CFloatHandle hidden = outputBlobs[0]->GetData();
+	MathEngine().GruRecurrent( IsReverseSequence(), sequenceLength, batchSize, hiddenSize, inputGates, inputMain,
+		gateRecurWeights->GetData(), mainRecurWeights->GetData(), initialHidden, hidden );
+
+	const int lastStepOffset = IsReverseSequence() ? 0 : ( sequenceLength - 1 ) * batchSize * hiddenSize;
+	mainBackLink->CompleteSequence( hidden + lastStepOffset );
+}
+
 static const int GruLayerVersion = 2000;
 
 void CGruLayer::Serialize( CArchive& archive )
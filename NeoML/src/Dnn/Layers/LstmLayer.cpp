@@ -238,6 +238,69 @@ void CLstmLayer::SetCompatibilityMode( bool compatibilityMode )
 	ForceReshape();
 }
 
+void CLstmLayer::RunOnce()
+{
+	if( canProcessWholeSequence() ) {
+		processWholeSequence();
+	} else {
+		CRecurrentLayer::RunOnce();
+	}
+}
+
+// Checks if the sequence may be processed by IMathEngine::LstmRecurrent
+bool CLstmLayer::canProcessWholeSequence() const
+{
+	return CanProcessWholeSequence() && recurrentActivation == AF_Sigmoid
+		&& !inputHiddenLayer->IsQuantized() && inputHiddenLayer->GetFusedActivation().IsEmpty()
+		&& !recurHiddenLayer->IsQuantized() && recurHiddenLayer->GetFusedActivation().IsEmpty();
+}
+
+// Processes the whole sequence at once
+// The input projection is calculated for all the steps by a single matrix multiplication,
+// the recurrent part is calculated by the math engine without running the internal network
+void CLstmLayer::processWholeSequence()
+{
+	const int sequenceLength = inputBlobs[0]->GetBatchLength();
+	const int batchSize = inputBlobs[0]->GetBatchWidth();
+	const int objectCount = sequenceLength * batchSize;
+	const int inputSize = inputBlobs[0]->GetObjectSize();
+	const int hiddenSize = GetHiddenSize();
+	const int gateSize = G_Count * hiddenSize;
+	const int dataSize = objectCount * hiddenSize;
+
+	CFloatHandleStackVar inputGates( MathEngine(), objectCount * gateSize );
+	MathEngine().MultiplyMatrixByTransposedMatrix( inputBlobs[0]->GetData(), objectCount, inputSize, inputSize,
+		inputHiddenLayer->Weights()->GetData(), gateSize, inputSize, inputGates, gateSize, objectCount * gateSize );
+	if( !inputHiddenLayer->IsZeroFreeTerm() ) {
+		MathEngine().AddVectorToMatrixRows( 1, inputGates, inputGates, objectCount, gateSize,
+			inputHiddenLayer->FreeTerms()->GetData() );
+	}
+	if( !recurHiddenLayer->IsZeroFreeTerm() ) {
+		MathEngine().AddVectorToMatrixRows( 1, inputGates, inputGates, objectCount, gateSize,
+			recurHiddenLayer->FreeTerms()->GetData() );
+	}
+
+	// Initial history is the input #2, initial state is the input #1
+	const CConstFloatHandle initialHidden = mainBackLink->GetInitialState( inputBlobs.Size() > 2 ? inputBlobs[2].Ptr() : nullptr );
+	const CConstFloatHandle initialState = stateBackLink->GetInitialState( inputBlobs.Size() > 1 ? inputBlobs[1].Ptr() : nullptr );
+
+	// In compatibility mode the first output is tanh of the state
+	CFloatHandleStackVar hiddenBuffer( MathEngine(), isInCompatibilityMode ? dataSize : 1 );
+	CFloatHandleStackVar stateBuffer( MathEngine(), outputBlobs.Size() > 1 ? 1 : dataSize );
+	const CFloatHandle hidden = isInCompatibilityMode ? hiddenBuffer.GetHandle() : outputBlobs[0]->GetData();
+	const CFloatHandle state = outputBlobs.Size() > 1 ? outputBlobs[1]->GetData() : stateBuffer.GetHandle();
+
+	MathEngine().LstmRecurrent( IsReverseSequence(), sequenceLength, batchSize, hiddenSize, inputGates,
+		recurHiddenLayer->Weights()->GetData(), initialHidden, initialState, hidden, state );
+	if( isInCompatibilityMode ) {
+		MathEngine().VectorTanh( state, outputBlobs[0]->GetData(), dataSize );
+	}
+
+	const int lastStepOffset = IsReverseSequence() ? 0 : ( sequenceLength - 1 ) * batchSize * hiddenSize;
+	mainBackLink->CompleteSequence( hidden + lastStepOffset );
+	stateBackLink->CompleteSequence( state + lastStepOffset );
+}
+
 static const int LstmLayerVersion = 2001;
 
 void CLstmLayer::Serialize( CArchive& archive )
@@ -106,6 +106,33 @@ CArchive& operator >> (CArchive& archive, CLookupDimension& d) {
 	return archive >> d.VectorCount >> d.VectorSize;
 }
 
+void CMultichannelLookupLayer::ShareParams( const CBaseLayer& source )
+{
+	CBaseLayer::ShareParams( source );
+	const CMultichannelLookupLayer* lookup = CheckCast<const CMultichannelLookupLayer>( &source );
+	ownParams.SetSize( lookup->ownParams.Size() );
+	for( int i = 0; i < ownParams.Size(); ++i ) {
+		ownParams[i] = lookup->ownParams[i];
+	}
+}
+
+void CMultichannelLookupLayer::DetachParams( CObjectArray<IObject>& storage )
+{
+	CBaseLayer::DetachParams( storage );
+	for( int i = 0; i < ownParams.Size(); ++i ) {
+		storage.Add( ownParams[i].Ptr() );
+		ownParams[i] = nullptr;
+	}
+}
+
+void CMultichannelLookupLayer::AttachParams( const CObjectArray<IObject>& storage, int& position )
+{
+	CBaseLayer::AttachParams( storage, position );
+	for( int i = 0; i < ownParams.Size(); ++i ) {
+		ownParams[i] = static_cast<CDnnBlob*>( storage[position++].Ptr() );
+	}
+}
+
 static const int MultichannelLookupLayerVersion = 2000;
 
 void CMultichannelLookupLayer::Serialize( CArchive& archive )
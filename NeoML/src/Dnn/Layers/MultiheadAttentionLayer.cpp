@@ -34,7 +34,8 @@ CMultiheadAttentionLayer::CMultiheadAttentionLayer( IMathEngine& mathEngine ) :
 	hiddenSize( 8 ),
 	dropoutRate( -1 ),
 	useMask( false ),
-	outputSize( 8 )
+	outputSize( 8 ),
+	useFusedKernel( false )
 {
 }
 
@@ -73,25 +74,46 @@ void CMultiheadAttentionLayer::SetOutputSize( int _outputSize )
 	outputSize = _outputSize;
 }
 
-static const int MultiheadAttentionLayerVersion = 0;
+void CMultiheadAttentionLayer::SetUseFusedKernel( bool newValue )
+{
+	if( useFusedKernel == newValue ) {
+		return;
+	}
+
+	useFusedKernel = newValue;
+	deleteAttentionLayers();
+	ForceReshape();
+}
+
+static const int MultiheadAttentionLayerVersion = 1;
 
 void CMultiheadAttentionLayer::Serialize( CArchive& archive )
 {
-	archive.SerializeVersion( MultiheadAttentionLayerVersion );
+	const int version = archive.SerializeVersion( MultiheadAttentionLayerVersion );
 	CCompositeLayer::Serialize( archive );
 	archive.Serialize( headCount );
 	archive.Serialize( hiddenSize );
 	archive.Serialize( dropoutRate );
 	archive.Serialize( useMask );
 	archive.Serialize( outputSize );
+	if( version >= 1 ) {
+		archive.Serialize( useFusedKernel );
+	} else {
+		useFusedKernel = false;
+	}
 }
 
 void CMultiheadAttentionLayer::Reshape()
 {
-	if( !HasLayer( "Q" ) ) {
+	if( !HasLayer( "Q" ) || !HasLayer( useFusedKernel ? "Attention" : "MatrixDot" ) ) {
 		create();
 	}
 
+	if( useFusedKernel ) {
+		CheckArchitecture( GetOutputCount() == 1, GetName(),
+			"attention matrix output is unavailable when the fused kernel is used" );
+	}
+
 	CCompositeLayer::Reshape();
 }
 
@@ -113,6 +135,14 @@ void CMultiheadAttentionLayer::create()
 	CBaseLayer* K = multiplyInputByMatrixWeights( hiddenSize, "K", I_K );
 	CBaseLayer* V = multiplyInputByMatrixWeights( hiddenSize, "V", I_V );
 
+	if( useFusedKernel ) {
+		// [B, seq_Q, 1, hiddenSize]
+		CBaseLayer* attention = fusedAttention( Q, K, V );
+		CBaseLayer* output = multiplyByMatrixWeights( attention, outputSize, "Out.Dense" );
+		SetOutputMapping( O_Output, *output );
+		return;
+	}
+
 	// [B, n_head, seq_Q, d_k]
 	Q = prepareQ( Q );
 
@@ -185,6 +215,11 @@ CBaseLayer* CMultiheadAttentionLayer::multiplyInputByMatrixWeights(
 {
 	NeoAssert( size > 0 );
 
+	if( HasLayer( name ) ) {
+		// The weights are kept after switching the kernel
+		return GetLayer( name );
+	}
+
 	CPtr<CFullyConnectedLayer> fcLayer = new CFullyConnectedLayer( MathEngine() );
 	fcLayer->SetNumberOfElements( size );
 	fcLayer->SetZeroFreeTerm( false );
@@ -204,6 +239,13 @@ CBaseLayer* CMultiheadAttentionLayer::multiplyByMatrixWeights( CBaseLayer* input
 	NeoAssert( width >= 0 );
 	NeoAssert( input != 0 );
 
+	if( HasLayer( name ) ) {
+		// The weights are kept after switching the kernel
+		CPtr<CBaseLayer> fcLayer = GetLayer( name );
+		fcLayer->Connect( *input );
+		return fcLayer;
+	}
+
 	CPtr<CFullyConnectedLayer> fcLayer = new CFullyConnectedLayer( MathEngine() );
 	fcLayer->SetNumberOfElements( width );
 	fcLayer->Connect( *input );
@@ -399,6 +441,129 @@ CBaseLayer* CMultiheadAttentionLayer::prepareOutput( CBaseLayer* input )
 	return reshape0;
 }
 
+// Deletes all the layers except the trainable matrices W_Q, W_K, W_V and W_O
+void CMultiheadAttentionLayer::deleteAttentionLayers()
+{
+	CArray<const char*> layerList;
+	GetLayerList( layerList );
+
+	CArray<CString> layersToDelete;
+	for( int i = 0; i < layerList.Size(); ++i ) {
+		const CString name = layerList[i];
+		if( name != "Q" && name != "K" && name != "V" && name != "Out.Dense" ) {
+			layersToDelete.Add( name );
+		}
+	}
+
+	for( int i = 0; i < layersToDelete.Size(); ++i ) {
+		DeleteLayer( layersToDelete[i] );
+	}
+}
+
+// [B, seq_Q, 1, hidden_size]
+CBaseLayer* CMultiheadAttentionLayer::fusedAttention( CBaseLayer* Q, CBaseLayer* K, CBaseLayer* V )
+{
+	NeoAssert( Q != 0 );
+	NeoAssert( K != 0 );
+	NeoAssert( V != 0 );
+
+	CPtr<CMultiheadAttentionFusedLayer> attention = new CMultiheadAttentionFusedLayer( MathEngine() );
+	attention->SetName( "Attention" );
+	attention->SetHeadCount( headCount );
+	attention->Connect( 0, *Q );
+	attention->Connect( 1, *K );
+	attention->Connect( 2, *V );
+	AddLayer( *attention );
+	if( useMask ) {
+		SetInputMapping( I_Mask, *attention, 3 );
+	}
+
+	return attention;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+CMultiheadAttentionFusedLayer::CMultiheadAttentionFusedLayer( IMathEngine& mathEngine ) :
+	CBaseLayer( mathEngine, "CMultiheadAttentionFusedLayer", false ),
+	headCount( 1 )
+{
+}
+
+void CMultiheadAttentionFusedLayer::SetHeadCount( int _headCount )
+{
+	NeoAssert( _headCount >= 1 );
+
+	headCount = _headCount;
+	ForceReshape();
+}
+
+static const int MultiheadAttentionFusedLayerVersion = 0;
+
+void CMultiheadAttentionFusedLayer::Serialize( CArchive& archive )
+{
+	archive.SerializeVersion( MultiheadAttentionFusedLayerVersion );
+	CBaseLayer::Serialize( archive );
+	archive.Serialize( headCount );
+}
+
+void CMultiheadAttentionFusedLayer::Reshape()
+{
+	CheckInputs();
+	CheckArchitecture( GetInputCount() == 3 || GetInputCount() == 4, GetName(),
+		"multihead attention must have 3 or 4 inputs" );
+	CheckArchitecture( !IsBackwardPerformed(), GetName(), "fused multihead attention supports only inference" );
+
+	const CBlobDesc& q = inputDescs[0];
+	const CBlobDesc& k = inputDescs[1];
+	const CBlobDesc& v = inputDescs[2];
+	CheckArchitecture( q.ObjectSize() == q.Channels() && k.ObjectSize() == k.Channels()
+		&& v.ObjectSize() == v.Channels(), GetName(), "Q, K and V must be matrices" );
+	CheckArchitecture( q.Channels() == k.Channels() && q.Channels() == v.Channels(), GetName(),
+		"Q, K and V must have the same number of channels" );
+	CheckArchitecture( q.Channels() % headCount == 0, GetName(), "channels must be a multiple of head count" );
+	CheckArchitecture( q.BatchLength() == k.BatchLength() && q.BatchWidth() == k.BatchWidth()
+		&& k.ObjectCount() == v.ObjectCount(), GetName(), "Q, K and V batch sizes mismatch" );
+	if( GetInputCount() == 4 ) {
+		CheckArchitecture( inputDescs[3].BlobSize() == q.ListSize() * k.ListSize(), GetName(),
+			"mask must be of ListSize_Q * ListSize_V size" );
+	}
+
+	outputDescs[0] = q;
+}
+
+void CMultiheadAttentionFusedLayer::RunOnce()
+{
+	const CBlobDesc& q = inputBlobs[0]->GetDesc();
+	const CBlobDesc& k = inputBlobs[1]->GetDesc();
+	const int batchSize = q.BatchLength() * q.BatchWidth();
+	const int headSize = q.Channels() / headCount;
+	// scaling factor
+	const float multiplier = static_cast<float>( 1.0 / sqrt( 1.0 * q.Channels() ) );
+
+	if( GetInputCount() == 3 ) {
+		MathEngine().MultiheadAttention( batchSize, headCount, headSize, q.ListSize(), k.ListSize(), multiplier,
+			inputBlobs[0]->GetData(), inputBlobs[1]->GetData(), inputBlobs[2]->GetData(), CConstFloatHandle(),
+			outputBlobs[0]->GetData() );
+		return;
+	}
+
+	// The value is taken from the original realization
+	const int maskSize = inputBlobs[3]->GetDataSize();
+	CFloatHandleStackVar maskMultiplier( MathEngine() );
+	maskMultiplier.SetValue( -1e+9 );
+	CFloatHandleStackVar mask( MathEngine(), maskSize );
+	MathEngine().VectorMultiply( inputBlobs[3]->GetData(), mask, maskSize, maskMultiplier );
+
+	MathEngine().MultiheadAttention( batchSize, headCount, headSize, q.ListSize(), k.ListSize(), multiplier,
+		inputBlobs[0]->GetData(), inputBlobs[1]->GetData(), inputBlobs[2]->GetData(), mask,
+		outputBlobs[0]->GetData() );
+}
+
+void CMultiheadAttentionFusedLayer::BackwardOnce()
+{
+	NeoAssert( false );
+}
+
 CLayerWrapper<CMultiheadAttentionLayer> MultiheadAttention(
 	int headCount, int hiddenSize, int outputSize, float dropoutRate )
 {
@@ -170,6 +170,20 @@ void CRecurrentLayer::SetInternalDnnParams()
 	}
 }
 
+bool CRecurrentLayer::CanProcessWholeSequence() const
+{
+	if( GetDnn()->IsRecurrentMode() || GetDnn()->IsBackwardPerformed() || repeatCount != 1 ) {
+		return false;
+	}
+	for( int i = 1; i < inputBlobs.Size(); ++i ) {
+		if( inputBlobs[i]->GetBatchLength() != 1 ) {
+			// Teacher forcing mode
+			return false;
+		}
+	}
+	return true;
+}
+
 // Runs the forward pass of the internal network (overloaded in children)
 void CRecurrentLayer::RunInternalDnn()
 {
@@ -1921,6 +1921,35 @@ GTEST_TEST( SerializeFromFile, MultiheadAttentionLayerSerialization )
 
 // ====================================================================================================================
 
+// CMultiheadAttentionFusedLayer
+
+#ifdef GENERATE_SERIALIZATION_FILES
+
+static void setSpecificParams( CMultiheadAttentionFusedLayer& layer )
+{
+	layer.SetHeadCount( 7 );
+}
+
+GTEST_TEST( SerializeToFile, MultiheadAttentionFusedLayerSerialization )
+{
+	serializeToFile<CMultiheadAttentionFusedLayer>( "NeoMLDnnMultiheadAttentionFusedLayer" );
+}
+
+#endif // GENERATE_SERIALIZATION_FILES
+
+template<>
+inline void checkSpecificParams<CMultiheadAttentionFusedLayer>( CMultiheadAttentionFusedLayer& layer )
+{
+	EXPECT_EQ( 7, layer.GetHeadCount() );
+}
+
+GTEST_TEST( SerializeFromFile, MultiheadAttentionFusedLayerSerialization )
+{
+	checkSerializeLayer<CMultiheadAttentionFusedLayer>( "NeoMLDnnMultiheadAttentionFusedLayer" );
+}
+
+// ====================================================================================================================
+
 // CPositionalEmbeddingLayer
 
 #ifdef GENERATE_SERIALIZATION_FILES
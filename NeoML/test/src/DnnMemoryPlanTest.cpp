@@ -0,0 +1,108 @@
+/* Copyright © 2017-2021 ABBYY Production LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+--------------------------------------------------------------------------------------------------------------*/
+
+#include <common.h>
+#pragma hdrstop
+
+#include <TestFixture.h>
+
+using namespace NeoML;
+using namespace NeoMLTest;
+
+static CPtr<CDnnBlob> createInput( CRandom& random, int height, int width, int channels )
+{
+	CPtr<CDnnBlob> blob = CDnnBlob::Create2DImageBlob( MathEngine(), CT_Float, 1, 2, height, width, channels );
+	CArray<float> data;
+	data.SetSize( blob->GetDataSize() );
+	for( int i = 0; i < data.Size(); ++i ) {
+		data[i] = static_cast<float>( random.Uniform( -1, 1 ) );
+	}
+	blob->CopyFrom( data.GetPtr() );
+	return blob;
+}
+
+static void getOutput( CDnn& dnn, const char* sinkName, CArray<float>& output )
+{
+	CPtr<CDnnBlob> blob = CheckCast<CSinkLayer>( dnn.GetLayer( sinkName ) )->GetBlob();
+	output.SetSize( blob->GetDataSize() );
+	blob->CopyTo( output.GetPtr() );
+}
+
+static void checkOutputs( CDnn& dnn, const CArray<float>& expectedMain, const CArray<float>& expectedBranch )
+{
+	CArray<float> main;
+	CArray<float> branch;
+	getOutput( dnn, "sink", main );
+	getOutput( dnn, "branchSink", branch );
+	ASSERT_EQ( expectedMain.Size(), main.Size() );
+	for( int i = 0; i < main.Size(); ++i ) {
+		EXPECT_NEAR( expectedMain[i], main[i], 1e-5 );
+	}
+	ASSERT_EQ( expectedBranch.Size(), branch.Size() );
+	for( int i = 0; i < branch.Size(); ++i ) {
+		EXPECT_NEAR( expectedBranch[i], branch[i], 1e-5 );
+	}
+}
+
+TEST( CDnnMemoryPlanTest, SharedArena )
+{
+	const int channels = 8;
+	CRandom random( 0x4321 );
+	CDnn dnn( random, MathEngine() );
+
+	// conv1 -> relu (in-place) -> conv2 -> conv3 -> sum (with conv2) -> conv4 -> sink
+	//                                   \-> branch conv -> branchSink
+	CSourceLayer* source = Source( dnn, "source" );
+	CPtr<CBaseLayer> conv1 = Conv( channels, CConvAxisParams( 3, 1 ), CConvAxisParams( 3, 1 ) )( "conv1", source );
+	CPtr<CBaseLayer> relu = Relu()( "relu", conv1.Ptr() );
+	CPtr<CBaseLayer> conv2 = Conv( channels, CConvAxisParams( 3, 1 ), CConvAxisParams( 3, 1 ) )( "conv2", relu.Ptr() );
+	CPtr<CBaseLayer> conv3 = Conv( channels, CConvAxisParams( 3, 1 ), CConvAxisParams( 3, 1 ) )( "conv3", conv2.Ptr() );
+	CPtr<CBaseLayer> sum = Sum()( "sum", conv3.Ptr(), conv2.Ptr() );
+	CPtr<CBaseLayer> conv4 = Conv( channels, CConvAxisParams( 3, 1 ), CConvAxisParams( 3, 1 ) )( "conv4", sum.Ptr() );
+	Sink( conv4.Ptr(), "sink" );
+	CPtr<CBaseLayer> branch = Conv( 3, CConvAxisParams( 1 ), CConvAxisParams( 1 ) )( "branch", relu.Ptr() );
+	Sink( branch.Ptr(), "branchSink" );
+
+	// The last size is large enough for the network to release the blobs right after use
+	const int sizes[] = { 6, 12, 160 };
+	for( int size : sizes ) {
+		source->SetBlob( createInput( random, size, size + 1, channels ) );
+
+		dnn.EnableStaticMemoryPlanning( false );
+		dnn.RunOnce();
+		EXPECT_EQ( 0u, dnn.GetPlannedMemorySize() );
+		CArray<float> expectedMain;
+		CArray<float> expectedBranch;
+		getOutput( dnn, "sink", expectedMain );
+		getOutput( dnn, "branchSink", expectedBranch );
+
+		dnn.EnableStaticMemoryPlanning( true );
+		for( int run = 0; run < 2; ++run ) {
+			dnn.RunOnce();
+			checkOutputs( dnn, expectedMain, expectedBranch );
+		}
+
+		// conv1, conv2, conv3, sum, conv4 and branch outputs; the blobs with disjoint lifetimes share memory
+		const size_t blobSize = 2 * size * ( size + 1 ) * channels * sizeof( float );
+		EXPECT_LT( 0u, dnn.GetPlannedMemorySize() );
+		EXPECT_GT( 6 * blobSize, dnn.GetPlannedMemorySize() );
+	}
+
+	// The plan is dropped for the backward pass and built again for inference
+	dnn.RunAndBackwardOnce();
+	EXPECT_EQ( 0u, dnn.GetPlannedMemorySize() );
+	dnn.RunOnce();
+	EXPECT_LT( 0u, dnn.GetPlannedMemorySize() );
+}
@@ -0,0 +1,108 @@
+/* Copyright © 2017-2021 ABBYY Production LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+--------------------------------------------------------------------------------------------------------------*/
+
+#include <common.h>
+#pragma hdrstop
+
+#include <TestFixture.h>
+
+using namespace NeoML;
+using namespace NeoMLTest;
+
+static const int BatchSize = 2;
+static const int ListSizeQ = 3;
+static const int ListSizeV = 4;
+
+static CPtr<CDnnBlob> createRandomBlob( CRandom& random, int listSize, int channels )
+{
+	CPtr<CDnnBlob> blob = CDnnBlob::CreateListBlob( MathEngine(), CT_Float, 1, BatchSize, listSize, channels );
+	CArray<float> data;
+	data.SetSize( blob->GetDataSize() );
+	for( int i = 0; i < data.Size(); ++i ) {
+		data[i] = static_cast<float>( random.Uniform( -1, 1 ) );
+	}
+	blob->CopyFrom( data.GetPtr() );
+	return blob;
+}
+
+static void getOutput( CDnn& dnn, CArray<float>& output )
+{
+	dnn.RunOnce();
+	CPtr<CDnnBlob> blob = CheckCast<CSinkLayer>( dnn.GetLayer( "sink" ) )->GetBlob();
+	output.SetSize( blob->GetDataSize() );
+	blob->CopyTo( output.GetPtr() );
+}
+
+// The fused kernel gives the same result as the chain of the layers
+static void checkFusedKernel( bool useMask )
+{
+	CRandom random( useMask ? 0x321 : 0x123 );
+	CDnn dnn( random, MathEngine() );
+	CSourceLayer* q = Source( dnn, "q" );
+	q->SetBlob( createRandomBlob( random, ListSizeQ, 6 ) );
+	CSourceLayer* k = Source( dnn, "k" );
+	k->SetBlob( createRandomBlob( random, ListSizeV, 6 ) );
+	CSourceLayer* v = Source( dnn, "v" );
+	v->SetBlob( createRandomBlob( random, ListSizeV, 7 ) );
+
+	CPtr<CMultiheadAttentionLayer> attention = new CMultiheadAttentionLayer( MathEngine() );
+	attention->SetName( "attention" );
+	attention->SetHeadCount( 2 );
+	attention->SetHiddenSize( 8 );
+	attention->SetOutputSize( 5 );
+	attention->SetUseMask( useMask );
+	attention->Connect( 0, *q );
+	attention->Connect( 1, *k );
+	attention->Connect( 2, *v );
+	if( useMask ) {
+		// Every query position sees only the first positions of the sequence
+		CPtr<CDnnBlob> maskBlob = CDnnBlob::Create2DImageBlob( MathEngine(), CT_Float, 1, 1, 1, ListSizeQ, ListSizeV );
+		CArray<float> maskData;
+		maskData.SetSize( maskBlob->GetDataSize() );
+		for( int i = 0; i < ListSizeQ; ++i ) {
+			for( int j = 0; j < ListSizeV; ++j ) {
+				maskData[i * ListSizeV + j] = j > i ? 1.f : 0.f;
+			}
+		}
+		maskBlob->CopyFrom( maskData.GetPtr() );
+		CSourceLayer* mask = Source( dnn, "mask" );
+		mask->SetBlob( maskBlob );
+		attention->Connect( 3, *mask );
+	}
+	dnn.AddLayer( *attention );
+	Sink( attention.Ptr(), "sink" );
+
+	CArray<float> expected;
+	getOutput( dnn, expected );
+
+	attention->SetUseFusedKernel( true );
+	CArray<float> actual;
+	getOutput( dnn, actual );
+
+	ASSERT_EQ( expected.Size(), actual.Size() );
+	for( int i = 0; i < expected.Size(); ++i ) {
+		EXPECT_NEAR( expected[i], actual[i], 1e-4 );
+	}
+}
+
+TEST( CDnnMultiheadAttentionTest, FusedKernel )
+{
+	checkFusedKernel( false );
+}
+
+TEST( CDnnMultiheadAttentionTest, FusedKernelWithMask )
+{
+	checkFusedKernel( true );
+}
@@ -0,0 +1,130 @@
+/* Copyright © 2017-2021 ABBYY Production LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+--------------------------------------------------------------------------------------------------------------*/
+
+#include <common.h>
+#pragma hdrstop
+
+#include <TestFixture.h>
+
+using namespace NeoML;
+using namespace NeoMLTest;
+
+static void fillRandom( CDnnBlob& blob, CRandom& random, float min, float max )
+{
+	CArray<float> data;
+	data.SetSize( blob.GetDataSize() );
+	for( int i = 0; i < data.Size(); ++i ) {
+		data[i] = static_cast<float>( random.Uniform( min, max ) );
+	}
+	blob.CopyFrom( data.GetPtr() );
+}
+
+// Creates the batch normalization with random final parameters
+static CBatchNormalizationLayer* addBatchNorm( CDnn& dnn, CRandom& random, const char* name,
+	const CDnnLayerLink& input, int channels )
+{
+	CPtr<CBatchNormalizationLayer> batchNorm = new CBatchNormalizationLayer( dnn.GetMathEngine() );
+	batchNorm->SetName( name );
+	CPtr<CDnnBlob> params = CDnnBlob::CreateDataBlob( dnn.GetMathEngine(), CT_Float, 1, 2, channels );
+	fillRandom( *params, random, 0.5f, 1.5f );
+	batchNorm->SetFinalParams( params );
+	batchNorm->UseFinalParamsForInitialization( true );
+	batchNorm->Connect( 0, *input.Layer, input.OutputNumber );
+	dnn.AddLayer( *batchNorm );
+	return batchNorm;
+}
+
+static void getOutput( CDnn& dnn, const char* sinkName, CArray<float>& output )
+{
+	dnn.RunOnce();
+	CPtr<CDnnBlob> blob = CheckCast<CSinkLayer>( dnn.GetLayer( sinkName ) )->GetBlob();
+	output.SetSize( blob->GetDataSize() );
+	blob->CopyTo( output.GetPtr() );
+}
+
+TEST( CDnnOptimizationTest, ResidualBlock )
+{
+	const int channels = 6;
+	CRandom random( 0x1234 );
+	CDnn dnn( random, MathEngine() );
+
+	// conv -> bn -> relu -> conv -> bn -> sum (with the block input) -> relu -> fc -> bn -> sigmoid
+	CSourceLayer* source = Source( dnn, "source" );
+	CPtr<CBaseLayer> conv1 = Conv( channels, CConvAxisParams( 3, 1 ), CConvAxisParams( 3, 1 ) )( "conv1", source );
+	CBatchNormalizationLayer* bn1 = addBatchNorm( dnn, random, "bn1", conv1.Ptr(), channels );
+	CPtr<CBaseLayer> relu1 = Relu()( "relu1", bn1 );
+	CPtr<CBaseLayer> conv2 = Conv( channels, CConvAxisParams( 3, 1 ), CConvAxisParams( 3, 1 ) )( "conv2", relu1.Ptr() );
+	CBatchNormalizationLayer* bn2 = addBatchNorm( dnn, random, "bn2", conv2.Ptr(), channels );
+	CPtr<CBaseLayer> sum = Sum()( "sum", bn2, source );
+	CPtr<CBaseLayer> relu2 = Relu( 2.f )( "relu2", sum.Ptr() );
+	CPtr<CBaseLayer> fc = FullyConnected( 5 )( "fc", relu2.Ptr() );
+	CBatchNormalizationLayer* bn3 = addBatchNorm( dnn, random, "bn3", fc.Ptr(), 5 );
+	CPtr<CBaseLayer> sigmoid = Sigmoid()( "sigmoid", bn3 );
+	Sink( sigmoid.Ptr(), "sink" );
+	// The output of conv3 is used twice, so the activation after it can't be fused
+	CPtr<CBaseLayer> conv3 = Conv( 2, CConvAxisParams( 1 ), CConvAxisParams( 1 ) )( "conv3", source );
+	CPtr<CBaseLayer> tanh = Tanh()( "tanh", conv3.Ptr() );
+	Sink( tanh.Ptr(), "tanhSink" );
+	Sink( conv3.Ptr(), "conv3Sink" );
+
+	CPtr<CDnnBlob> input = CDnnBlob::Create2DImageBlob( MathEngine(), CT_Float, 1, 4, 40, 37, channels );
+	fillRandom( *input, random, -1.f, 1.f );
+	source->SetBlob( input );
+
+	CArray<float> expected;
+	getOutput( dnn, "sink", expected );
+	CArray<float> expectedTanh;
+	getOutput( dnn, "tanhSink", expectedTanh );
+
+	CDnnOptimizationReport report = OptimizeForInference( dnn );
+	EXPECT_EQ( 3, report.FoldedBatchNormalizations );
+	EXPECT_EQ( 2, report.FusedActivations );
+	EXPECT_EQ( 1, report.FusedSumActivations );
+	EXPECT_FALSE( dnn.HasLayer( "bn1" ) || dnn.HasLayer( "bn2" ) || dnn.HasLayer( "bn3" ) );
+	EXPECT_FALSE( dnn.HasLayer( "relu1" ) || dnn.HasLayer( "relu2" ) || dnn.HasLayer( "sigmoid" ) );
+	EXPECT_TRUE( dnn.HasLayer( "tanh" ) );
+	EXPECT_EQ( AF_ReLU, CheckCast<CEltwiseSumLayer>( sum )->GetFusedActivation().Type );
+	EXPECT_EQ( 2.f, CheckCast<CEltwiseSumLayer>( sum )->GetFusedActivation().Param );
+
+	CArray<float> actual;
+	getOutput( dnn, "sink", actual );
+	ASSERT_EQ( expected.Size(), actual.Size() );
+	for( int i = 0; i < expected.Size(); ++i ) {
+		EXPECT_NEAR( expected[i], actual[i], 1e-4f );
+	}
+	getOutput( dnn, "tanhSink", actual );
+	ASSERT_EQ( expectedTanh.Size(), actual.Size() );
+	for( int i = 0; i < expectedTanh.Size(); ++i ) {
+		EXPECT_NEAR( expectedTanh[i], actual[i], 1e-4f );
+	}
+
+	// The fused activations are serialized
+	CMemoryTestFile file;
+	{
+		CArchive archive( &file, CArchive::SD_Storing );
+		archive.Serialize( dnn );
+	}
+	file.SeekToBegin();
+	CDnn loaded( random, MathEngine() );
+	{
+		CArchive archive( &file, CArchive::SD_Loading );
+		archive.Serialize( loaded );
+	}
+	CheckCast<CSourceLayer>( loaded.GetLayer( "source" ) )->SetBlob( input );
+	getOutput( loaded, "sink", actual );
+	for( int i = 0; i < expected.Size(); ++i ) {
+		EXPECT_NEAR( expected[i], actual[i], 1e-4f );
+	}
+}
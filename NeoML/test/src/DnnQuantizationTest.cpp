@@ -0,0 +1,229 @@
+/* Copyright © 2017-2021 ABBYY Production LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+--------------------------------------------------------------------------------------------------------------*/
+
+#include <common.h>
+#pragma hdrstop
+
+#include <TestFixture.h>
+
+using namespace NeoML;
+using namespace NeoMLTest;
+
+static CPtr<CDnnBlob> createInput( CRandom& random, int batchWidth )
+{
+	CPtr<CDnnBlob> blob = CDnnBlob::Create2DImageBlob( MathEngine(), CT_Float, 1, batchWidth, 8, 8, 3 );
+	CArray<float> data;
+	data.SetSize( blob->GetDataSize() );
+	for( int i = 0; i < data.Size(); ++i ) {
+		data[i] = static_cast<float>( random.Uniform( -1, 1 ) );
+	}
+	blob->CopyFrom( data.GetPtr() );
+	return blob;
+}
+
+static void getOutput( CDnn& dnn, CArray<float>& output )
+{
+	dnn.RunOnce();
+	CPtr<CDnnBlob> blob = CheckCast<CSinkLayer>( dnn.GetLayer( "sink" ) )->GetBlob();
+	output.SetSize( blob->GetDataSize() );
+	blob->CopyTo( output.GetPtr() );
+}
+
+// source -> conv -> relu -> fc -> sink
+static void buildNetwork( CDnn& dnn )
+{
+	CSourceLayer* source = Source( dnn, "source" );
+	CPtr<CBaseLayer> conv = Conv( 6, CConvAxisParams( 3, 1 ), CConvAxisParams( 3, 1 ) )( "conv", source );
+	CPtr<CBaseLayer> relu = Relu()( "relu", conv.Ptr() );
+	CPtr<CBaseLayer> fc = FullyConnected( 5 )( "fc", relu.Ptr() );
+	Sink( fc.Ptr(), "sink" );
+}
+
+// The quantized output may differ from the float output by a few percent of its range
+static void checkQuantizationError( const CArray<float>& expected, const CArray<float>& actual )
+{
+	ASSERT_EQ( expected.Size(), actual.Size() );
+	float maxAbs = 0;
+	for( int i = 0; i < expected.Size(); ++i ) {
+		maxAbs = max( maxAbs, fabsf( expected[i] ) );
+	}
+	ASSERT_LT( 0.f, maxAbs );
+	for( int i = 0; i < expected.Size(); ++i ) {
+		EXPECT_NEAR( expected[i], actual[i], 0.03f * maxAbs );
+	}
+}
+
+static void checkInt8WeightsEqual( const CDnnInt8Weights& expected, const CDnnInt8Weights& actual )
+{
+	ASSERT_TRUE( expected.GetDesc().HasEqualDimensions( actual.GetDesc() ) );
+	EXPECT_EQ( expected.GetInputScale(), actual.GetInputScale() );
+
+	const int size = expected.GetDesc().BlobSize();
+	CArray<signed char> expectedData;
+	expectedData.SetSize( size );
+	MathEngine().DataExchangeTyped<signed char>( expectedData.GetPtr(), expected.GetData(), size );
+	CArray<signed char> actualData;
+	actualData.SetSize( size );
+	MathEngine().DataExchangeTyped<signed char>( actualData.GetPtr(), actual.GetData(), size );
+	for( int i = 0; i < size; ++i ) {
+		EXPECT_EQ( expectedData[i], actualData[i] );
+	}
+
+	const int objectCount = expected.GetDesc().ObjectCount();
+	CArray<float> expectedScales;
+	expectedScales.SetSize( objectCount );
+	MathEngine().DataExchangeTyped<float>( expectedScales.GetPtr(), expected.GetScales(), objectCount );
+	CArray<float> actualScales;
+	actualScales.SetSize( objectCount );
+	MathEngine().DataExchangeTyped<float>( actualScales.GetPtr(), actual.GetScales(), objectCount );
+	for( int i = 0; i < objectCount; ++i ) {
+		EXPECT_EQ( expectedScales[i], actualScales[i] );
+	}
+}
+
+TEST( CDnnQuantizationTest, QuantizeWeights )
+{
+	if( MathEngineType() != MET_Cpu ) {
+		// Int8 inference is supported only on CPU
+		return;
+	}
+
+	CRandom random( 0x2001 );
+	CDnn dnn( random, MathEngine() );
+	buildNetwork( dnn );
+	CheckCast<CSourceLayer>( dnn.GetLayer( "source" ) )->SetBlob( createInput( random, 2 ) );
+	CArray<float> expected;
+	getOutput( dnn, expected );
+
+	CFullyConnectedLayer* fc = CheckCast<CFullyConnectedLayer>( dnn.GetLayer( "fc" ) );
+	CPtr<CDnnBlob> weights = fc->GetWeightsData();
+	CArray<float> weightsData;
+	weightsData.SetSize( weights->GetDataSize() );
+	weights->CopyTo( weightsData.GetPtr() );
+
+	fc->QuantizeWeights();
+	ASSERT_TRUE( fc->IsQuantized() );
+	EXPECT_EQ( 0.f, fc->GetInt8Weights()->GetInputScale() );
+
+	// Every neuron is quantized with its own scale, so the error of every weight is at most half of the scale
+	CPtr<CDnnBlob> dequantized = fc->GetInt8Weights()->Dequantize();
+	ASSERT_EQ( weightsData.Size(), dequantized->GetDataSize() );
+	CArray<float> dequantizedData;
+	dequantizedData.SetSize( dequantized->GetDataSize() );
+	dequantized->CopyTo( dequantizedData.GetPtr() );
+	const int objectSize = weights->GetObjectSize();
+	for( int i = 0; i < weights->GetObjectCount(); ++i ) {
+		float maxAbs = 0;
+		for( int j = 0; j < objectSize; ++j ) {
+			maxAbs = max( maxAbs, fabsf( weightsData[i * objectSize + j] ) );
+		}
+		const float scale = maxAbs / 127.f;
+		for( int j = 0; j < objectSize; ++j ) {
+			EXPECT_NEAR( weightsData[i * objectSize + j], dequantizedData[i * objectSize + j], 0.5f * scale + 1e-6f );
+		}
+	}
+
+	CArray<float> actual;
+	getOutput( dnn, actual );
+	checkQuantizationError( expected, actual );
+}
+
+TEST( CDnnQuantizationTest, QuantizerAccuracy )
+{
+	if( MathEngineType() != MET_Cpu ) {
+		// Int8 inference is supported only on CPU
+		return;
+	}
+
+	CRandom random( 0x2001 );
+	CDnn dnn( random, MathEngine() );
+	buildNetwork( dnn );
+	CSourceLayer* source = CheckCast<CSourceLayer>( dnn.GetLayer( "source" ) );
+	source->SetBlob( createInput( random, 2 ) );
+	dnn.RunOnce();
+
+	CDnnInt8Quantizer quantizer( dnn );
+	const int calibrationBatchCount = 3;
+	for( int i = 0; i < calibrationBatchCount; ++i ) {
+		source->SetBlob( createInput( random, 4 ) );
+		quantizer.Calibrate();
+	}
+	EXPECT_EQ( calibrationBatchCount, quantizer.GetCalibrationBatchCount() );
+
+	CPtr<CDnnBlob> input = createInput( random, 4 );
+	source->SetBlob( input );
+	CArray<float> expected;
+	getOutput( dnn, expected );
+
+	EXPECT_EQ( 2, quantizer.Quantize() );
+	EXPECT_TRUE( CheckCast<CConvLayer>( dnn.GetLayer( "conv" ) )->IsQuantized() );
+	EXPECT_LT( 0.f, CheckCast<CConvLayer>( dnn.GetLayer( "conv" ) )->GetInt8Weights()->GetInputScale() );
+	EXPECT_TRUE( CheckCast<CFullyConnectedLayer>( dnn.GetLayer( "fc" ) )->IsQuantized() );
+	EXPECT_LT( 0.f, CheckCast<CFullyConnectedLayer>( dnn.GetLayer( "fc" ) )->GetInt8Weights()->GetInputScale() );
+
+	CArray<float> actual;
+	getOutput( dnn, actual );
+	checkQuantizationError( expected, actual );
+}
+
+TEST( CDnnQuantizationTest, Serialization )
+{
+	if( MathEngineType() != MET_Cpu ) {
+		// Int8 inference is supported only on CPU
+		return;
+	}
+
+	CRandom random( 0x2001 );
+	CDnn dnn( random, MathEngine() );
+	buildNetwork( dnn );
+	CSourceLayer* source = CheckCast<CSourceLayer>( dnn.GetLayer( "source" ) );
+	CPtr<CDnnBlob> input = createInput( random, 2 );
+	source->SetBlob( input );
+	dnn.RunOnce();
+	// The convolution quantizes its input statically, the fully-connected layer does it on every run
+	CheckCast<CConvLayer>( dnn.GetLayer( "conv" ) )->QuantizeWeights( 1.f / 127 );
+	CheckCast<CFullyConnectedLayer>( dnn.GetLayer( "fc" ) )->QuantizeWeights();
+	CArray<float> expected;
+	getOutput( dnn, expected );
+
+	CMemoryTestFile file;
+	{
+		CArchive archive( &file, CArchive::SD_Storing );
+		archive.Serialize( dnn );
+	}
+	file.SeekToBegin();
+	CDnn loaded( random, MathEngine() );
+	{
+		CArchive archive( &file, CArchive::SD_Loading );
+		archive.Serialize( loaded );
+	}
+
+	const CConvLayer* conv = CheckCast<CConvLayer>( dnn.GetLayer( "conv" ) );
+	const CConvLayer* loadedConv = CheckCast<CConvLayer>( loaded.GetLayer( "conv" ) );
+	ASSERT_TRUE( loadedConv->IsQuantized() );
+	checkInt8WeightsEqual( *conv->GetInt8Weights(), *loadedConv->GetInt8Weights() );
+	const CFullyConnectedLayer* fc = CheckCast<CFullyConnectedLayer>( dnn.GetLayer( "fc" ) );
+	const CFullyConnectedLayer* loadedFc = CheckCast<CFullyConnectedLayer>( loaded.GetLayer( "fc" ) );
+	ASSERT_TRUE( loadedFc->IsQuantized() );
+	checkInt8WeightsEqual( *fc->GetInt8Weights(), *loadedFc->GetInt8Weights() );
+
+	CheckCast<CSourceLayer>( loaded.GetLayer( "source" ) )->SetBlob( input );
+	CArray<float> actual;
+	getOutput( loaded, actual );
+	ASSERT_EQ( expected.Size(), actual.Size() );
+	for( int i = 0; i < expected.Size(); ++i ) {
+		EXPECT_EQ( expected[i], actual[i] );
+	}
+}
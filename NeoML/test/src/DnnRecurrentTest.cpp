@@ -0,0 +1,181 @@
+/* Copyright © 2017-2021 ABBYY Production LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+--------------------------------------------------------------------------------------------------------------*/
+
+#include <common.h>
+#pragma hdrstop
+
+#include <TestFixture.h>
+
+using namespace NeoML;
+using namespace NeoMLTest;
+
+static const int SequenceLength = 5;
+static const int BatchSize = 3;
+static const int InputSize = 6;
+static const int HiddenSize = 7;
+
+static CPtr<CDnnBlob> createSequence( CRandom& random, int sequenceLength, int channels )
+{
+	CPtr<CDnnBlob> blob = CDnnBlob::CreateDataBlob( MathEngine(), CT_Float, sequenceLength, BatchSize, channels );
+	CArray<float> data;
+	data.SetSize( blob->GetDataSize() );
+	for( int i = 0; i < data.Size(); ++i ) {
+		data[i] = static_cast<float>( random.Uniform( -1, 1 ) );
+	}
+	blob->CopyFrom( data.GetPtr() );
+	return blob;
+}
+
+// Runs the network twice in a row (the second run continues the sequence)
+// The whole sequence is processed at once during inference and step by step when the backward pass is performed
+static void checkWholeSequence( CDnn& dnn, const CArray<const char*>& sinks )
+{
+	CObjectArray<CDnnBlob> expected;
+	for( int run = 0; run < 2; ++run ) {
+		dnn.RunAndBackwardOnce();
+		for( int i = 0; i < sinks.Size(); ++i ) {
+			expected.Add( CheckCast<CSinkLayer>( dnn.GetLayer( sinks[i] ) )->GetBlob()->GetCopy() );
+		}
+	}
+	dnn.RestartSequence();
+
+	for( int run = 0; run < 2; ++run ) {
+		dnn.RunOnce();
+		for( int i = 0; i < sinks.Size(); ++i ) {
+			CPtr<CDnnBlob> actual = CheckCast<CSinkLayer>( dnn.GetLayer( sinks[i] ) )->GetBlob();
+			const CDnnBlob& expectedBlob = *expected[run * sinks.Size() + i];
+			ASSERT_TRUE( actual->HasEqualDimensions( &expectedBlob ) );
+
+			CArray<float> expectedData;
+			expectedData.SetSize( expectedBlob.GetDataSize() );
+			expectedBlob.CopyTo( expectedData.GetPtr() );
+			CArray<float> actualData;
+			actualData.SetSize( actual->GetDataSize() );
+			actual->CopyTo( actualData.GetPtr() );
+			for( int j = 0; j < actualData.Size(); ++j ) {
+				EXPECT_NEAR( expectedData[j], actualData[j], 1e-5 );
+			}
+		}
+	}
+}
+
+TEST( CDnnRecurrentTest, LstmWholeSequence )
+{
+	CRandom random( 0x123 );
+	for( int test = 0; test < 8; ++test ) {
+		const bool reverse = ( test & 1 ) != 0;
+		const bool hasInitialState = ( test & 2 ) != 0;
+		const bool compatibilityMode = ( test & 4 ) != 0;
+
+		CDnn dnn( random, MathEngine() );
+		CSourceLayer* data = Source( dnn, "data" );
+		data->SetBlob( createSequence( random, SequenceLength, InputSize ) );
+
+		CPtr<CLstmLayer> lstm = new CLstmLayer( MathEngine() );
+		lstm->SetName( "lstm" );
+		lstm->SetHiddenSize( HiddenSize );
+		lstm->SetReverseSequence( reverse );
+		lstm->SetCompatibilityMode( compatibilityMode );
+		lstm->Connect( 0, *data );
+		if( hasInitialState ) {
+			CSourceLayer* state = Source( dnn, "state" );
+			state->SetBlob( createSequence( random, 1, HiddenSize ) );
+			CSourceLayer* history = Source( dnn, "history" );
+			history->SetBlob( createSequence( random, 1, HiddenSize ) );
+			lstm->Connect( 1, *state );
+			lstm->Connect( 2, *history );
+		}
+		dnn.AddLayer( *lstm );
+		Sink( CDnnLayerLink( lstm.Ptr(), 0 ), "hiddenSink" );
+		Sink( CDnnLayerLink( lstm.Ptr(), 1 ), "stateSink" );
+
+		CArray<const char*> sinks;
+		sinks.Add( "hiddenSink" );
+		sinks.Add( "stateSink" );
+		checkWholeSequence( dnn, sinks );
+	}
+}
+
+TEST( CDnnRecurrentTest, GruWholeSequence )
+{
+	CRandom random( 0x321 );
+	for( int test = 0; test < 4; ++test ) {
+		const bool reverse = ( test & 1 ) != 0;
+		const bool hasInitialState = ( test & 2 ) != 0;
+
+		CDnn dnn( random, MathEngine() );
+		CSourceLayer* data = Source( dnn, "data" );
+		data->SetBlob( createSequence( random, SequenceLength, InputSize ) );
+
+		CPtr<CGruLayer> gru = new CGruLayer( MathEngine() );
+		gru->SetName( "gru" );
+		gru->SetHiddenSize( HiddenSize );
+		gru->SetReverseSequence( reverse );
+		gru->Connect( 0, *data );
+		if( hasInitialState ) {
+			CSourceLayer* state = Source( dnn, "state" );
+			state->SetBlob( createSequence( random, 1, HiddenSize ) );
+			gru->Connect( 1, *state );
+		}
+		dnn.AddLayer( *gru );
+		Sink( gru.Ptr(), "hiddenSink" );
+
+		CArray<const char*> sinks;
+		sinks.Add( "hiddenSink" );
+		checkWholeSequence( dnn, sinks );
+	}
+}
+
+// The split weights used for the whole sequence are recalculated when the weights are changed
+TEST( CDnnRecurrentTest, GruWholeSequenceWeightsChange )
+{
+	CRandom random( 0x432 );
+	CDnn dnn( random, MathEngine() );
+	CSourceLayer* data = Source( dnn, "data" );
+	data->SetBlob( createSequence( random, SequenceLength, InputSize ) );
+
+	CPtr<CGruLayer> gru = new CGruLayer( MathEngine() );
+	gru->SetName( "gru" );
+	gru->SetHiddenSize( HiddenSize );
+	gru->Connect( 0, *data );
+	dnn.AddLayer( *gru );
+	CSinkLayer* sink = Sink( gru.Ptr(), "hiddenSink" );
+	dnn.RunOnce();
+
+	CPtr<CDnnBlob> mainWeights = gru->GetMainWeightsData();
+	mainWeights->Fill( 0.1f );
+	gru->SetMainWeightsData( mainWeights );
+	CPtr<CDnnBlob> gateWeights = gru->GetGateWeightsData();
+	gateWeights->Fill( -0.2f );
+	gru->SetGateWeightsData( gateWeights );
+
+	dnn.RestartSequence();
+	dnn.RunOnce();
+	CPtr<CDnnBlob> actual = sink->GetBlob()->GetCopy();
+	dnn.RestartSequence();
+	dnn.RunAndBackwardOnce();
+	CPtr<CDnnBlob> expected = sink->GetBlob();
+
+	CArray<float> expectedData;
+	expectedData.SetSize( expected->GetDataSize() );
+	expected->CopyTo( expectedData.GetPtr() );
+	CArray<float> actualData;
+	actualData.SetSize( actual->GetDataSize() );
+	actual->CopyTo( actualData.GetPtr() );
+	ASSERT_EQ( expectedData.Size(), actualData.Size() );
+	for( int i = 0; i < actualData.Size(); ++i ) {
+		EXPECT_NEAR( expectedData[i], actualData[i], 1e-5 );
+	}
+}
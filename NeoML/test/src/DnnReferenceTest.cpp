@@ -0,0 +1,192 @@
+/* Copyright © 2017-2021 ABBYY Production LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+--------------------------------------------------------------------------------------------------------------*/
+
+#include <common.h>
+#pragma hdrstop
+
+#include <TestFixture.h>
+#include <thread>
+
+using namespace NeoML;
+using namespace NeoMLTest;
+
+static const int ReferenceCount = 4;
+static const int RunCount = 10;
+
+static CPtr<CDnnBlob> createInput( CRandom& random )
+{
+	CPtr<CDnnBlob> blob = CDnnBlob::Create2DImageBlob( MathEngine(), CT_Float, 1, 2, 8, 8, 3 );
+	CArray<float> data;
+	data.SetSize( blob->GetDataSize() );
+	for( int i = 0; i < data.Size(); ++i ) {
+		data[i] = static_cast<float>( random.Uniform( -1, 1 ) );
+	}
+	blob->CopyFrom( data.GetPtr() );
+	return blob;
+}
+
+static void getOutput( CDnn& dnn, const char* sinkName, CArray<float>& output )
+{
+	CPtr<CDnnBlob> blob = CheckCast<CSinkLayer>( dnn.GetLayer( sinkName ) )->GetBlob();
+	output.SetSize( blob->GetDataSize() );
+	blob->CopyTo( output.GetPtr() );
+}
+
+// source -> conv -> batchNorm -> relu -> fc -> sink
+//                                          \-> lstm -> lstmSink
+static void buildNetwork( CDnn& dnn )
+{
+	CSourceLayer* source = Source( dnn, "source" );
+	CPtr<CBaseLayer> conv = Conv( 4, CConvAxisParams( 3, 1 ), CConvAxisParams( 3, 1 ) )( "conv", source );
+	CPtr<CBaseLayer> batchNorm = BatchNormalization( true )( "batchNorm", conv.Ptr() );
+	CPtr<CBaseLayer> relu = Relu()( "relu", batchNorm.Ptr() );
+	CPtr<CBaseLayer> fc = FullyConnected( 6 )( "fc", relu.Ptr() );
+	Sink( fc.Ptr(), "sink" );
+	CPtr<CBaseLayer> lstm = Lstm( 5, 0.f )( "lstm", fc.Ptr() );
+	Sink( lstm.Ptr(), "lstmSink" );
+}
+
+static void checkOutput( const CArray<float>& expected, const CArray<float>& actual )
+{
+	ASSERT_EQ( expected.Size(), actual.Size() );
+	for( int i = 0; i < actual.Size(); ++i ) {
+		EXPECT_NEAR( expected[i], actual[i], 1e-5 );
+	}
+}
+
+TEST( CDnnReferenceTest, ConcurrentRun )
+{
+	CRandom random( 0x5678 );
+	CDnn dnn( random, MathEngine() );
+	buildNetwork( dnn );
+	CSourceLayer* source = CheckCast<CSourceLayer>( dnn.GetLayer( "source" ) );
+
+	CPtr<CDnnBlob> inputs[ReferenceCount];
+	CArray<float> expected[ReferenceCount];
+	CArray<float> expectedLstm[ReferenceCount];
+	for( int i = 0; i < ReferenceCount; ++i ) {
+		inputs[i] = createInput( random );
+		source->SetBlob( inputs[i] );
+		dnn.RunOnce();
+		getOutput( dnn, "sink", expected[i] );
+		getOutput( dnn, "lstmSink", expectedLstm[i] );
+	}
+
+	CPtr<CDnnReference> references[ReferenceCount];
+	for( int i = 0; i < ReferenceCount; ++i ) {
+		references[i] = dnn.CreateReference();
+		CheckCast<CSourceLayer>( references[i]->Dnn().GetLayer( "source" ) )->SetBlob( inputs[i] );
+	}
+
+	CArray<float> actual[ReferenceCount];
+	CArray<float> actualLstm[ReferenceCount];
+	std::vector<std::thread> threads;
+	for( int i = 0; i < ReferenceCount; ++i ) {
+		threads.emplace_back( [&, i]() {
+			CDnn& referenceDnn = references[i]->Dnn();
+			for( int run = 0; run < RunCount; ++run ) {
+				referenceDnn.RunOnce();
+			}
+			getOutput( referenceDnn, "sink", actual[i] );
+			getOutput( referenceDnn, "lstmSink", actualLstm[i] );
+		} );
+	}
+	for( std::thread& thread : threads ) {
+		thread.join();
+	}
+
+	for( int i = 0; i < ReferenceCount; ++i ) {
+		checkOutput( expected[i], actual[i] );
+		checkOutput( expectedLstm[i], actualLstm[i] );
+	}
+}
+
+TEST( CDnnReferenceTest, SharedParams )
+{
+	CRandom random( 0x8765 );
+	CDnn dnn( random, MathEngine() );
+	buildNetwork( dnn );
+	CSourceLayer* source = CheckCast<CSourceLayer>( dnn.GetLayer( "source" ) );
+	source->SetBlob( createInput( random ) );
+	dnn.RunOnce();
+
+	CPtr<CDnnReference> reference = dnn.CreateReference();
+	CheckCast<CSourceLayer>( reference->Dnn().GetLayer( "source" ) )->SetBlob( source->GetBlob() );
+
+	// The weights are changed in place, so the reference sees the new values
+	CPtr<CFullyConnectedLayer> fc = CheckCast<CFullyConnectedLayer>( dnn.GetLayer( "fc" ) );
+	CPtr<CDnnBlob> weights = fc->GetWeightsData();
+	weights->Fill( 0.5f );
+	fc->SetWeightsData( weights );
+
+	dnn.RunOnce();
+	reference->Dnn().RunOnce();
+
+	CArray<float> expected;
+	CArray<float> actual;
+	getOutput( dnn, "sink", expected );
+	getOutput( reference->Dnn(), "sink", actual );
+	checkOutput( expected, actual );
+	getOutput( dnn, "lstmSink", expected );
+	getOutput( reference->Dnn(), "lstmSink", actual );
+	checkOutput( expected, actual );
+}
+
+TEST( CDnnReferenceTest, LookupParams )
+{
+	const int vectorCount = 10;
+	CRandom random( 0x4321 );
+	CDnn dnn( random, MathEngine() );
+	// source -> lookup -> fc -> sink
+	CSourceLayer* source = Source( dnn, "source" );
+	CPtr<CMultichannelLookupLayer> lookup = new CMultichannelLookupLayer( MathEngine() );
+	lookup->SetName( "lookup" );
+	CArray<CLookupDimension> dimensions = { { vectorCount, 4 }, { vectorCount, 3 } };
+	lookup->SetDimensions( dimensions );
+	lookup->Connect( *source );
+	dnn.AddLayer( *lookup );
+	CPtr<CBaseLayer> fc = FullyConnected( 5 )( "fc", lookup.Ptr() );
+	Sink( fc.Ptr(), "sink" );
+
+	CPtr<CDnnBlob> input = CDnnBlob::CreateDataBlob( MathEngine(), CT_Int, 1, 6, dimensions.Size() );
+	CArray<int> indices;
+	indices.SetSize( input->GetDataSize() );
+	for( int i = 0; i < indices.Size(); ++i ) {
+		indices[i] = random.UniformInt( 0, vectorCount - 1 );
+	}
+	input->CopyFrom( indices.GetPtr() );
+	source->SetBlob( input );
+	dnn.RunOnce();
+	CArray<float> expected;
+	getOutput( dnn, "sink", expected );
+
+	CPtr<CDnnReference> reference = dnn.CreateReference();
+	CheckCast<CSourceLayer>( reference->Dnn().GetLayer( "source" ) )->SetBlob( input );
+	reference->Dnn().RunOnce();
+	CArray<float> actual;
+	getOutput( reference->Dnn(), "sink", actual );
+	checkOutput( expected, actual );
+
+	// The embeddings are shared, not copied
+	CPtr<CMultichannelLookupLayer> referenceLookup =
+		CheckCast<CMultichannelLookupLayer>( reference->Dnn().GetLayer( "lookup" ) );
+	for( int i = 0; i < dimensions.Size(); ++i ) {
+		EXPECT_EQ( lookup->GetEmbeddings( i ), referenceLookup->GetEmbeddings( i ) );
+	}
+	// The original network keeps its parameters
+	dnn.RunOnce();
+	getOutput( dnn, "sink", actual );
+	checkOutput( expected, actual );
+}
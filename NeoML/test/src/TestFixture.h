@@ -179,6 +179,63 @@ CPtr<T> AddLayer( const CString& layerName, const CArray<CBaseLayer*>& input )
 
 //------------------------------------------------------------------------------------------------------------
 
+// The file in memory used to check the serialization without writing to the disk
+class CMemoryTestFile : public CBaseFile {
+public:
+	CMemoryTestFile() : pos( 0 ) {}
+
+#ifdef FINEOBJ_VERSION
+	CUnicodeString GetFileName() const override { return CUnicodeString( L"Memory" ); }
+#else
+	const char* GetFileName() const override { return "Memory"; }
+#endif
+	int Read( void* result, int bytesCount ) override
+	{
+		const int len = min( bytesCount, buffer.Size() - pos );
+		if( len <= 0 ) {
+			return 0;
+		}
+		::memcpy( result, buffer.GetPtr() + pos, len );
+		pos += len;
+		return len;
+	}
+	void Write( const void* data, int bytesCount ) override
+	{
+		if( pos + bytesCount > buffer.Size() ) {
+			buffer.SetSize( pos + bytesCount );
+		}
+		::memcpy( buffer.GetPtr() + pos, data, bytesCount );
+		pos += bytesCount;
+	}
+	__int64 GetPosition() const override { return pos; }
+	__int64 Seek( __int64 offset, TSeekPosition from ) override
+	{
+		switch( from ) {
+			case begin:
+				pos = static_cast<int>( offset );
+				break;
+			case current:
+				pos += static_cast<int>( offset );
+				break;
+			default:
+				pos = buffer.Size() + static_cast<int>( offset );
+				break;
+		}
+		return pos;
+	}
+	void SetLength( __int64 newLength ) override { buffer.SetSize( static_cast<int>( newLength ) ); }
+	__int64 GetLength() const override { return buffer.Size(); }
+	void Abort() override {}
+	void Flush() override {}
+	void Close() override {}
+
+private:
+	CArray<char> buffer;
+	int pos;
+};
+
+//------------------------------------------------------------------------------------------------------------
+
 class CNeoMLTestFixture : public ::testing::Test {
 };
 
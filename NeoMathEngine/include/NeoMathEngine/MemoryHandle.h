@@ -84,7 +84,7 @@ public:
 	template<typename U = T, typename std::enable_if<std::is_same<U, T>::value && !std::is_const<U>::value, int>::type = 0>
 	operator CTypedMemoryHandle<const U>() const
 	{
-		return CTypedMemoryHandle<const U>( *this );
+		return CTypedMemoryHandle<const U>( static_cast<const CMemoryHandle&>( *this ) );
 	}
 
 	CTypedMemoryHandle& operator+=( ptrdiff_t shift )
@@ -217,10 +217,15 @@ typedef CTypedMemoryHandle<const float> CConstFloatHandle;
 typedef CTypedMemoryHandle<int> CIntHandle;
 typedef CTypedMemoryHandle<const int> CConstIntHandle;
 
+typedef CTypedMemoryHandle<signed char> CInt8Handle;
+typedef CTypedMemoryHandle<const signed char> CConstInt8Handle;
+
 typedef CMemoryHandleVar<float> CFloatHandleVar;
 typedef CMemoryHandleVar<int> CIntHandleVar;
+typedef CMemoryHandleVar<signed char> CInt8HandleVar;
 
 typedef CMemoryHandleStackVar<float> CFloatHandleStackVar;
 typedef CMemoryHandleStackVar<int> CIntHandleStackVar;
+typedef CMemoryHandleStackVar<signed char> CInt8HandleStackVar;
 
 } // namespace NeoML
@@ -515,6 +515,18 @@ public:
 	virtual void MatrixSpreadRows( const CConstIntHandle& sourceHandle, int height, int width,
 		const CIntHandle& resultHandle, int resultHeight, const CConstIntHandle& indexHandle,
 		const CConstIntHandle& fillValue ) = 0;
+
+	// Int8 quantization (supported only on CPU)
+	// Quantizes every row of the matrix symmetrically with its own scale:
+	// scales[i] = max_j( |matrix[i][j]| ) / 127, result[i][j] = round( matrix[i][j] / scales[i] )
+	virtual void QuantizeMatrixRowsInt8( const CConstFloatHandle& matrixHandle, int height, int width,
+		const CInt8Handle& resultHandle, const CFloatHandle& scalesHandle ) = 0;
+	// Multiplies the float matrix by the transposed int8 matrix quantized by QuantizeMatrixRowsInt8
+	// The first matrix is quantized to int8 with firstScale (if firstScale <= 0, every row is quantized with its own scale)
+	// The products are accumulated in int32 and dequantized on output
+	virtual void MultiplyMatrixByTransposedInt8Matrix( const CConstFloatHandle& firstHandle, int firstHeight,
+		int firstWidth, float firstScale, const CConstInt8Handle& secondHandle, const CConstFloatHandle& secondScalesHandle,
+		int secondHeight, const CFloatHandle& resultHandle ) = 0;
 };
 
 // Blob operations descriptors
@@ -624,6 +636,25 @@ public:
 	virtual void BlobConvolutionLearnAdd( const CConvolutionDesc& desc, const CFloatHandle& input,
 		const CFloatHandle& outputDiff, const CFloatHandle& filterDiff,
 		const CFloatHandle* freeTermDiff, bool isFreeTermDiffFromInput ) = 0;
+	// Convolution algorithm autotuning (supported only on CPU, the other engines ignore these calls)
+	// When enabled, InitBlobConvolution measures the time of every algorithm suitable for a new convolution shape
+	// and remembers the fastest one; the descriptors of the shapes measured before (or loaded from a file) use the stored choice
+	// The results depend on the processor and the number of threads, so the file should be made on the same configuration
+	// The CPU engine uses the Winograd algorithm for 3*3 convolutions only if autotuning chooses it; its result is less precise
+	virtual void SetConvolutionAutotuning( bool enable ) = 0;
+	// Saves the autotuning results to a file; returns false if the file could not be written
+	virtual bool SaveConvolutionAutotuningCache( const char* fileName ) const = 0;
+	// Adds the autotuning results from a file; returns false if the file could not be read
+	virtual bool LoadConvolutionAutotuningCache( const char* fileName ) = 0;
+	// Returns the name of the algorithm used by the descriptor for the forward pass or for the backward and learning passes
+	// The engines without autotuning return an empty string
+	virtual const char* GetConvolutionAlgorithmName( const CConvolutionDesc& desc, bool isForward ) const = 0;
+	// Int8 convolution (supported only on CPU)
+	// Every filter is quantized by QuantizeMatrixRowsInt8 with the filterScales
+	// The input is quantized with sourceScale (if sourceScale <= 0, every window of the input gets its own scale)
+	virtual void BlobConvolutionInt8( const CConvolutionDesc& desc, const CFloatHandle& source, float sourceScale,
+		const CConstInt8Handle& filter, const CConstFloatHandle& filterScales, const CFloatHandle* freeTerm,
+		const CFloatHandle& result ) = 0;
 
 	// Calculates channelwise convolution
 	// You can pass 0 for the freeTerm parameter, and the free terms will be 0
@@ -849,6 +880,42 @@ public:
 		const CConstFloatHandle& mask, const CConstFloatHandle& u, const CConstFloatHandle& h, const CConstFloatHandle& hDiff,
 		const CFloatHandle& uDiff ) = 0;
 
+	// LSTM (https://www.bioinf.jku.at/publications/older/2604.pdf), the recurrent part of the layer
+	// The input projection is calculated for the whole sequence beforehand (by a single matrix multiplication)
+	// The result is
+	//    gates_t = inputGates_t + h_(t-1) * recurWeights^T, split into [main, forget, input, output] parts of hiddenSize
+	//    c_t = sigmoid( forget_t ) * c_(t-1) + sigmoid( input_t ) * tanh( main_t )
+	//    h_t = sigmoid( output_t ) * tanh( c_t )
+	// where
+	//    inputGates - x_t processed by the input fully connected layer (with both free terms). Size: seqLen x batchSize x 4 * hiddenSize
+	//    recurWeights - the recurrent weights. Size: 4 * hiddenSize x hiddenSize
+	//    initialHidden, initialState - (optional, may be null) h_(-1) and c_(-1), zeros by default. Size: batchSize x hiddenSize
+	//    hidden, state - h_t and c_t for every step. Size: seqLen x batchSize x hiddenSize
+	// Inference only
+	virtual void LstmRecurrent( bool reverse, int sequenceLength, int batchSize, int hiddenSize,
+		const CConstFloatHandle& inputGates, const CConstFloatHandle& recurWeights,
+		const CConstFloatHandle& initialHidden, const CConstFloatHandle& initialState,
+		const CFloatHandle& hidden, const CFloatHandle& state ) = 0;
+
+	// GRU (https://arxiv.org/pdf/1406.1078.pdf), the recurrent part of the layer
+	// The input projections are calculated for the whole sequence beforehand
+	// The result is
+	//    gates_t = sigmoid( inputGates_t + h_(t-1) * gateWeights^T ), split into [update, reset] parts of hiddenSize
+	//    main_t = tanh( inputMain_t + ( reset_t * h_(t-1) ) * mainWeights^T )
+	//    h_t = ( 1 - update_t ) * main_t + update_t * h_(t-1)
+	// where
+	//    inputGates - x_t processed by the input part of the gates layer (with the free term). Size: seqLen x batchSize x 2 * hiddenSize
+	//    inputMain - x_t processed by the input part of the main layer (with the free term). Size: seqLen x batchSize x hiddenSize
+	//    gateWeights - the recurrent part of the gates layer weights. Size: 2 * hiddenSize x hiddenSize
+	//    mainWeights - the recurrent part of the main layer weights. Size: hiddenSize x hiddenSize
+	//    initialHidden - (optional, may be null) h_(-1), zeros by default. Size: batchSize x hiddenSize
+	//    hidden - h_t for every step. Size: seqLen x batchSize x hiddenSize
+	// Inference only
+	virtual void GruRecurrent( bool reverse, int sequenceLength, int batchSize, int hiddenSize,
+		const CConstFloatHandle& inputGates, const CConstFloatHandle& inputMain,
+		const CConstFloatHandle& gateWeights, const CConstFloatHandle& mainWeights,
+		const CConstFloatHandle& initialHidden, const CFloatHandle& hidden ) = 0;
+
 	// Local responce normalization (Lrn)
 	// For more details see CLrnLayer comments
 	virtual CLrnDesc* InitLrn( const CBlobDesc& source, int windowSize, float bias, float alpha, float beta ) = 0;
@@ -860,6 +927,19 @@ public:
 	virtual void LrnBackward( const CLrnDesc& desc, const CConstFloatHandle& input, const CConstFloatHandle& output,
 		const CConstFloatHandle& outputDiff, const CConstFloatHandle& invSum, const CConstFloatHandle& invSumBeta,
 		const CFloatHandle& inputDiff ) = 0;
+
+	// Multihead attention (https://arxiv.org/pdf/1706.03762.pdf)
+	// Calculates softmax( Q_i * K_i^T * multiplier + mask ) * V_i for every head i of every object
+	// without storing the whole [batchSize x headCount x seqQ x seqK] attention matrix
+	// The heads are stored interleaved in the rows: row = concat( head_0, ..., head_(headCount-1) )
+	//    q - [batchSize x seqQ x headCount * headSize]
+	//    k, v - [batchSize x seqK x headCount * headSize]
+	//    mask - (optional, may be null) [seqQ x seqK], added to the scaled Q_i * K_i^T of every head and object
+	//    result - [batchSize x seqQ x headCount * headSize]
+	// Inference only
+	virtual void MultiheadAttention( int batchSize, int headCount, int headSize, int seqQ, int seqK, float multiplier,
+		const CConstFloatHandle& q, const CConstFloatHandle& k, const CConstFloatHandle& v,
+		const CConstFloatHandle& mask, const CFloatHandle& result ) = 0;
 };
 
 //------------------------------------------------------------------------------------------------------------
@@ -888,6 +968,31 @@ struct CMathEngineInfo {
 	CMathEngineInfo( TMathEngineType type, size_t availableMemory, int id ) : Type( type ), AvailableMemory( availableMemory ), Id( id ) { Name[0] = 0; }
 };
 
+// The memory manager statistics, aggregated over all threads that have used the math engine
+// Used to check that the allocations scale with the number of threads
+struct CMemoryPoolStatistics {
+	size_t ThreadCount; // the number of threads with their own pools
+	size_t PoolAllocations; // the allocations served by the thread's own pools
+	size_t DeviceAllocations; // the allocations that had to request memory from the device
+	size_t LocalFrees; // the blocks freed by the thread that allocated them
+	size_t CrossThreadFrees; // the blocks freed by another thread (slow path)
+	size_t LockContentions; // the number of times a thread had to wait for a lock held by another thread
+
+	CMemoryPoolStatistics() : ThreadCount( 0 ), PoolAllocations( 0 ), DeviceAllocations( 0 ), LocalFrees( 0 ),
+		CrossThreadFrees( 0 ), LockContentions( 0 ) {}
+};
+
+// The sizes of the processor caches used by the CPU math engine to split the matrix multiplication
+// and the convolution into blocks; the zero size means the size is not set
+struct CCpuCacheSizes {
+	size_t L1; // the level 1 data cache of one core
+	size_t L2; // the level 2 cache of one core
+	size_t L3; // the level 3 cache
+
+	CCpuCacheSizes() : L1( 0 ), L2( 0 ), L3( 0 ) {}
+	CCpuCacheSizes( size_t l1, size_t l2, size_t l3 ) : L1( l1 ), L2( l2 ), L3( l3 ) {}
+};
+
 // CMathEngine class implements an engine to perform calculations on data specified by CMemoryHandle (CFloatHandle)
 class NEOMATHENGINE_API IMathEngine : public IDnnEngine {
 public:
@@ -925,6 +1030,16 @@ public:
 	// The current size of memory in the pools
 	virtual size_t GetMemoryInPools() const = 0;
 
+	// Gets the memory manager statistics
+	virtual void GetMemoryPoolStatistics( CMemoryPoolStatistics& statistics ) const = 0;
+
+	// The cache sizes used to choose the block sizes of the calculations (supported only on CPU, the other engines return zero sizes)
+	// By default they are detected when the engine is created and adjusted for the known processor models
+	// SetCpuCacheSizes overrides them for this engine; the zero sizes are replaced by the default ones
+	// Should not be called while the engine is used by another thread
+	virtual void SetCpuCacheSizes( const CCpuCacheSizes& sizes ) = 0;
+	virtual void GetCpuCacheSizes( CCpuCacheSizes& sizes ) const = 0;
+
 	// Releases all temporary resources allocated for the current thread
 	virtual void CleanUp() = 0;
 
@@ -27,6 +27,11 @@ typedef void ( *SgemmFunc )( bool transA, bool transB,
 	float* cPtr, size_t cRowSize,
 	size_t m, size_t n, size_t k );
 
+// Multiplies the quantized row by the transposed quantized matrix: result[j] = ( row, matrix[j] ) * rowScale * scales[j]
+// The quantized values must be in [-127, 127]
+typedef void ( *Int8RowByTransposedMatrixFunc )( const signed char* row, const signed char* matrix,
+	int height, int width, float rowScale, const float* scales, float* result );
+
 class ISimdMathEngine : public CCrtAllocatedObject {
 public:
 	virtual ~ISimdMathEngine() = default;
@@ -41,6 +46,9 @@ public:
 		const float* filter, const float* freeTerm, float* result ) const = 0;
 
 	virtual SgemmFunc GetSgemmFunction() const = 0;
+
+	// Returns nullptr if the processor doesn't support the required instructions
+	virtual Int8RowByTransposedMatrixFunc GetInt8RowByTransposedMatrixFunction() const = 0;
 };
 
 }
@@ -57,27 +57,43 @@ struct CCPUInfo {
 		switch( GetCpuArch() ) {
 		case TCpuArch::Intel:
 		{
-			// Get cache size
-			auto calcCacheSize = [&]( int cacheNumber ) -> int {
-				// Cache Size in Bytes
-				// = (Ways + 1) * (Partitions + 1) * (Line_Size + 1) * (Sets + 1)
-				// = (EBX[31:22] + 1) * (EBX[21:12] + 1) * (EBX[11:0] + 1) * (ECX + 1)
-
-				// Get Ways, Partitions, Line_size and Sets
-				callCpuIdEx( regs, 4, cacheNumber );
-				int ways = ( regs.ebx >> 22 ) & 0x3ff; // EBX[31:22]
-				int partitions = ( regs.ebx >> 12 ) &0x3ff; // EBX[21:12]
-				int lineSize = regs.ebx & 0xfff; // EBX[11:0]
-				int sets = regs.ecx;
-
-				// Get cache size
-				callCpuIdEx( regs, 4, 1 );
-				return  ( ways + 1 ) * ( partitions + 1 ) * ( lineSize + 1 ) * (sets + 1 );
-			};
-
-			cpuInfo.L1CacheSize = calcCacheSize( 1 );
-			cpuInfo.L2CacheSize = calcCacheSize( 2 );
-			cpuInfo.L3CacheSize = calcCacheSize( 3 );
+			callCpuId( regs, 0 );
+			if( regs.eax < 4 ) {
+				// Deterministic cache parameters are not supported
+				break;
+			}
+			// Every subleaf of the leaf 4 describes one cache, the list ends with the cache of the zero type
+			// Cache Size in Bytes
+			// = (Ways + 1) * (Partitions + 1) * (Line_Size + 1) * (Sets + 1)
+			// = (EBX[31:22] + 1) * (EBX[21:12] + 1) * (EBX[11:0] + 1) * (ECX + 1)
+			for( int subleaf = 0; subleaf < MaxCacheCount; ++subleaf ) {
+				callCpuIdEx( regs, 4, static_cast<RegType>( subleaf ) );
+				const int type = regs.eax & 0x1f; // EAX[4:0]: 0 - no more caches, 1 - data, 2 - instruction, 3 - unified
+				if( type == 0 ) {
+					break;
+				}
+				if( type == 2 ) {
+					continue;
+				}
+				const size_t ways = ( regs.ebx >> 22 ) & 0x3ff; // EBX[31:22]
+				const size_t partitions = ( regs.ebx >> 12 ) & 0x3ff; // EBX[21:12]
+				const size_t lineSize = regs.ebx & 0xfff; // EBX[11:0]
+				const size_t sets = regs.ecx;
+				const size_t cacheSize = ( ways + 1 ) * ( partitions + 1 ) * ( lineSize + 1 ) * ( sets + 1 );
+				switch( ( regs.eax >> 5 ) & 0x7 ) { // EAX[7:5] - cache level
+				case 1:
+					cpuInfo.L1CacheSize = cacheSize;
+					break;
+				case 2:
+					cpuInfo.L2CacheSize = cacheSize;
+					break;
+				case 3:
+					cpuInfo.L3CacheSize = cacheSize;
+					break;
+				default:
+					break;
+				}
+			}
 			break;
 		}
 		case TCpuArch::AMD:
@@ -99,6 +115,17 @@ struct CCPUInfo {
 		return cpuInfo;
 	}
 
+	// Gets the family and the model of the processor as they are numbered in the manufacturer documentation
+	static void GetCpuFamilyAndModel( int& family, int& model )
+	{
+		Regs regs;
+		callCpuId( regs, 1 );
+		const int baseFamily = ( regs.eax >> 8 ) & 0xf; // EAX[11:8]
+		const int baseModel = ( regs.eax >> 4 ) & 0xf; // EAX[7:4]
+		family = baseFamily == 0xf ? baseFamily + static_cast<int>( ( regs.eax >> 20 ) & 0xff ) : baseFamily; // EAX[27:20] - extended family
+		model = ( baseFamily == 0x6 || baseFamily == 0xf ) ? baseModel + static_cast<int>( ( regs.eax >> 12 ) & 0xf0 ) : baseModel; // EAX[19:16] - extended model
+	}
+
 	static TCpuArch GetCpuArch() {
 		Regs regs;
 		callCpuId( regs, 0 );
@@ -166,11 +193,41 @@ struct CCPUInfo {
 
 		// Check avx512_f bit in EBX ( any CPU with AVX512 has this bit )
 		bool AnyAvx512IsAvailable = regs.ebx & ( 1 << 16 );
+#if FINE_PLATFORM(FINE_WINDOWS)
+		if( AnyAvx512IsAvailable ) {
+			// Check OS support (if it keeps the opmask and zmm registers when switching contexts)
+			callCpuId( regs, 1 );
+			const int OsXSaveFlag = 1 << 27;
+			const int64_t OsFlag = 0xE6;
+			AnyAvx512IsAvailable = ( regs.ecx & OsXSaveFlag ) != 0
+				&& ( _xgetbv( _XCR_XFEATURE_ENABLED_MASK ) & OsFlag ) == OsFlag;
+		}
+#endif
 
 		return AnyAvx512IsAvailable;
 	}
 
+	static bool IsAvx2Available()
+	{
+		Regs regs;
+		callCpuIdEx( regs, 7, 0 );
+
+		// Check avx2 bit in EBX
+		return ( regs.ebx & ( 1 << 5 ) ) != 0;
+	}
+
+	static bool IsAvxVnniAvailable()
+	{
+		Regs regs;
+		callCpuIdEx( regs, 7, 1 );
+
+		// Check avx_vnni bit in EAX (the 256-bit VNNI instructions with VEX encoding)
+		return ( regs.eax & ( 1 << 4 ) ) != 0;
+	}
+
 private:
+	// The maximum number of the caches described by the cpuid leaf 4
+	static const int MaxCacheCount = 16;
 
 #if FINE_PLATFORM(FINE_WINDOWS)
 	typedef int RegType;
@@ -0,0 +1,130 @@
+/* Copyright © 2017-2020 ABBYY Production LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+--------------------------------------------------------------------------------------------------------------*/
+
+#include <common.h>
+#pragma hdrstop
+
+#include <CpuConvolutionAutotuneCache.h>
+#include <NeoMathEngine/NeoMathEngineException.h>
+#include <fstream>
+#include <string>
+#include <cstring>
+
+namespace NeoML {
+
+// The first line of the cache file
+static const char* const AutotuneCacheHeader = "NeoMathEngineConvolutionAutotune";
+static const int AutotuneCacheVersion = 1;
+
+static const char* const ConvAlgoNames[CA_Count] = { "auto", "gemm", "gemm-direct", "1x1", "winograd", "simd" };
+
+const char* GetConvAlgoName( TConvAlgo algo )
+{
+	PRESUME_EXPR( 0 <= algo && algo < CA_Count );
+	return ConvAlgoNames[algo];
+}
+
+TConvAlgo GetConvAlgoByName( const char* name )
+{
+	for( int algo = 0; algo < CA_Count; ++algo ) {
+		if( ::strcmp( ConvAlgoNames[algo], name ) == 0 ) {
+			return static_cast<TConvAlgo>( algo );
+		}
+	}
+	return CA_Count;
+}
+
+bool CCpuConvolutionAutotuneCache::Find( const TKey& key, CResult& result ) const
+{
+	std::lock_guard<std::mutex> lock( mutex );
+	auto it = results.find( key );
+	if( it == results.end() ) {
+		return false;
+	}
+	result = it->second;
+	return true;
+}
+
+void CCpuConvolutionAutotuneCache::Add( const TKey& key, const CResult& result )
+{
+	std::lock_guard<std::mutex> lock( mutex );
+	results[key] = result;
+}
+
+bool CCpuConvolutionAutotuneCache::Save( const char* fileName ) const
+{
+	std::ofstream file( fileName );
+	if( !file ) {
+		return false;
+	}
+
+	file << AutotuneCacheHeader << ' ' << AutotuneCacheVersion << '\n';
+	std::lock_guard<std::mutex> lock( mutex );
+	for( const auto& item : results ) {
+		for( int value : item.first ) {
+			file << value << ' ';
+		}
+		file << GetConvAlgoName( item.second.ForwardAlgo ) << ' ' << GetConvAlgoName( item.second.BackwardAlgo ) << '\n';
+	}
+	file.flush();
+	return static_cast<bool>( file );
+}
+
+bool CCpuConvolutionAutotuneCache::Load( const char* fileName )
+{
+	std::ifstream file( fileName );
+	if( !file ) {
+		return false;
+	}
+
+	std::string header;
+	int version = 0;
+	if( !( file >> header >> version ) || header != AutotuneCacheHeader || version != AutotuneCacheVersion ) {
+		return false;
+	}
+
+	std::map<TKey, CResult> loaded;
+	TKey key;
+	while( file >> key[0] ) {
+		for( int i = 1; i < KeySize; ++i ) {
+			if( !( file >> key[i] ) ) {
+				return false;
+			}
+		}
+		std::string forwardName;
+		std::string backwardName;
+		if( !( file >> forwardName >> backwardName ) ) {
+			return false;
+		}
+		CResult result;
+		result.ForwardAlgo = GetConvAlgoByName( forwardName.c_str() );
+		result.BackwardAlgo = GetConvAlgoByName( backwardName.c_str() );
+		if( result.ForwardAlgo == CA_Count || result.BackwardAlgo == CA_Count ) {
+			return false;
+		}
+		loaded[key] = result;
+	}
+	if( !file.eof() ) {
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock( mutex );
+	for( const auto& item : loaded ) {
+		results[item.first] = item.second;
+	}
+	return true;
+}
+
+} // namespace NeoML
@@ -0,0 +1,85 @@
+/* Copyright © 2017-2020 ABBYY Production LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+--------------------------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <NeoMathEngine/CrtAllocatedObject.h>
+#include <NeoMathEngine/BlobDesc.h>
+#include <array>
+#include <map>
+#include <mutex>
+#include <atomic>
+
+namespace NeoML {
+
+// The algorithm used to calculate a 2D convolution
+enum TConvAlgo {
+	CA_Auto,	// choose automatically
+	CA_1,		// use a temporary matrix to store the data in another order
+	CA_2,		// work with the data directly (only for stride = 1 and padding = 0)
+				// most efficient when the image is large and especially when it has many channels
+				
+	CA_1x1,		// for convolution with a 1*1 filter, no padding and dilation (both 2D and 3D)
+	CA_Winograd,	// Winograd minimal filtering (only for 3*3 filter with stride = 1 and no dilation)
+				// most efficient when there are many input and output channels
+				// it is less precise than the others, so it is used only if chosen by autotuning
+	CA_Simd,	// the implementation of ISimdMathEngine (only for forward pass)
+
+	CA_Count
+};
+
+// The name of the algorithm used in the autotuning cache file and in GetConvolutionAlgorithmName
+const char* GetConvAlgoName( TConvAlgo algo );
+// Gets the algorithm by its name; returns CA_Count if the name is unknown
+TConvAlgo GetConvAlgoByName( const char* name );
+
+// The convolution algorithms chosen by autotuning for every convolution shape
+// The methods may be called from several threads simultaneously
+class CCpuConvolutionAutotuneCache : public CCrtAllocatedObject {
+public:
+	// The key consists of the source and filter dimensions, paddings, strides, dilations and the number of threads
+	static const int KeySize = 2 * BD_Count + 7;
+	typedef std::array<int, KeySize> TKey;
+
+	// The chosen algorithms
+	struct CResult {
+		TConvAlgo ForwardAlgo;
+		TConvAlgo BackwardAlgo;
+	};
+
+	CCpuConvolutionAutotuneCache() : isEnabled( false ) {}
+
+	// Turns on and off the benchmarking of the new shapes
+	void Enable( bool enable ) { isEnabled = enable; }
+	bool IsEnabled() const { return isEnabled; }
+
+	// Finds the algorithms for the shape; returns false if the shape hasn't been tuned yet
+	bool Find( const TKey& key, CResult& result ) const;
+	// Stores the algorithms for the shape
+	void Add( const TKey& key, const CResult& result );
+
+	// Saves the cache into a text file; returns false if the file could not be written
+	bool Save( const char* fileName ) const;
+	// Adds the results from the file to the cache; returns false if the file could not be read or has a wrong format
+	// In the latter case the cache is not changed
+	bool Load( const char* fileName );
+
+private:
+	std::atomic<bool> isEnabled;
+	mutable std::mutex mutex;
+	std::map<TKey, CResult> results;
+};
+
+} // namespace NeoML
@@ -48,6 +48,77 @@ namespace NeoML {
 static int FloatAlignment = CCPUInfo::DefineFloatAlignment();
 static CCPUInfo::TCpuArch CPUArch = CCPUInfo::GetCpuArch();
 
+// The cache sizes used if they could not be detected
+#if FINE_ARCHITECTURE( FINE_ARM64 ) || FINE_ARCHITECTURE( FINE_ARM )
+// There is no way to find out the cache size for ARM
+// These constants helped speed up performance of some of the testing devices
+static const CCpuCacheSizes FallbackCacheSizes( 0x8000, 0x20000, 0 );
+#else
+static const CCpuCacheSizes FallbackCacheSizes( 0x60000, 0x180000, 0x900000 );
+#endif
+
+// The share of the detected caches that should be used for the blocks on the known processor models
+// The micro-blocks of A and B share L1 with the result micro-block, and the B block shares L2 with the A micro-blocks
+// and the prefetched data, so filling the whole cache leads to evictions
+// The values may be refined using the block size sweep in CMatrixMultiplyingBlockSizesTest
+struct CCacheSizesTuning {
+	CCPUInfo::TCpuArch Arch;
+	int Family;
+	int FirstModel;
+	int LastModel;
+	int L1Percent;
+	int L2Percent;
+};
+
+static const CCacheSizesTuning CacheSizesTuningTable[] = {
+	// Intel Haswell, Broadwell, Skylake, Kaby Lake, Coffee Lake: 32 KB L1, 256 KB inclusive L2
+	{ CCPUInfo::TCpuArch::Intel, 0x6, 0x3c, 0x3c, 75, 75 },
+	{ CCPUInfo::TCpuArch::Intel, 0x6, 0x3d, 0x3d, 75, 75 },
+	{ CCPUInfo::TCpuArch::Intel, 0x6, 0x3f, 0x3f, 75, 75 },
+	{ CCPUInfo::TCpuArch::Intel, 0x6, 0x45, 0x47, 75, 75 },
+	{ CCPUInfo::TCpuArch::Intel, 0x6, 0x4e, 0x4f, 75, 75 },
+	{ CCPUInfo::TCpuArch::Intel, 0x6, 0x56, 0x56, 75, 75 },
+	{ CCPUInfo::TCpuArch::Intel, 0x6, 0x5e, 0x5e, 75, 75 },
+	{ CCPUInfo::TCpuArch::Intel, 0x6, 0x8e, 0x8e, 75, 75 },
+	{ CCPUInfo::TCpuArch::Intel, 0x6, 0x9e, 0x9e, 75, 75 },
+	// Intel Xeon Skylake-SP, Cascade Lake, Ice Lake-SP, Sapphire Rapids, Emerald Rapids: 1-2 MB non-inclusive L2
+	{ CCPUInfo::TCpuArch::Intel, 0x6, 0x55, 0x55, 75, 50 },
+	{ CCPUInfo::TCpuArch::Intel, 0x6, 0x6a, 0x6a, 75, 50 },
+	{ CCPUInfo::TCpuArch::Intel, 0x6, 0x6c, 0x6c, 75, 50 },
+	{ CCPUInfo::TCpuArch::Intel, 0x6, 0x8f, 0x8f, 75, 50 },
+	{ CCPUInfo::TCpuArch::Intel, 0x6, 0xcf, 0xcf, 75, 50 },
+	// AMD Zen, Zen 2 (EPYC Naples, Rome): 32 KB L1, 512 KB L2
+	{ CCPUInfo::TCpuArch::AMD, 0x17, 0x00, 0xff, 75, 75 },
+	// AMD Zen 3, Zen 4 (EPYC Milan, Genoa): 32 KB L1, 512 KB - 1 MB L2
+	{ CCPUInfo::TCpuArch::AMD, 0x19, 0x00, 0xff, 75, 75 },
+	// AMD Zen 5 (EPYC Turin): 48 KB L1, 1 MB L2
+	{ CCPUInfo::TCpuArch::AMD, 0x1a, 0x00, 0xff, 75, 75 }
+};
+
+// Detects the cache sizes and adjusts them for the processor model
+static CCpuCacheSizes defineDefaultCacheSizes()
+{
+	const CCPUInfo cpuInfo = CCPUInfo::GetCPUInfo();
+	CCpuCacheSizes sizes( cpuInfo.L1CacheSize, cpuInfo.L2CacheSize, cpuInfo.L3CacheSize );
+	if( sizes.L1 == 0 || sizes.L2 == 0 ) {
+		return FallbackCacheSizes;
+	}
+
+	int family = 0;
+	int model = 0;
+	CCPUInfo::GetCpuFamilyAndModel( family, model );
+	for( const CCacheSizesTuning& tuning : CacheSizesTuningTable ) {
+		if( tuning.Arch == CPUArch && tuning.Family == family && tuning.FirstModel <= model && model <= tuning.LastModel ) {
+			sizes.L1 = sizes.L1 * tuning.L1Percent / 100;
+			sizes.L2 = sizes.L2 * tuning.L2Percent / 100;
+			break;
+		}
+	}
+	return sizes;
+}
+
+static const CCpuCacheSizes DefaultCacheSizes = defineDefaultCacheSizes();
+
 CCpuMathEngine::CCpuMathEngine( int _threadCount, size_t _memoryLimit ) :
 	threadCount( _threadCount <= 0 ? OmpGetMaxThreadCount() : _threadCount ),
 	floatAlignment( FloatAlignment ),
@@ -56,7 +127,9 @@ CCpuMathEngine::CCpuMathEngine( int _threadCount, size_t _memoryLimit ) :
 	stackAllocator( new CDeviceStackAllocator( *memoryPool, memoryAlignment ) ),
 	dllLoader( CDllLoader::AVX_DLL ),
 	simdMathEngine( nullptr ),
-	customSgemmFunction( nullptr )
+	customSgemmFunction( nullptr ),
+	customInt8RowByTransposedMatrixFunction( nullptr ),
+	cacheSizes( DefaultCacheSizes )
 {
 #ifdef NEOML_USE_AVX
 	if( dllLoader.IsLoaded( CDllLoader::AVX_DLL ) ) {
@@ -70,6 +143,7 @@ CCpuMathEngine::CCpuMathEngine( int _threadCount, size_t _memoryLimit ) :
 			// Non Intel architectures
 			customSgemmFunction = simdMathEngine->GetSgemmFunction();
 		}
+		customInt8RowByTransposedMatrixFunction = simdMathEngine->GetInt8RowByTransposedMatrixFunction();
 	}
 #endif
 }
@@ -81,13 +155,11 @@ CCpuMathEngine::~CCpuMathEngine()
 
 void CCpuMathEngine::SetReuseMemoryMode( bool enable )
 {
-	std::lock_guard<std::mutex> lock( mutex );
 	memoryPool->SetReuseMemoryMode( enable );
 }
 
 CMemoryHandle CCpuMathEngine::HeapAlloc( size_t size )
 {
-	std::lock_guard<std::mutex> lock( mutex );
 	CMemoryHandle result = memoryPool->Alloc( size );
 	if( result.IsNull() ) {
 		THROW_MEMORY_EXCEPTION;
@@ -98,14 +170,11 @@ CMemoryHandle CCpuMathEngine::HeapAlloc( size_t size )
 void CCpuMathEngine::HeapFree( const CMemoryHandle& handle )
 {
 	ASSERT_EXPR( handle.GetMathEngine() == this );
-
-	std::lock_guard<std::mutex> lock( mutex );
 	memoryPool->Free( handle );
 }
 
 CMemoryHandle CCpuMathEngine::StackAlloc( size_t size )
 {
-	std::lock_guard<std::mutex> lock( mutex );
 	CMemoryHandle result = stackAllocator->Alloc(size);
 	if( result.IsNull() ) {
 		THROW_MEMORY_EXCEPTION;
@@ -115,31 +184,43 @@ CMemoryHandle CCpuMathEngine::StackAlloc( size_t size )
 
 void CCpuMathEngine::StackFree( const CMemoryHandle& ptr )
 {
-	std::lock_guard<std::mutex> lock( mutex );
 	stackAllocator->Free( ptr );
 }
 
 size_t CCpuMathEngine::GetFreeMemorySize() const
 {
-	std::lock_guard<std::mutex> lock( mutex );
 	return memoryPool->GetFreeMemorySize();
 }
 
 size_t CCpuMathEngine::GetPeakMemoryUsage() const
 {
-	std::lock_guard<std::mutex> lock( mutex );
 	return memoryPool->GetPeakMemoryUsage();
 }
 
 size_t CCpuMathEngine::GetMemoryInPools() const
 {
-	std::lock_guard<std::mutex> lock( mutex );
 	return memoryPool->GetMemoryInPools();
 }
 
+void CCpuMathEngine::GetMemoryPoolStatistics( CMemoryPoolStatistics& statistics ) const
+{
+	memoryPool->GetStatistics( statistics );
+}
+
+void CCpuMathEngine::SetCpuCacheSizes( const CCpuCacheSizes& sizes )
+{
+	cacheSizes.L1 = sizes.L1 != 0 ? sizes.L1 : DefaultCacheSizes.L1;
+	cacheSizes.L2 = sizes.L2 != 0 ? sizes.L2 : DefaultCacheSizes.L2;
+	cacheSizes.L3 = sizes.L3 != 0 ? sizes.L3 : DefaultCacheSizes.L3;
+}
+
+void CCpuMathEngine::GetCpuCacheSizes( CCpuCacheSizes& sizes ) const
+{
+	sizes = cacheSizes;
+}
+
 void CCpuMathEngine::CleanUp()
 {
-	std::lock_guard<std::mutex> lock( mutex );
 	stackAllocator->CleanUp();
 	memoryPool->CleanUp();
 #ifdef NEOML_USE_MKL
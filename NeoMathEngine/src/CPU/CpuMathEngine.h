@@ -19,7 +19,7 @@ limitations under the License.
 #include <NeoMathEngine/SimdMathEngine.h>
 #include <RawMemoryManager.h>
 #include <DllLoader.h>
-#include <mutex>
+#include <CpuConvolutionAutotuneCache.h>
 #include <memory>
 
 namespace NeoML {
@@ -48,6 +48,9 @@ public:
 	size_t GetFreeMemorySize() const override;
 	size_t GetPeakMemoryUsage() const override;
 	size_t GetMemoryInPools() const override;
+	void GetMemoryPoolStatistics( CMemoryPoolStatistics& statistics ) const override;
+	void SetCpuCacheSizes( const CCpuCacheSizes& sizes ) override;
+	void GetCpuCacheSizes( CCpuCacheSizes& sizes ) const override;
 	void CleanUp() override;
 	void* GetBuffer( const CMemoryHandle& handle, size_t pos, size_t size, bool exchange ) override;
 	void ReleaseBuffer( const CMemoryHandle& handle, void* ptr, bool exchange ) override;
@@ -342,6 +345,11 @@ public:
 	void MatrixSpreadRows(const CConstIntHandle& sourceHandle, int height, int width,
 		const CIntHandle& resultHandle, int resultHeight, const CConstIntHandle& indexHandle,
 		const CConstIntHandle& fillValue) override;
+	void QuantizeMatrixRowsInt8( const CConstFloatHandle& matrixHandle, int height, int width,
+		const CInt8Handle& resultHandle, const CFloatHandle& scalesHandle ) override;
+	void MultiplyMatrixByTransposedInt8Matrix( const CConstFloatHandle& firstHandle, int firstHeight,
+		int firstWidth, float firstScale, const CConstInt8Handle& secondHandle, const CConstFloatHandle& secondScalesHandle,
+		int secondHeight, const CFloatHandle& resultHandle ) override;
 
 	// IDnnEngine interface methods
 	void BlobMergeByDim(TBlobDim dim, const CBlobDesc* from, const CFloatHandle* fromData, int fromCount,
@@ -384,6 +392,13 @@ public:
 	void BlobConvolutionLearnAdd( const CConvolutionDesc& desc,
 	 const CFloatHandle& input, const CFloatHandle& outputDiff, const CFloatHandle& filterDiff,
 		const CFloatHandle* freeTermDiff, bool isFreeTermDiffFromInput ) override;
+	void SetConvolutionAutotuning( bool enable ) override;
+	bool SaveConvolutionAutotuningCache( const char* fileName ) const override;
+	bool LoadConvolutionAutotuningCache( const char* fileName ) override;
+	const char* GetConvolutionAlgorithmName( const CConvolutionDesc& desc, bool isForward ) const override;
+	void BlobConvolutionInt8( const CConvolutionDesc& desc, const CFloatHandle& source, float sourceScale,
+		const CConstInt8Handle& filter, const CConstFloatHandle& filterScales, const CFloatHandle* freeTerm,
+		const CFloatHandle& result ) override;
 	CChannelwiseConvolutionDesc* InitBlobChannelwiseConvolution( const CBlobDesc& input,
 		int paddingHeight, int paddingWidth, int strideHeight, int strideWidth,
 		const CBlobDesc& filter, const CBlobDesc* freeTerm, const CBlobDesc& output ) override;
@@ -491,12 +506,23 @@ public:
 	void IndRnnRecurrentLearn( bool reverse, int sequenceLength, int batchSize, int objectSize,
 		const CConstFloatHandle& mask, const CConstFloatHandle& u, const CConstFloatHandle& h, const CConstFloatHandle& hDiff,
 		const CFloatHandle& uDiff ) override;
+	void LstmRecurrent( bool reverse, int sequenceLength, int batchSize, int hiddenSize,
+		const CConstFloatHandle& inputGates, const CConstFloatHandle& recurWeights,
+		const CConstFloatHandle& initialHidden, const CConstFloatHandle& initialState,
+		const CFloatHandle& hidden, const CFloatHandle& state ) override;
+	void GruRecurrent( bool reverse, int sequenceLength, int batchSize, int hiddenSize,
+		const CConstFloatHandle& inputGates, const CConstFloatHandle& inputMain,
+		const CConstFloatHandle& gateWeights, const CConstFloatHandle& mainWeights,
+		const CConstFloatHandle& initialHidden, const CFloatHandle& hidden ) override;
 	CLrnDesc* InitLrn( const CBlobDesc& source, int windowSize, float bias, float alpha, float beta ) override;
 	void Lrn( const CLrnDesc& desc, const CConstFloatHandle& input, const CFloatHandle& invSum,
 		const CFloatHandle& invSumBeta, const CFloatHandle& outputHandle ) override;
 	void LrnBackward( const CLrnDesc& desc, const CConstFloatHandle& input, const CConstFloatHandle& output,
 		const CConstFloatHandle& outputDiff, const CConstFloatHandle& invSum, const CConstFloatHandle& invSumBeta,
 		const CFloatHandle& inputDiff ) override;
+	void MultiheadAttention( int batchSize, int headCount, int headSize, int seqQ, int seqK, float multiplier,
+		const CConstFloatHandle& q, const CConstFloatHandle& k, const CConstFloatHandle& v,
+		const CConstFloatHandle& mask, const CFloatHandle& result ) override;
 
 	IPerformanceCounters* CreatePerformanceCounters() const override;
 
@@ -511,11 +537,13 @@ private:
 	const int memoryAlignment; // allocation alignment
 	const std::unique_ptr<CMemoryPool> memoryPool; // the memory manager
 	const std::unique_ptr<CDeviceStackAllocator> stackAllocator; // the stack memory allocator
-	mutable std::mutex mutex; // to protect the allocations
 
 	CDllLoader dllLoader; // loading library for simd instructions
 	std::unique_ptr<const ISimdMathEngine> simdMathEngine; // interface for using simd instructions
 	SgemmFunc customSgemmFunction; // Used when it is availabled and is faster then default sgemm
+	Int8RowByTransposedMatrixFunc customInt8RowByTransposedMatrixFunction; // Used when it is available
+	CCpuConvolutionAutotuneCache convolutionAutotuneCache; // the convolution algorithms chosen by autotuning
+	CCpuCacheSizes cacheSizes; // the cache sizes used to choose the block sizes
 
 	IMathEngine& mathEngine() { IMathEngine* engine = this; return *engine; }
 
@@ -565,6 +593,8 @@ private:
 		int firstWidth, const CConstFloatHandle& secondHandle, int secondHeight, const CFloatHandle& resultHandle );
 	void multiplyMatrixByTransposedMatrixAndAdd( const float* first, int firstHeight, int firstWidth, int firstRowSize,
 		const float* second, int secondHeight, int secondRowSize, float* result, int resultRowSize );
+	void multiplyMatrixByTransposedInt8Matrix( const float* first, int firstHeight, int firstWidth, float firstScale,
+		signed char* firstRowBuffer, const signed char* second, const float* secondScales, int secondHeight, float* result );
 
 	template<class T>
 	void blobMergeByDimCommon( int dimNum, const CBlobDesc* from, const CTypedMemoryHandle<T>* fromData, int fromCount,
@@ -599,6 +629,9 @@ private:
 		const float* filterData, const CFloatHandle* freeTermData, float* resultData );
 	void blobConvolutionForwardAlgo1( const CCpuConvolutionDesc& desc, const float* sourceData,
 		const float* filterData, const CFloatHandle* freeTermData, float* resultData );
+	void blobConvolutionForwardWinograd( const CCpuConvolutionDesc& desc, const float* sourceData,
+		const float* filterData, const float* freeTermData, float* resultData );
+	void autotuneConvolution( CCpuConvolutionDesc& desc );
 	void backwardConvolutionAddFilterToOutput( const CCpuConvolutionDesc& desc, const CFloatHandle& temp,
 		const CFloatHandle* freeTerm, const CFloatHandle& output );
 	void backwardDilationConvolutionAddFilterToOutput( const CCpuConvolutionDesc& desc, const CFloatHandle& temp,
@@ -790,6 +790,161 @@ void CCpuMathEngine::IndRnnRecurrentLearn( bool reverse, int sequenceLength, int
 	}
 }
 
+void CCpuMathEngine::LstmRecurrent( bool reverse, int sequenceLength, int batchSize, int hiddenSize,
+	const CConstFloatHandle& inputGates, const CConstFloatHandle& recurWeights,
+	const CConstFloatHandle& initialHidden, const CConstFloatHandle& initialState,
+	const CFloatHandle& hidden, const CFloatHandle& state )
+{
+	ASSERT_EXPR( sequenceLength >= 1 );
+	ASSERT_EXPR( batchSize >= 1 );
+	ASSERT_EXPR( hiddenSize >= 1 );
+	ASSERT_EXPR( inputGates.GetMathEngine() == this );
+	ASSERT_EXPR( recurWeights.GetMathEngine() == this );
+	ASSERT_EXPR( initialHidden.IsNull() || initialHidden.GetMathEngine() == this );
+	ASSERT_EXPR( initialState.IsNull() || initialState.GetMathEngine() == this );
+	ASSERT_EXPR( hidden.GetMathEngine() == this );
+	ASSERT_EXPR( state.GetMathEngine() == this );
+
+	const int stepSize = batchSize * hiddenSize;
+	const int gateSize = 4 * hiddenSize;
+	const int gatesStepSize = batchSize * gateSize;
+
+	CFloatHandleStackVar gates( *this, gatesStepSize );
+	CFloatHandleStackVar zeros( *this, stepSize );
+	VectorFill( zeros, 0.f, stepSize );
+
+	CConstFloatHandle hPrev = initialHidden.IsNull() ? CConstFloatHandle( zeros.GetHandle() ) : initialHidden;
+	CConstFloatHandle cPrev = initialState.IsNull() ? CConstFloatHandle( zeros.GetHandle() ) : initialState;
+	const int curThreadCount = IsOmpRelevant( batchSize, gatesStepSize ) ? threadCount : 1;
+	for( int step = 0; step < sequenceLength; ++step ) {
+		const int pos = reverse ? sequenceLength - 1 - step : step;
+
+		// The only part of the step which needs the whole previous step
+		MultiplyMatrixByTransposedMatrix( hPrev, batchSize, hiddenSize, hiddenSize,
+			recurWeights, gateSize, hiddenSize, gates, gateSize, gatesStepSize );
+
+		const CConstFloatHandle stepInputGates = inputGates + pos * gatesStepSize;
+		const CFloatHandle stepHidden = hidden + pos * stepSize;
+		const CFloatHandle stepState = state + pos * stepSize;
+		NEOML_OMP_NUM_THREADS( curThreadCount )
+		{
+			int start;
+			int count;
+			if( OmpGetTaskIndexAndCount( batchSize, start, count ) ) {
+				for( int b = start; b < start + count; ++b ) {
+					const CFloatHandle rowGates = gates.GetHandle() + b * gateSize;
+					VectorAdd( rowGates, stepInputGates + b * gateSize, rowGates, gateSize );
+					VectorTanh( rowGates, rowGates, hiddenSize );
+					VectorSigmoid( rowGates + hiddenSize, rowGates + hiddenSize, 3 * hiddenSize );
+
+					const float* main = GetRaw( rowGates );
+					const float* forget = main + hiddenSize;
+					const float* input = forget + hiddenSize;
+					const float* output = input + hiddenSize;
+					const float* prevC = GetRaw( cPrev + b * hiddenSize );
+					float* c = GetRaw( stepState + b * hiddenSize );
+					for( int i = 0; i < hiddenSize; ++i ) {
+						c[i] = forget[i] * prevC[i] + input[i] * main[i];
+					}
+
+					VectorTanh( stepState + b * hiddenSize, stepHidden + b * hiddenSize, hiddenSize );
+					float* h = GetRaw( stepHidden + b * hiddenSize );
+					for( int i = 0; i < hiddenSize; ++i ) {
+						h[i] *= output[i];
+					}
+				}
+			}
+		}
+
+		hPrev = stepHidden;
+		cPrev = stepState;
+	}
+}
+
+void CCpuMathEngine::GruRecurrent( bool reverse, int sequenceLength, int batchSize, int hiddenSize,
+	const CConstFloatHandle& inputGates, const CConstFloatHandle& inputMain,
+	const CConstFloatHandle& gateWeights, const CConstFloatHandle& mainWeights,
+	const CConstFloatHandle& initialHidden, const CFloatHandle& hidden )
+{
+	ASSERT_EXPR( sequenceLength >= 1 );
+	ASSERT_EXPR( batchSize >= 1 );
+	ASSERT_EXPR( hiddenSize >= 1 );
+	ASSERT_EXPR( inputGates.GetMathEngine() == this );
+	ASSERT_EXPR( inputMain.GetMathEngine() == this );
+	ASSERT_EXPR( gateWeights.GetMathEngine() == this );
+	ASSERT_EXPR( mainWeights.GetMathEngine() == this );
+	ASSERT_EXPR( initialHidden.IsNull() || initialHidden.GetMathEngine() == this );
+	ASSERT_EXPR( hidden.GetMathEngine() == this );
+
+	const int stepSize = batchSize * hiddenSize;
+	const int gateSize = 2 * hiddenSize;
+	const int gatesStepSize = batchSize * gateSize;
+
+	CFloatHandleStackVar gates( *this, gatesStepSize );
+	CFloatHandleStackVar resetHidden( *this, stepSize );
+	CFloatHandleStackVar main( *this, stepSize );
+	CFloatHandleStackVar zeros( *this, stepSize );
+	VectorFill( zeros, 0.f, stepSize );
+
+	CConstFloatHandle hPrev = initialHidden.IsNull() ? CConstFloatHandle( zeros.GetHandle() ) : initialHidden;
+	const int curThreadCount = IsOmpRelevant( batchSize, gatesStepSize ) ? threadCount : 1;
+	for( int step = 0; step < sequenceLength; ++step ) {
+		const int pos = reverse ? sequenceLength - 1 - step : step;
+
+		MultiplyMatrixByTransposedMatrix( hPrev, batchSize, hiddenSize, hiddenSize,
+			gateWeights, gateSize, hiddenSize, gates, gateSize, gatesStepSize );
+
+		const CConstFloatHandle stepInputGates = inputGates + pos * gatesStepSize;
+		NEOML_OMP_NUM_THREADS( curThreadCount )
+		{
+			int start;
+			int count;
+			if( OmpGetTaskIndexAndCount( batchSize, start, count ) ) {
+				for( int b = start; b < start + count; ++b ) {
+					const CFloatHandle rowGates = gates.GetHandle() + b * gateSize;
+					VectorAdd( rowGates, stepInputGates + b * gateSize, rowGates, gateSize );
+					VectorSigmoid( rowGates, rowGates, gateSize );
+
+					const float* reset = GetRaw( rowGates ) + hiddenSize;
+					const float* prevH = GetRaw( hPrev + b * hiddenSize );
+					float* resetH = GetRaw( resetHidden.GetHandle() + b * hiddenSize );
+					for( int i = 0; i < hiddenSize; ++i ) {
+						resetH[i] = reset[i] * prevH[i];
+					}
+				}
+			}
+		}
+
+		MultiplyMatrixByTransposedMatrix( resetHidden, batchSize, hiddenSize, hiddenSize,
+			mainWeights, hiddenSize, hiddenSize, main, hiddenSize, stepSize );
+
+		const CConstFloatHandle stepInputMain = inputMain + pos * stepSize;
+		const CFloatHandle stepHidden = hidden + pos * stepSize;
+		NEOML_OMP_NUM_THREADS( curThreadCount )
+		{
+			int start;
+			int count;
+			if( OmpGetTaskIndexAndCount( batchSize, start, count ) ) {
+				for( int b = start; b < start + count; ++b ) {
+					const CFloatHandle rowMain = main.GetHandle() + b * hiddenSize;
+					VectorAdd( rowMain, stepInputMain + b * hiddenSize, rowMain, hiddenSize );
+					VectorTanh( rowMain, rowMain, hiddenSize );
+
+					const float* update = GetRaw( gates.GetHandle() + b * gateSize );
+					const float* mainPtr = GetRaw( rowMain );
+					const float* prevH = GetRaw( hPrev + b * hiddenSize );
+					float* h = GetRaw( stepHidden + b * hiddenSize );
+					for( int i = 0; i < hiddenSize; ++i ) {
+						h[i] = mainPtr[i] + update[i] * ( prevH[i] - mainPtr[i] );
+					}
+				}
+			}
+		}
+
+		hPrev = stepHidden;
+	}
+}
+
 template<class T>
 static inline void SpaceToDepthFunc( const T* source, int dataRowCount, int dataRowWidth,
 	int blockChannels, int blockSize, bool isForward, T* result, int threadCount )
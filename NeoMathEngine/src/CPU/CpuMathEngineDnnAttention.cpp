@@ -0,0 +1,140 @@
+/* Copyright © 2017-2021 ABBYY Production LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+--------------------------------------------------------------------------------------------------------------*/
+
+#include <common.h>
+#pragma hdrstop
+
+#include <float.h>
+#include <CpuMathEngine.h>
+#include <CpuMathEngineOmp.h>
+#include <MemoryHandleInternal.h>
+#include <MathEngineCommon.h>
+#include <NeoMathEngine/NeoMathEngineException.h>
+#include <NeoMathEngine/OpenMP.h>
+
+namespace NeoML {
+
+// The number of attention matrix elements calculated by one thread at once
+// The tile must stay in the L2 cache between Q_i * K_i^T, softmax and the multiplication by V_i
+static const int MultiheadAttentionTileSize = 32 * 1024;
+
+// Replaces every row of the tile with softmax( row * multiplier + maskRow )
+static void attentionTileSoftmax( IMathEngine& mathEngine, const CFloatHandle& tileHandle, int height, int width,
+	float multiplier, const float* mask )
+{
+	float* tile = GetRaw( tileHandle );
+
+	float* row = tile;
+	for( int i = 0; i < height; ++i ) {
+		float maxValue = -FLT_MAX;
+		if( mask == nullptr ) {
+			for( int j = 0; j < width; ++j ) {
+				row[j] *= multiplier;
+				maxValue = max( maxValue, row[j] );
+			}
+		} else {
+			for( int j = 0; j < width; ++j ) {
+				row[j] = row[j] * multiplier + mask[j];
+				maxValue = max( maxValue, row[j] );
+			}
+			mask += width;
+		}
+		for( int j = 0; j < width; ++j ) {
+			row[j] -= maxValue;
+		}
+		row += width;
+	}
+
+	mathEngine.VectorExp( tileHandle, tileHandle, height * width );
+
+	row = tile;
+	for( int i = 0; i < height; ++i ) {
+		float sum = 0;
+		for( int j = 0; j < width; ++j ) {
+			sum += row[j];
+		}
+		const float invSum = 1.f / sum;
+		for( int j = 0; j < width; ++j ) {
+			row[j] *= invSum;
+		}
+		row += width;
+	}
+}
+
+void CCpuMathEngine::MultiheadAttention( int batchSize, int headCount, int headSize, int seqQ, int seqK, float multiplier,
+	const CConstFloatHandle& q, const CConstFloatHandle& k, const CConstFloatHandle& v,
+	const CConstFloatHandle& mask, const CFloatHandle& result )
+{
+	ASSERT_EXPR( batchSize >= 1 );
+	ASSERT_EXPR( headCount >= 1 );
+	ASSERT_EXPR( headSize >= 1 );
+	ASSERT_EXPR( seqQ >= 1 );
+	ASSERT_EXPR( seqK >= 1 );
+	ASSERT_EXPR( q.GetMathEngine() == this );
+	ASSERT_EXPR( k.GetMathEngine() == this );
+	ASSERT_EXPR( v.GetMathEngine() == this );
+	ASSERT_EXPR( mask.IsNull() || mask.GetMathEngine() == this );
+	ASSERT_EXPR( result.GetMathEngine() == this );
+
+	const int rowSize = headCount * headSize;
+	// The query rows are processed by tiles of tileHeight rows
+	// so the full [seqQ x seqK] attention matrix of the head is never stored
+	const int tileHeight = min( seqQ, max( 1, MultiheadAttentionTileSize / seqK ) );
+	const int tileCount = Ceil( seqQ, tileHeight );
+	// The tasks are ordered by (batch, head, tile)
+	// so every thread processes the neighbouring tiles of the same head and reuses K_i and V_i
+	const int taskCount = batchSize * headCount * tileCount;
+
+	const float* qData = GetRaw( q );
+	const float* kData = GetRaw( k );
+	const float* vData = GetRaw( v );
+	const float* maskData = mask.IsNull() ? nullptr : GetRaw( mask );
+	float* resultData = GetRaw( result );
+
+	const int curThreadCount = IsOmpRelevant( taskCount,
+		static_cast<int64_t>( batchSize ) * headCount * seqQ * seqK * headSize ) ? threadCount : 1;
+	COmpPrivate1DData tiles( curThreadCount, mathEngine(), tileHeight * seqK );
+
+	NEOML_OMP_NUM_THREADS( curThreadCount )
+	{
+		int index, count;
+		if( OmpGetTaskIndexAndCount( taskCount, index, count ) ) {
+			CFloatHandle tile = tiles.GetPrivateData();
+			float* tileData = GetRaw( tile );
+
+			for( int task = index; task < index + count; ++task ) {
+				const int tileIndex = task % tileCount;
+				const int head = ( task / tileCount ) % headCount;
+				const int batch = task / ( tileCount * headCount );
+				const int rowStart = tileIndex * tileHeight;
+				const int rowCount = min( tileHeight, seqQ - rowStart );
+
+				const int qOffset = ( batch * seqQ + rowStart ) * rowSize + head * headSize;
+				const int kOffset = batch * seqK * rowSize + head * headSize;
+
+				// Q_i * K_i^T
+				multiplyMatrixByTransposedMatrix( qData + qOffset, rowCount, headSize, rowSize,
+					kData + kOffset, seqK, rowSize, tileData, seqK );
+				attentionTileSoftmax( mathEngine(), tile, rowCount, seqK, multiplier,
+					maskData == nullptr ? nullptr : maskData + rowStart * seqK );
+				// softmax( Q_i * K_i^T ) * V_i
+				multiplyMatrixByMatrix( tileData, rowCount, seqK, seqK, vData + kOffset, headSize, rowSize,
+					resultData + qOffset, rowSize );
+			}
+		}
+	}
+}
+
+} // namespace NeoML
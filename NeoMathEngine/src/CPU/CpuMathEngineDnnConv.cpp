@@ -24,47 +24,74 @@ limitations under the License.
 #include <MathEngineDnnConv.h>
 #include <CpuMathEnginePrivate.h>
 #include <NeoMathEngine/SimdMathEngine.h>
+#include <chrono>
 
 namespace NeoML {
 
-// The algorithm used to calculate a 2D convolution
-enum TConvAlgo {
-	CA_Auto,	// choose automatically
-	CA_1,		// use a temporary matrix to store the data in another order
-	CA_2,		// work with the data directly (only for stride = 1 and padding = 0)
-				// most efficient when the image is large and especially when it has many channels
-				
-	CA_1x1		// for convolution with a 1*1 filter, no padding and dilation (both 2D and 3D)
-};
-
-const int BlobConvolutionCacheSize = 256 * 1024;
+// The number of floats that may be processed together to stay in the cache; the L2 cache of one core is used
+static inline int blobConvolutionCacheSize( const CCpuCacheSizes& cacheSizes )
+{
+	return static_cast<int>( cacheSizes.L2 / sizeof( float ) );
+}
 
 // Convolution descriptor
 struct CCpuConvolutionDesc : public CCommonConvolutionDesc {
 	TConvAlgo ForwardAlgo;
 	TConvAlgo BackwardAlgo;
 	unique_ptr<CConvolutionDesc> SimdConvolutionDesc;
+	// The filter transformed by the Winograd algorithm and the copy of the filter it was calculated for
+	// The filter is transformed again only if it has changed
+	mutable unique_ptr<CFloatHandleVar> WinogradFilter;
+	mutable unique_ptr<CFloatHandleVar> WinogradSourceFilter;
 
 	CCpuConvolutionDesc( unique_ptr<CConvolutionDesc>& simdConvolutionDesc, const CBlobDesc& source, const CBlobDesc& result, const CBlobDesc& filter,
 			int paddingHeight, int paddingWidth, int strideHeight, int strideWidth, int dilationHeight, int dilationWidth ) :
 		CCommonConvolutionDesc( source, result, filter, paddingHeight, paddingWidth, strideHeight, strideWidth, dilationHeight, dilationWidth ),
-		ForwardAlgo( getActualForwardAlgo() ),
+		ForwardAlgo( getActualForwardAlgo( simdConvolutionDesc != nullptr ) ),
 		BackwardAlgo( getActualBackwardAlgo() ),
 		SimdConvolutionDesc( std::move( simdConvolutionDesc ) )
 	{
 	}
 
-	TConvAlgo getActualForwardAlgo() const;
+	TConvAlgo getActualForwardAlgo( bool isSimdAvailable ) const;
 	TConvAlgo getActualBackwardAlgo() const;
+
+	// Checks if the algorithm may be used for this convolution
+	bool IsForwardAlgoAvailable( TConvAlgo algo ) const;
+	bool IsBackwardAlgoAvailable( TConvAlgo algo ) const;
+
+private:
+	TConvAlgo getActualGemmAlgo() const;
+	bool canUse1x1() const;
+	bool canUseWinograd() const;
 };
 
+inline bool CCpuConvolutionDesc::canUse1x1() const
+{
+	return PaddingHeight == 0 && PaddingWidth == 0 && DilationHeight == 1 && DilationWidth == 1
+		&& Filter.ObjectSize() == Filter.Channels();
+}
+
+inline bool CCpuConvolutionDesc::canUseWinograd() const
+{
+	return Filter.Height() == 3 && Filter.Width() == 3
+		&& StrideHeight == 1 && StrideWidth == 1 && DilationHeight == 1 && DilationWidth == 1;
+}
+
 // Gets the algorithm to be used for this convolution
-inline TConvAlgo CCpuConvolutionDesc::getActualForwardAlgo() const
+// The Winograd algorithm is less precise than the others, so it may be chosen only by autotuning
+inline TConvAlgo CCpuConvolutionDesc::getActualForwardAlgo( bool isSimdAvailable ) const
 {
-	if( PaddingHeight == 0 && PaddingWidth == 0
-		&& DilationHeight == 1 && DilationWidth == 1
-		&& Filter.ObjectSize() == Filter.Channels() )
-	{
+	if( isSimdAvailable ) {
+		return CA_Simd;
+	}
+	return getActualGemmAlgo();
+}
+
+// Gets the algorithm that multiplies the filter by the (reordered) input
+inline TConvAlgo CCpuConvolutionDesc::getActualGemmAlgo() const
+{
+	if( canUse1x1() ) {
 		return CA_1x1;
 	}
 	
@@ -88,7 +115,7 @@ inline TConvAlgo CCpuConvolutionDesc::getActualForwardAlgo() const
 
 inline TConvAlgo CCpuConvolutionDesc::getActualBackwardAlgo() const
 {
-	TConvAlgo ret = getActualForwardAlgo();
+	TConvAlgo ret = getActualGemmAlgo();
 	if( ret == CA_2 && ( PaddingHeight != 0 || PaddingWidth != 0 ) ) {
 		ret = CA_1;
 	}
@@ -96,6 +123,38 @@ inline TConvAlgo CCpuConvolutionDesc::getActualBackwardAlgo() const
 	return ret;
 }
 
+inline bool CCpuConvolutionDesc::IsForwardAlgoAvailable( TConvAlgo algo ) const
+{
+	switch( algo ) {
+		case CA_1:
+		case CA_2:
+			return true;
+		case CA_1x1:
+			return canUse1x1();
+		case CA_Winograd:
+			return canUseWinograd();
+		case CA_Simd:
+			return SimdConvolutionDesc != nullptr;
+		default:
+			return false;
+	}
+}
+
+inline bool CCpuConvolutionDesc::IsBackwardAlgoAvailable( TConvAlgo algo ) const
+{
+	switch( algo ) {
+		case CA_1:
+			return true;
+		case CA_2:
+			return PaddingHeight == 0 && PaddingWidth == 0 && StrideHeight == 1 && StrideWidth == 1
+				&& DilationHeight == 1 && DilationWidth == 1;
+		case CA_1x1:
+			return canUse1x1();
+		default:
+			return false;
+	}
+}
+
 // Returns the descriptor of the "flattened" blob with depth == 1 and channels = desc.depth * desc.channels
 static inline CBlobDesc flatten( const CBlobDesc& desc )
 {
@@ -138,9 +197,137 @@ CConvolutionDesc* CCpuMathEngine::InitBlobConvolution( const CBlobDesc& source,
 
 	CCpuConvolutionDesc* desc = new CCpuConvolutionDesc( simdConvolutionDesc, source, result, filter,
 		paddingHeight, paddingWidth, strideHeight, strideWidth, dilationHeight, dilationWidth );
+	autotuneConvolution( *desc );
 	return desc;
 }
 
+void CCpuMathEngine::SetConvolutionAutotuning( bool enable )
+{
+	convolutionAutotuneCache.Enable( enable );
+}
+
+bool CCpuMathEngine::SaveConvolutionAutotuningCache( const char* fileName ) const
+{
+	ASSERT_EXPR( fileName != nullptr );
+	return convolutionAutotuneCache.Save( fileName );
+}
+
+bool CCpuMathEngine::LoadConvolutionAutotuningCache( const char* fileName )
+{
+	ASSERT_EXPR( fileName != nullptr );
+	return convolutionAutotuneCache.Load( fileName );
+}
+
+const char* CCpuMathEngine::GetConvolutionAlgorithmName( const CConvolutionDesc& convDesc, bool isForward ) const
+{
+	const CCpuConvolutionDesc& desc = static_cast<const CCpuConvolutionDesc&>( convDesc );
+	return GetConvAlgoName( isForward ? desc.ForwardAlgo : desc.BackwardAlgo );
+}
+
+// The number of measured runs of every algorithm during autotuning (after one warm-up run)
+static const int ConvolutionAutotuneRunCount = 3;
+
+// Measures the best time of several runs of the function
+template<class TFunc>
+static double measureConvolutionTime( TFunc func )
+{
+	func();
+	double bestTime = DBL_MAX;
+	for( int i = 0; i < ConvolutionAutotuneRunCount; ++i ) {
+		const auto start = std::chrono::steady_clock::now();
+		func();
+		const std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+		bestTime = min( bestTime, time.count() );
+	}
+	return bestTime;
+}
+
+// Sets the algorithms for the convolution from the autotuning cache
+// If the shape hasn't been tuned yet and the autotuning is on, measures all the available algorithms
+void CCpuMathEngine::autotuneConvolution( CCpuConvolutionDesc& desc )
+{
+	CCpuConvolutionAutotuneCache::TKey key;
+	int keyIndex = 0;
+	for( int dim = 0; dim < BD_Count; ++dim ) {
+		key[keyIndex++] = desc.Source.DimSize( dim );
+		key[keyIndex++] = desc.Filter.DimSize( dim );
+	}
+	key[keyIndex++] = desc.PaddingHeight;
+	key[keyIndex++] = desc.PaddingWidth;
+	key[keyIndex++] = desc.StrideHeight;
+	key[keyIndex++] = desc.StrideWidth;
+	key[keyIndex++] = desc.DilationHeight;
+	key[keyIndex++] = desc.DilationWidth;
+	key[keyIndex++] = threadCount;
+	PRESUME_EXPR( keyIndex == CCpuConvolutionAutotuneCache::KeySize );
+
+	CCpuConvolutionAutotuneCache::CResult cached;
+	if( convolutionAutotuneCache.Find( key, cached ) ) {
+		// The file may have been made on another processor, so the choice is checked
+		if( desc.IsForwardAlgoAvailable( cached.ForwardAlgo ) ) {
+			desc.ForwardAlgo = cached.ForwardAlgo;
+		}
+		if( desc.IsBackwardAlgoAvailable( cached.BackwardAlgo ) ) {
+			desc.BackwardAlgo = cached.BackwardAlgo;
+		}
+		return;
+	}
+	if( !convolutionAutotuneCache.IsEnabled() ) {
+		return;
+	}
+
+	// CA_2 is not measured for the forward pass because it uses the same implementation as CA_1
+	CFloatHandleVar source( mathEngine(), desc.Source.BlobSize() );
+	CFloatHandleVar filter( mathEngine(), desc.Filter.BlobSize() );
+	CFloatHandleVar freeTerm( mathEngine(), desc.Filter.ObjectCount() );
+	CFloatHandleVar result( mathEngine(), desc.Result.BlobSize() );
+	VectorFill( source.GetHandle(), 0.5f, source.Size() );
+	VectorFill( filter.GetHandle(), 0.25f, filter.Size() );
+	VectorFill( freeTerm.GetHandle(), 1.f, freeTerm.Size() );
+	const CFloatHandle freeTermHandle = freeTerm.GetHandle();
+
+	double bestTime = DBL_MAX;
+	TConvAlgo bestAlgo = desc.ForwardAlgo;
+	for( int algo = CA_1; algo < CA_Count; ++algo ) {
+		if( algo == CA_2 || !desc.IsForwardAlgoAvailable( static_cast<TConvAlgo>( algo ) ) ) {
+			continue;
+		}
+		desc.ForwardAlgo = static_cast<TConvAlgo>( algo );
+		const double time = measureConvolutionTime( [&]() {
+			BlobConvolution( desc, source.GetHandle(), filter.GetHandle(), &freeTermHandle, result.GetHandle() );
+		} );
+		if( time < bestTime ) {
+			bestTime = time;
+			bestAlgo = desc.ForwardAlgo;
+		}
+	}
+	desc.ForwardAlgo = bestAlgo;
+
+	// The backward algorithm is also used for learning, so both passes are measured together
+	bestTime = DBL_MAX;
+	bestAlgo = desc.BackwardAlgo;
+	for( int algo = CA_1; algo < CA_Count; ++algo ) {
+		if( !desc.IsBackwardAlgoAvailable( static_cast<TConvAlgo>( algo ) ) ) {
+			continue;
+		}
+		desc.BackwardAlgo = static_cast<TConvAlgo>( algo );
+		const double time = measureConvolutionTime( [&]() {
+			BlobConvolutionBackward( desc, result.GetHandle(), filter.GetHandle(), nullptr, source.GetHandle() );
+			BlobConvolutionLearnAdd( desc, source.GetHandle(), result.GetHandle(), filter.GetHandle(), nullptr, false );
+		} );
+		if( time < bestTime ) {
+			bestTime = time;
+			bestAlgo = desc.BackwardAlgo;
+		}
+	}
+	desc.BackwardAlgo = bestAlgo;
+
+	CCpuConvolutionAutotuneCache::CResult tuned;
+	tuned.ForwardAlgo = desc.ForwardAlgo;
+	tuned.BackwardAlgo = desc.BackwardAlgo;
+	convolutionAutotuneCache.Add( key, tuned );
+}
+
 // Creates a temporary blob with reordered input data that will be used to calculate convolution
 // This method allows for nonzero dilation
 void CCpuMathEngine::createDilationTemporaryBlob( const CCpuConvolutionDesc& desc, const float* inputData, int inputBatch,
@@ -395,7 +582,7 @@ void CCpuMathEngine::blobConvolutionForwardAlgo0( const CCpuConvolutionDesc& des
 {
 	const int resultItemCount = desc.Result.ObjectCount() * desc.Result.Width() * desc.Result.Height();
 	const int curThreadCount = IsOmpRelevant( resultItemCount, static_cast< int64_t >( desc.Result.BlobSize() ) * desc.Filter.ObjectSize() ) ? threadCount : 1;
-	const int cacheItemCount = max( 1, min( ceilTo( BlobConvolutionCacheSize / desc.Filter.ObjectSize(), 16 ), resultItemCount / curThreadCount ) );
+	const int cacheItemCount = max( 1, min( ceilTo( blobConvolutionCacheSize( cacheSizes ) / desc.Filter.ObjectSize(), 16 ), resultItemCount / curThreadCount ) );
 	const int tempDataSize = curThreadCount * cacheItemCount * desc.Filter.ObjectSize();
 
 	CFloatHandleStackVar tempData( mathEngine(), tempDataSize );
@@ -504,6 +691,295 @@ void CCpuMathEngine::blobConvolutionForwardAlgo1( const CCpuConvolutionDesc& des
 	}
 }
 
+// Winograd minimal filtering algorithm F(m*m, 3*3)
+// The result is calculated by m*m tiles: Y = A^T * [ ( G * g * G^T ) .* ( B^T * d * B ) ] * A,
+// where g is the 3*3 filter and d is the (m + 2)*(m + 2) input tile
+// The elementwise product is summed over the input channels, so it turns into ( m + 2 )^2 matrix multiplications
+struct CWinogradTransform {
+	int TileSize; // m
+	int InputTileSize; // m + 2
+	const float* BT; // B^T, InputTileSize * InputTileSize
+	const float* G; // G, InputTileSize * 3
+	const float* AT; // A^T, TileSize * InputTileSize
+};
+
+static const float WinogradF2x2BT[] = {
+	1.f, 0.f, -1.f, 0.f,
+	0.f, 1.f, 1.f, 0.f,
+	0.f, -1.f, 1.f, 0.f,
+	0.f, 1.f, 0.f, -1.f
+};
+
+static const float WinogradF2x2G[] = {
+	1.f, 0.f, 0.f,
+	0.5f, 0.5f, 0.5f,
+	0.5f, -0.5f, 0.5f,
+	0.f, 0.f, 1.f
+};
+
+static const float WinogradF2x2AT[] = {
+	1.f, 1.f, 1.f, 0.f,
+	0.f, 1.f, -1.f, -1.f
+};
+
+static const float WinogradF4x4BT[] = {
+	4.f, 0.f, -5.f, 0.f, 1.f, 0.f,
+	0.f, -4.f, -4.f, 1.f, 1.f, 0.f,
+	0.f, 4.f, -4.f, -1.f, 1.f, 0.f,
+	0.f, -2.f, -1.f, 2.f, 1.f, 0.f,
+	0.f, 2.f, -1.f, -2.f, 1.f, 0.f,
+	0.f, 4.f, 0.f, -5.f, 0.f, 1.f
+};
+
+static const float WinogradF4x4G[] = {
+	1.f / 4, 0.f, 0.f,
+	-1.f / 6, -1.f / 6, -1.f / 6,
+	-1.f / 6, 1.f / 6, -1.f / 6,
+	1.f / 24, 1.f / 12, 1.f / 6,
+	1.f / 24, -1.f / 12, 1.f / 6,
+	0.f, 0.f, 1.f
+};
+
+static const float WinogradF4x4AT[] = {
+	1.f, 1.f, 1.f, 1.f, 1.f, 0.f,
+	0.f, 1.f, -1.f, 2.f, -2.f, 0.f,
+	0.f, 1.f, 1.f, 4.f, 4.f, 0.f,
+	0.f, 1.f, -1.f, 8.f, -8.f, 1.f
+};
+
+static const CWinogradTransform WinogradF2x2 = { 2, 4, WinogradF2x2BT, WinogradF2x2G, WinogradF2x2AT };
+static const CWinogradTransform WinogradF4x4 = { 4, 6, WinogradF4x4BT, WinogradF4x4G, WinogradF4x4AT };
+
+// Calculates result[i][j][c] = sum_k( matrix[i][k] * source[k][j][c] )
+// The source is a height * width array of vectors
+static inline void winogradMultiplyLeft( const float* matrix, int height, int medium, const float* source,
+	int sourceRowSize, int width, int channels, float* result )
+{
+	for( int i = 0; i < height; ++i ) {
+		float* resultRow = result + i * width * channels;
+		for( int j = 0; j < width * channels; ++j ) {
+			resultRow[j] = 0;
+		}
+		for( int k = 0; k < medium; ++k ) {
+			const float mult = matrix[i * medium + k];
+			if( mult == 0 ) {
+				continue;
+			}
+			const float* sourceRow = source + k * sourceRowSize;
+			for( int j = 0; j < width * channels; ++j ) {
+				resultRow[j] += mult * sourceRow[j];
+			}
+		}
+	}
+}
+
+// Calculates result[i][j][c] = sum_k( source[i][k][c] * matrix[j][k] )
+// The result vectors are written with the resultStep step
+static inline void winogradMultiplyRightTransposed( const float* source, int height, int medium, const float* matrix,
+	int width, int channels, float* result, int resultStep )
+{
+	for( int i = 0; i < height; ++i ) {
+		for( int j = 0; j < width; ++j ) {
+			float* resultPtr = result + ( i * width + j ) * resultStep;
+			for( int c = 0; c < channels; ++c ) {
+				resultPtr[c] = 0;
+			}
+			for( int k = 0; k < medium; ++k ) {
+				const float mult = matrix[j * medium + k];
+				if( mult == 0 ) {
+					continue;
+				}
+				const float* sourcePtr = source + ( i * medium + k ) * channels;
+				for( int c = 0; c < channels; ++c ) {
+					resultPtr[c] += mult * sourcePtr[c];
+				}
+			}
+		}
+	}
+}
+
+// Transforms one filter: U = G * g * G^T
+// The result is written into InputTileSize^2 matrices with the resultStep step
+static void winogradTransformFilter( const CWinogradTransform& transform, const float* filter, int channels,
+	float* temp, float* result, int resultStep )
+{
+	const int alpha = transform.InputTileSize;
+	winogradMultiplyLeft( transform.G, alpha, 3, filter, 3 * channels, 3, channels, temp );
+	winogradMultiplyRightTransposed( temp, alpha, 3, transform.G, alpha, channels, result, resultStep );
+}
+
+// Transforms one input tile: V = B^T * d * B
+// The result is written into InputTileSize^2 matrices with the resultStep step
+static void winogradTransformInput( const CWinogradTransform& transform, const CCpuConvolutionDesc& desc,
+	const float* sourceData, int tile, float* temp, float* result, int resultStep )
+{
+	const int alpha = transform.InputTileSize;
+	const int channels = desc.Source.Depth() * desc.Source.Channels();
+	const int tileRows = ( desc.Result.Height() + transform.TileSize - 1 ) / transform.TileSize;
+	const int tileColumns = ( desc.Result.Width() + transform.TileSize - 1 ) / transform.TileSize;
+
+	const int batch = tile / ( tileRows * tileColumns );
+	const int startY = ( tile / tileColumns ) % tileRows * transform.TileSize - desc.PaddingHeight;
+	const int startX = tile % tileColumns * transform.TileSize - desc.PaddingWidth;
+	const float* source = sourceData + batch * desc.Source.ObjectSize();
+
+	// Copy the tile with zero padding
+	float* tileData = temp + alpha * alpha * channels;
+	for( int i = 0; i < alpha; ++i ) {
+		const int y = startY + i;
+		for( int j = 0; j < alpha; ++j ) {
+			const int x = startX + j;
+			float* tilePtr = tileData + ( i * alpha + j ) * channels;
+			if( y < 0 || y >= desc.Source.Height() || x < 0 || x >= desc.Source.Width() ) {
+				memset( tilePtr, 0, channels * sizeof( float ) );
+			} else {
+				memcpy( tilePtr, source + ( y * desc.Source.Width() + x ) * channels, channels * sizeof( float ) );
+			}
+		}
+	}
+
+	winogradMultiplyLeft( transform.BT, alpha, alpha, tileData, alpha * channels, alpha, channels, temp );
+	winogradMultiplyRightTransposed( temp, alpha, alpha, transform.BT, alpha, channels, result, resultStep );
+}
+
+// Transforms the product for one tile back: Y = A^T * M * A, and writes it into the result
+// The product is stored in InputTileSize^2 matrices with the productStep step
+static void winogradTransformOutput( const CWinogradTransform& transform, const CCpuConvolutionDesc& desc,
+	const float* product, int productStep, const float* freeTerm, int tile, float* temp, float* resultData )
+{
+	const int m = transform.TileSize;
+	const int alpha = transform.InputTileSize;
+	const int filterCount = desc.Filter.ObjectCount();
+	const int tileRows = ( desc.Result.Height() + m - 1 ) / m;
+	const int tileColumns = ( desc.Result.Width() + m - 1 ) / m;
+
+	const int batch = tile / ( tileRows * tileColumns );
+	const int startY = ( tile / tileColumns ) % tileRows * m;
+	const int startX = tile % tileColumns * m;
+	float* result = resultData + batch * desc.Result.ObjectSize();
+
+	// temp = A^T * M
+	for( int i = 0; i < m; ++i ) {
+		for( int j = 0; j < alpha; ++j ) {
+			float* tempPtr = temp + ( i * alpha + j ) * filterCount;
+			for( int c = 0; c < filterCount; ++c ) {
+				tempPtr[c] = 0;
+			}
+			for( int k = 0; k < alpha; ++k ) {
+				const float mult = transform.AT[i * alpha + k];
+				if( mult == 0 ) {
+					continue;
+				}
+				const float* productPtr = product + ( k * alpha + j ) * productStep;
+				for( int c = 0; c < filterCount; ++c ) {
+					tempPtr[c] += mult * productPtr[c];
+				}
+			}
+		}
+	}
+
+	// Y = temp * A
+	for( int i = 0; i < m && startY + i < desc.Result.Height(); ++i ) {
+		for( int j = 0; j < m && startX + j < desc.Result.Width(); ++j ) {
+			float* resultPtr = result + ( ( startY + i ) * desc.Result.Width() + startX + j ) * filterCount;
+			for( int c = 0; c < filterCount; ++c ) {
+				resultPtr[c] = freeTerm == nullptr ? 0.f : freeTerm[c];
+			}
+			for( int k = 0; k < alpha; ++k ) {
+				const float mult = transform.AT[j * alpha + k];
+				if( mult == 0 ) {
+					continue;
+				}
+				const float* tempPtr = temp + ( i * alpha + k ) * filterCount;
+				for( int c = 0; c < filterCount; ++c ) {
+					resultPtr[c] += mult * tempPtr[c];
+				}
+			}
+		}
+	}
+}
+
+void CCpuMathEngine::blobConvolutionForwardWinograd( const CCpuConvolutionDesc& desc, const float* sourceData,
+	const float* filterData, const float* freeTermData, float* resultData )
+{
+	// The larger tiles need fewer multiplications but are less precise
+	const CWinogradTransform& transform = ( desc.Result.Height() >= 8 && desc.Result.Width() >= 8 ) ? WinogradF4x4 : WinogradF2x2;
+	const int m = transform.TileSize;
+	const int alpha = transform.InputTileSize;
+	const int alphaSquared = alpha * alpha;
+	const int channels = desc.Source.Depth() * desc.Source.Channels();
+	const int filterCount = desc.Filter.ObjectCount();
+	const int tileCount = desc.Result.ObjectCount() * ( ( desc.Result.Height() + m - 1 ) / m )
+		* ( ( desc.Result.Width() + m - 1 ) / m );
+
+	const int curThreadCount = IsOmpRelevant( tileCount,
+		static_cast<int64_t>( desc.Result.BlobSize() ) * desc.Filter.ObjectSize() ) ? threadCount : 1;
+	// The transformed input and the product for the tiles processed together should fit into the cache
+	const int tileBlockSize = max( 1, min( blobConvolutionCacheSize( cacheSizes ) / ( alphaSquared * ( channels + filterCount ) ),
+		( tileCount + curThreadCount - 1 ) / curThreadCount ) );
+	const int tempSize = 2 * alphaSquared * max( channels, filterCount );
+	const int threadBufferSize = alphaSquared * tileBlockSize * ( channels + filterCount ) + tempSize;
+
+	CFloatHandleStackVar buffer( mathEngine(), curThreadCount * threadBufferSize );
+	float* bufferRaw = GetRaw( buffer.GetHandle() );
+
+	const bool isFilterTransformed = desc.WinogradFilter != nullptr;
+	if( !isFilterTransformed ) {
+		desc.WinogradFilter.reset( new CFloatHandleVar( mathEngine(), alphaSquared * filterCount * channels ) );
+		desc.WinogradSourceFilter.reset( new CFloatHandleVar( mathEngine(), desc.Filter.BlobSize() ) );
+	}
+	float* transformedFilterRaw = GetRaw( desc.WinogradFilter->GetHandle() );
+	float* sourceFilterRaw = GetRaw( desc.WinogradSourceFilter->GetHandle() );
+	const size_t filterSize = desc.Filter.BlobSize() * sizeof( float );
+	if( !isFilterTransformed || memcmp( sourceFilterRaw, filterData, filterSize ) != 0 ) {
+		memcpy( sourceFilterRaw, filterData, filterSize );
+		// The filter is transformed into alpha^2 matrices of filterCount * channels size
+		NEOML_OMP_NUM_THREADS( curThreadCount )
+		{
+			float* temp = bufferRaw + OmpGetThreadNum() * threadBufferSize;
+			int start;
+			int count;
+			if( OmpGetTaskIndexAndCount( filterCount, start, count ) ) {
+				for( int filter = start; filter < start + count; ++filter ) {
+					winogradTransformFilter( transform, filterData + filter * desc.Filter.ObjectSize(), channels, temp,
+						transformedFilterRaw + filter * channels, filterCount * channels );
+				}
+			}
+		}
+	}
+
+	NEOML_OMP_NUM_THREADS( curThreadCount )
+	{
+		float* transformedInput = bufferRaw + OmpGetThreadNum() * threadBufferSize;
+		float* product = transformedInput + alphaSquared * tileBlockSize * channels;
+		float* temp = product + alphaSquared * tileBlockSize * filterCount;
+
+		int start;
+		int count;
+		if( OmpGetTaskIndexAndCount( tileCount, start, count ) ) {
+			for( int index = 0; index < count; index += tileBlockSize ) {
+				const int size = min( count - index, tileBlockSize );
+
+				for( int i = 0; i < size; ++i ) {
+					winogradTransformInput( transform, desc, sourceData, start + index + i, temp,
+						transformedInput + i * channels, size * channels );
+				}
+
+				for( int i = 0; i < alphaSquared; ++i ) {
+					multiplyMatrixByTransposedMatrix( transformedInput + i * size * channels, size, channels, channels,
+						transformedFilterRaw + i * filterCount * channels, filterCount, channels,
+						product + i * size * filterCount, filterCount );
+				}
+
+				for( int i = 0; i < size; ++i ) {
+					winogradTransformOutput( transform, desc, product + i * filterCount, size * filterCount,
+						freeTermData, start + index + i, temp, resultData );
+				}
+			}
+		}
+	}
+}
+
 void CCpuMathEngine::BlobConvolution( const CConvolutionDesc& convDesc, const CFloatHandle& source,
 	const CFloatHandle& filter, const CFloatHandle* freeTerm, const CFloatHandle& result )
 {
@@ -514,12 +990,13 @@ void CCpuMathEngine::BlobConvolution( const CConvolutionDesc& convDesc, const CF
 
 	const CCpuConvolutionDesc& desc = static_cast<const CCpuConvolutionDesc&>( convDesc );
 
-	if( desc.SimdConvolutionDesc != nullptr ) {
-		simdMathEngine->BlobConvolution( *desc.SimdConvolutionDesc, sourceRaw, filterRaw, freeTermRaw, resultRaw );
-		return;
-	}
-
 	switch( desc.ForwardAlgo ) {
+		case CA_Winograd:
+			blobConvolutionForwardWinograd( desc, sourceRaw, filterRaw, freeTermRaw, resultRaw );
+			break;
+		case CA_Simd:
+			simdMathEngine->BlobConvolution( *desc.SimdConvolutionDesc, sourceRaw, filterRaw, freeTermRaw, resultRaw );
+			break;
 		case CA_1:
 		case CA_2:
 		{
@@ -530,7 +1007,7 @@ void CCpuMathEngine::BlobConvolution( const CConvolutionDesc& convDesc, const CF
 				static_cast<int64_t>( desc.Result.BlobSize() ) * desc.Filter.ObjectSize() ) ? threadCount : 1;
 			const int64_t algo1DataSize = static_cast<int64_t>( desc.Result.Width() ) * desc.Result.Height() * desc.Filter.ObjectSize() + desc.Result.ObjectSize();
 
-			if( min( desc.Result.ObjectCount(), algo1ThreadCount ) * algo1DataSize <= algo0ThreadCount * BlobConvolutionCacheSize ) {
+			if( min( desc.Result.ObjectCount(), algo1ThreadCount ) * algo1DataSize <= algo0ThreadCount * blobConvolutionCacheSize( cacheSizes ) ) {
 				blobConvolutionForwardAlgo1( desc, sourceRaw, filterRaw, freeTerm, resultRaw );
 			} else {
 				blobConvolutionForwardAlgo0( desc, sourceRaw, filterRaw, freeTerm, resultRaw );
@@ -550,6 +1027,66 @@ void CCpuMathEngine::BlobConvolution( const CConvolutionDesc& convDesc, const CF
 	}
 }
 
+void CCpuMathEngine::BlobConvolutionInt8( const CConvolutionDesc& convDesc, const CFloatHandle& source, float sourceScale,
+	const CConstInt8Handle& filter, const CConstFloatHandle& filterScales, const CFloatHandle* freeTerm,
+	const CFloatHandle& result )
+{
+	ASSERT_EXPR( source.GetMathEngine() == this );
+	ASSERT_EXPR( filter.GetMathEngine() == this );
+	ASSERT_EXPR( filterScales.GetMathEngine() == this );
+	ASSERT_EXPR( freeTerm == nullptr || freeTerm->GetMathEngine() == this );
+	ASSERT_EXPR( result.GetMathEngine() == this );
+
+	const CCpuConvolutionDesc& desc = static_cast<const CCpuConvolutionDesc&>( convDesc );
+
+	const float* sourceData = GetRaw( source );
+	const signed char* filterData = GetRaw( filter );
+	const float* filterScalesData = GetRaw( filterScales );
+	float* resultData = GetRaw( result );
+
+	// The same scheme as in blobConvolutionForwardAlgo0, but the unfolded input is multiplied by the int8 filter
+	const int resultItemCount = desc.Result.ObjectCount() * desc.Result.Width() * desc.Result.Height();
+	const int curThreadCount = IsOmpRelevant( resultItemCount, static_cast< int64_t >( desc.Result.BlobSize() ) * desc.Filter.ObjectSize() ) ? threadCount : 1;
+	const int cacheItemCount = max( 1, min( ceilTo( blobConvolutionCacheSize( cacheSizes ) / desc.Filter.ObjectSize(), 16 ), resultItemCount / curThreadCount ) );
+	const int tempDataSize = curThreadCount * cacheItemCount * desc.Filter.ObjectSize();
+
+	CFloatHandleStackVar tempData( mathEngine(), tempDataSize );
+	float* tempDataRaw = GetRaw( tempData.GetHandle() );
+	CInt8HandleStackVar rowBuffer( mathEngine(), curThreadCount * desc.Filter.ObjectSize() );
+	signed char* rowBufferRaw = GetRaw( rowBuffer.GetHandle() );
+
+	NEOML_OMP_NUM_THREADS( curThreadCount )
+	{
+		const int filterObjectCount = desc.Filter.ObjectCount();
+		const int filterObjectSize = desc.Filter.ObjectSize();
+		float* tempDataPtr = tempDataRaw + OmpGetThreadNum() * cacheItemCount * filterObjectSize;
+		signed char* rowBufferPtr = rowBufferRaw + OmpGetThreadNum() * filterObjectSize;
+
+		int start;
+		int count;
+		if( OmpGetTaskIndexAndCount( resultItemCount, start, count ) ) {
+			int index = 0;
+			while( index < count ) {
+				const int size = min( count - index, cacheItemCount );
+
+				fillTempData( sourceData, tempDataPtr, desc, start + index, size );
+
+				float* resultDataPtr = resultData + ( start + index ) * filterObjectCount;
+
+				multiplyMatrixByTransposedInt8Matrix( tempDataPtr, size, filterObjectSize, sourceScale,
+					rowBufferPtr, filterData, filterScalesData, filterObjectCount, resultDataPtr );
+
+				if( freeTerm != nullptr ) {
+					addVectorToMatrixRows( resultDataPtr, resultDataPtr, size, filterObjectCount, filterObjectCount,
+						filterObjectCount, GetRaw( *freeTerm ) );
+				}
+
+				index += size;
+			}
+		}
+	}
+}
+
 void CCpuMathEngine::backwardConvolutionAddFilterToOutput( const CCpuConvolutionDesc& desc, const CFloatHandle& temp,
 	const CFloatHandle* freeTermData, const CFloatHandle& outputData )
 {
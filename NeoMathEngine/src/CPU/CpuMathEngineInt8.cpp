@@ -0,0 +1,150 @@
+/* Copyright © 2017-2021 ABBYY Production LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+--------------------------------------------------------------------------------------------------------------*/
+
+#include <common.h>
+#pragma hdrstop
+
+#include <cmath>
+#include <CpuMathEngine.h>
+#include <CpuMathEngineOmp.h>
+#include <MemoryHandleInternal.h>
+#include <MathEngineCommon.h>
+#include <NeoMathEngine/NeoMathEngineException.h>
+#include <NeoMathEngine/OpenMP.h>
+
+namespace NeoML {
+
+static const float Int8MaxValue = 127.f;
+
+// Calculates the symmetric quantization scale for the row
+static inline float getInt8RowScale( const float* row, int width )
+{
+	float maxAbs = 0;
+	for( int i = 0; i < width; ++i ) {
+		maxAbs = max( maxAbs, fabsf( row[i] ) );
+	}
+	return maxAbs > 0 ? maxAbs / Int8MaxValue : 1.f;
+}
+
+// Quantizes the row with the given scale, the values out of range are saturated
+static inline void quantizeInt8Row( const float* row, int width, float scale, signed char* result )
+{
+	const float multiplier = 1.f / scale;
+	for( int i = 0; i < width; ++i ) {
+		const float value = roundf( row[i] * multiplier );
+		result[i] = static_cast<signed char>( min( Int8MaxValue, max( -Int8MaxValue, value ) ) );
+	}
+}
+
+// The int8 dot product accumulated in int32
+static inline int int8DotProduct( const signed char* first, const signed char* second, int size )
+{
+	int result = 0;
+	for( int i = 0; i < size; ++i ) {
+		result += static_cast<int>( first[i] ) * static_cast<int>( second[i] );
+	}
+	return result;
+}
+
+void CCpuMathEngine::QuantizeMatrixRowsInt8( const CConstFloatHandle& matrixHandle, int height, int width,
+	const CInt8Handle& resultHandle, const CFloatHandle& scalesHandle )
+{
+	ASSERT_EXPR( matrixHandle.GetMathEngine() == this );
+	ASSERT_EXPR( resultHandle.GetMathEngine() == this );
+	ASSERT_EXPR( scalesHandle.GetMathEngine() == this );
+	ASSERT_EXPR( height > 0 );
+	ASSERT_EXPR( width > 0 );
+
+	const float* matrix = GetRaw( matrixHandle );
+	signed char* result = GetRaw( resultHandle );
+	float* scales = GetRaw( scalesHandle );
+
+	const int curThreadCount = IsOmpRelevant( height, static_cast<int64_t>( height ) * width ) ? threadCount : 1;
+
+	NEOML_OMP_NUM_THREADS( curThreadCount )
+	{
+		int start;
+		int count;
+		if( OmpGetTaskIndexAndCount( height, start, count ) ) {
+			for( int i = start; i < start + count; ++i ) {
+				scales[i] = getInt8RowScale( matrix + i * width, width );
+				quantizeInt8Row( matrix + i * width, width, scales[i], result + i * width );
+			}
+		}
+	}
+}
+
+// Multiplies the float matrix by the transposed int8 matrix in one thread
+// Every row of the first matrix is quantized into firstRowBuffer (firstWidth elements) before multiplication
+void CCpuMathEngine::multiplyMatrixByTransposedInt8Matrix( const float* first, int firstHeight, int firstWidth,
+	float firstScale, signed char* firstRowBuffer, const signed char* second, const float* secondScales,
+	int secondHeight, float* result )
+{
+	for( int i = 0; i < firstHeight; ++i ) {
+		const float rowScale = firstScale > 0 ? firstScale : getInt8RowScale( first, firstWidth );
+		quantizeInt8Row( first, firstWidth, rowScale, firstRowBuffer );
+
+		if( customInt8RowByTransposedMatrixFunction != nullptr ) {
+			customInt8RowByTransposedMatrixFunction( firstRowBuffer, second, secondHeight, firstWidth,
+				rowScale, secondScales, result );
+		} else {
+			const signed char* secondRow = second;
+			for( int j = 0; j < secondHeight; ++j ) {
+				result[j] = int8DotProduct( firstRowBuffer, secondRow, firstWidth ) * rowScale * secondScales[j];
+				secondRow += firstWidth;
+			}
+		}
+
+		first += firstWidth;
+		result += secondHeight;
+	}
+}
+
+void CCpuMathEngine::MultiplyMatrixByTransposedInt8Matrix( const CConstFloatHandle& firstHandle, int firstHeight,
+	int firstWidth, float firstScale, const CConstInt8Handle& secondHandle, const CConstFloatHandle& secondScalesHandle,
+	int secondHeight, const CFloatHandle& resultHandle )
+{
+	ASSERT_EXPR( firstHandle.GetMathEngine() == this );
+	ASSERT_EXPR( secondHandle.GetMathEngine() == this );
+	ASSERT_EXPR( secondScalesHandle.GetMathEngine() == this );
+	ASSERT_EXPR( resultHandle.GetMathEngine() == this );
+	ASSERT_EXPR( firstHeight > 0 );
+	ASSERT_EXPR( firstWidth > 0 );
+	ASSERT_EXPR( secondHeight > 0 );
+
+	const float* first = GetRaw( firstHandle );
+	const signed char* second = GetRaw( secondHandle );
+	const float* secondScales = GetRaw( secondScalesHandle );
+	float* result = GetRaw( resultHandle );
+
+	const int curThreadCount = IsOmpRelevant( firstHeight,
+		static_cast<int64_t>( firstHeight ) * firstWidth * secondHeight ) ? threadCount : 1;
+
+	CInt8HandleStackVar buffer( mathEngine(), curThreadCount * firstWidth );
+	signed char* bufferRaw = GetRaw( buffer.GetHandle() );
+
+	NEOML_OMP_NUM_THREADS( curThreadCount )
+	{
+		int start;
+		int count;
+		if( OmpGetTaskIndexAndCount( firstHeight, start, count ) ) {
+			multiplyMatrixByTransposedInt8Matrix( first + start * firstWidth, count, firstWidth, firstScale,
+				bufferRaw + OmpGetThreadNum() * firstWidth, second, secondScales, secondHeight,
+				result + start * secondHeight );
+		}
+	}
+}
+
+} // namespace NeoML
@@ -285,23 +285,9 @@ struct CMatrixMultiplier {
 	static void Multiply(Engine *engine, const CCPUInfo &cpuInfo, const float* aPtr, size_t aRowSize,
 		const float* bPtr, size_t bRowSize, float* cPtr, size_t cRowSize, size_t m, size_t n, size_t k)
 	{
-		// Calculate block size
-		// A and B micro-blocks should fit into L1, same as the micro-kernel result
-		// Several more cache lines may be taken up by the calling function variables
-		size_t kBlock =
-			(cpuInfo.L1CacheSize - Kernel::height * Kernel::width * sizeof(float) - 64 * 4) /
-			((Kernel::height + Kernel::width) * sizeof(float));
-		kBlock = Ceildiv(k, Ceildiv(k, kBlock));
-
-		// 10% L2 should be left for overhead, in addition to L1
-		size_t nBlock = (cpuInfo.L2CacheSize * 90 / 100 - cpuInfo.L1CacheSize) /
-			(kBlock * sizeof(float));
-		nBlock = Ceildiv(n, Ceildiv(n, nBlock));
-		if( nBlock > Kernel::width && nBlock < n ) {
-			nBlock = nBlock / Kernel::width * Kernel::width;
-		} else {
-			nBlock = Kernel::width;
-		}
+		size_t kBlock;
+		size_t nBlock;
+		getBlockSizes(cpuInfo, n, k, kBlock, nBlock);
 
 		// Temporary memory
 		MemoryHandler aTmpHandler(engine, kBlock * Ceildiv(m, Kernel::height) * Kernel::height);
@@ -370,6 +356,84 @@ struct CMatrixMultiplier {
 			}
 		}
 	}
+
+	// The size of the temporary buffer for the A block shared by the threads in MultiplyParallel
+	template<class CCPUInfo>
+	static size_t GetSharedBufferSize(const CCPUInfo &cpuInfo, size_t m, size_t n, size_t k)
+	{
+		size_t kBlock;
+		size_t nBlock;
+		getBlockSizes(cpuInfo, n, k, kBlock, nBlock);
+		return kBlock * Ceildiv(m, Kernel::height) * Kernel::height;
+	}
+
+	// Multithreaded matrix product
+	// Should be called by each of threadCount threads with the same parameters except threadIndex
+	// For each K block the threads prepare the parts of the A block in the shared aTmpBuffer (of GetSharedBufferSize size),
+	// then each thread prepares the B blocks it needs and calculates its own tile of the C matrix
+	// barrier() should return only after it has been called by all the threads
+	template<class CCPUInfo, class Barrier>
+	static void MultiplyParallel(Engine *engine, const CCPUInfo &cpuInfo, float* aTmpBuffer,
+		size_t threadIndex, size_t threadCount, const Barrier& barrier,
+		const float* aPtr, size_t aRowSize, const float* bPtr, size_t bRowSize,
+		float* cPtr, size_t cRowSize, size_t m, size_t n, size_t k)
+	{
+		size_t kBlock;
+		size_t nBlock;
+		getBlockSizes(cpuInfo, n, k, kBlock, nBlock);
+
+		// The tile of C calculated by this thread; the tile borders are aligned to the kernel size
+		size_t mThreads;
+		size_t nThreads;
+		getThreadGrid(m, n, threadCount, mThreads, nThreads);
+		const size_t mPart = Ceildiv(Ceildiv(m, Kernel::height), mThreads) * Kernel::height;
+		const size_t nPart = Ceildiv(Ceildiv(n, Kernel::width), nThreads) * Kernel::width;
+		const size_t mStart = Min(threadIndex / nThreads * mPart, m);
+		const size_t mEnd = Min(mStart + mPart, m);
+		const size_t nStart = Min(threadIndex % nThreads * nPart, n);
+		const size_t nEnd = Min(nStart + nPart, n);
+
+		// The rows of the A block prepared by this thread
+		const size_t aPart = Ceildiv(Ceildiv(m, Kernel::height), threadCount) * Kernel::height;
+		const size_t aStart = Min(threadIndex * aPart, m);
+		const size_t aEnd = Min(aStart + aPart, m);
+
+		MemoryHandler bTmpHandler(engine, kBlock * nBlock);
+		MemoryHandler cTmpHandler(engine, Kernel::height * Kernel::width);
+		float* bTmp = bTmpHandler.get();
+		float* cTmp = cTmpHandler.get();
+
+		const bool APrepared = PreparerA::minHeight == 1 && (!ATransposed || aRowSize == 1) && m == 1;
+		for( size_t kStart = 0; kStart < k; kStart += kBlock ) {
+			const size_t kBlockSize = Min(kBlock, k - kStart);
+			const float* aTmp;
+			if( APrepared ) {
+				aTmp = aPtr + (ATransposed ? kStart * aRowSize : kStart);
+			} else {
+				if( kStart > 0 ) {
+					// The previous A block may still be in use
+					barrier();
+				}
+				if( aStart < aEnd ) {
+					const float* aBlock = ATransposed ? aPtr + kStart * aRowSize + aStart : aPtr + aStart * aRowSize + kStart;
+					PreparerA::Prepare(aTmpBuffer + aStart * kBlockSize, aBlock, aRowSize, aEnd - aStart, kBlockSize);
+				}
+				barrier();
+				aTmp = aTmpBuffer;
+			}
+			if( mStart == mEnd ) {
+				continue;
+			}
+			const float* bBlock = BTransposed ? bPtr + kStart : bPtr + kStart * bRowSize;
+			for( size_t nBlockStart = nStart; nBlockStart < nEnd; nBlockStart += nBlock ) {
+				const size_t nBlockSize = Min(nBlock, nEnd - nBlockStart);
+				const float* bColumn = BTransposed ? bBlock + nBlockStart * bRowSize : bBlock + nBlockStart;
+				PreparerB::Prepare(bTmp, bColumn, bRowSize, kBlockSize, nBlockSize);
+				ProcessKernel<Kernel>(aTmp + mStart * kBlockSize, bTmp, cPtr + mStart * cRowSize + nBlockStart,
+					cRowSize, kBlockSize, cTmp, mEnd - mStart, nBlockSize);
+			}
+		}
+	}
 private:
 	using PreparerA = PreparerAHelper<ATransposed, Kernel, Interleaver>;
 	using PreparerB = PreparerBHelper<BTransposed, Kernel, Interleaver>;
@@ -377,4 +441,53 @@ private:
 	static constexpr size_t Ceildiv(size_t a, size_t b) {
 		return (a + b - 1) / b;
 	}
+	static constexpr size_t Min(size_t a, size_t b) {
+		return a < b ? a : b;
+	}
+
+	// Calculates the block sizes
+	template<class CCPUInfo>
+	static void getBlockSizes(const CCPUInfo &cpuInfo, size_t n, size_t k, size_t& kBlock, size_t& nBlock)
+	{
+		// A and B micro-blocks should fit into L1, same as the micro-kernel result
+		// Several more cache lines may be taken up by the calling function variables
+		const size_t l1Overhead = Kernel::height * Kernel::width * sizeof(float) + 64 * 4;
+		kBlock = cpuInfo.L1CacheSize > l1Overhead ?
+			(cpuInfo.L1CacheSize - l1Overhead) / ((Kernel::height + Kernel::width) * sizeof(float)) : 0;
+		kBlock = Ceildiv(k, Ceildiv(k, kBlock > 0 ? kBlock : 1));
+
+		// 10% L2 should be left for overhead, in addition to L1
+		const size_t l2Available = cpuInfo.L2CacheSize * 90 / 100;
+		nBlock = l2Available > cpuInfo.L1CacheSize ?
+			(l2Available - cpuInfo.L1CacheSize) / (kBlock * sizeof(float)) : 0;
+		nBlock = Ceildiv(n, Ceildiv(n, nBlock > 0 ? nBlock : 1));
+		if( nBlock > Kernel::width && nBlock < n ) {
+			nBlock = nBlock / Kernel::width * Kernel::width;
+		} else {
+			nBlock = Kernel::width;
+		}
+	}
+
+	// Splits the threads into a grid of mThreads * nThreads tiles of C so that the largest tile is the smallest possible
+	// Of the equal variants the one with fewer rows is chosen, because the threads in a column of the grid prepare the same B blocks
+	static void getThreadGrid(size_t m, size_t n, size_t threadCount, size_t& mThreads, size_t& nThreads)
+	{
+		const size_t mKernels = Ceildiv(m, Kernel::height);
+		const size_t nKernels = Ceildiv(n, Kernel::width);
+		mThreads = 1;
+		nThreads = threadCount;
+		size_t bestTileSize = mKernels * Ceildiv(nKernels, threadCount) * Kernel::height * Kernel::width;
+		for( size_t mCount = 2; mCount <= threadCount; ++mCount ) {
+			if( threadCount % mCount != 0 ) {
+				continue;
+			}
+			const size_t nCount = threadCount / mCount;
+			const size_t tileSize = Ceildiv(mKernels, mCount) * Ceildiv(nKernels, nCount) * Kernel::height * Kernel::width;
+			if( tileSize < bestTileSize ) {
+				bestTileSize = tileSize;
+				mThreads = mCount;
+				nThreads = nCount;
+			}
+		}
+	}
 };
@@ -66,4 +66,24 @@ inline void MultiplyMatrix(Engine *engine, const CCPUInfo &cpuInfo,
 {
 	CMatrixMultiplier<CMicroKernelDefault, CInterleaverDefault, ATransposed, BTransposed, MemoryHandler, Engine>::Multiply
 		(engine, cpuInfo, aPtr, aRowSize, bPtr, bRowSize, cPtr, cRowSize, m, n, k);
-}
\ No newline at end of file
+}
+
+template<bool ATransposed, bool BTransposed, class MemoryHandler, class Engine, class CCPUInfo>
+inline size_t GetMultiplyMatrixParallelBufferSize(const CCPUInfo &cpuInfo, size_t m, size_t n, size_t k)
+{
+	return CMatrixMultiplier<CMicroKernelDefault, CInterleaverDefault, ATransposed, BTransposed, MemoryHandler, Engine>::GetSharedBufferSize
+		(cpuInfo, m, n, k);
+}
+
+// Should be called by each of threadCount threads, see CMatrixMultiplier::MultiplyParallel
+template<bool ATransposed, bool BTransposed, class MemoryHandler, class Engine, class CCPUInfo, class Barrier>
+inline void MultiplyMatrixParallel(Engine *engine, const CCPUInfo &cpuInfo, float* sharedBuffer,
+	size_t threadIndex, size_t threadCount, const Barrier& barrier,
+	const float* aPtr, size_t aRowSize,
+	const float* bPtr, size_t bRowSize,
+	float* cPtr, size_t cRowSize,
+	size_t m, size_t n, size_t k)
+{
+	CMatrixMultiplier<CMicroKernelDefault, CInterleaverDefault, ATransposed, BTransposed, MemoryHandler, Engine>::MultiplyParallel
+		(engine, cpuInfo, sharedBuffer, threadIndex, threadCount, barrier, aPtr, aRowSize, bPtr, bRowSize, cPtr, cRowSize, m, n, k);
+}
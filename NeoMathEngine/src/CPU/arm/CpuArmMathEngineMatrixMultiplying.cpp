@@ -26,13 +26,16 @@ limitations under the License.
 #include <MathEngineCommon.h>
 #include <CpuMathEngine.h>
 
-// There is no way to find out the cache size for ARM
-// Use a set value
-// These constants helped speed up performance of some of the testing devices
-static constexpr CCPUInfo CpuInfo(0x8000, 0x20000);
-
 namespace NeoML {
 
+// The cache sizes set for the engine
+static inline CCPUInfo getCpuInfo( const IMathEngine& engine )
+{
+	CCpuCacheSizes cacheSizes;
+	engine.GetCpuCacheSizes( cacheSizes );
+	return CCPUInfo( cacheSizes.L1, cacheSizes.L2, cacheSizes.L3 );
+}
+
 void CCpuMathEngine::multiplyMatrixByMatrix(const float* first, int firstHeight,
 	int firstWidth, int firstRowSize, const float* second, int secondWidth, int secondRowSize,
 	float* result, int resultRowSize)
@@ -42,7 +45,7 @@ void CCpuMathEngine::multiplyMatrixByMatrix(const float* first, int firstHeight,
 	ASSERT_EXPR(secondWidth <= resultRowSize);
 
 	nullify(result, firstHeight, secondWidth, resultRowSize);
-	MultiplyMatrix<false, false, CTmpMemoryHandler>(this, CpuInfo, first, firstRowSize, second, secondRowSize,
+	MultiplyMatrix<false, false, CTmpMemoryHandler>(this, getCpuInfo(*this), first, firstRowSize, second, secondRowSize,
 		result, resultRowSize, firstHeight, secondWidth, firstWidth);
 }
 
@@ -53,7 +56,7 @@ void CCpuMathEngine::multiplyMatrixByMatrixAndAdd(const float* first, int firstH
 	ASSERT_EXPR(firstWidth <= firstRowSize);
 	ASSERT_EXPR(secondWidth <= resultRowSize);
 
-	MultiplyMatrix<false, false, CTmpMemoryHandler>(this, CpuInfo, first, firstRowSize, second, secondRowSize,
+	MultiplyMatrix<false, false, CTmpMemoryHandler>(this, getCpuInfo(*this), first, firstRowSize, second, secondRowSize,
 		result, resultRowSize, firstHeight, secondWidth, firstWidth);
 }
 
@@ -66,14 +69,14 @@ void CCpuMathEngine::multiplyMatrixByTransposedMatrix(const float* first, int fi
 	ASSERT_EXPR(secondHeight <= resultRowSize);
 
 	nullify(result, firstHeight, secondHeight, resultRowSize);
-	MultiplyMatrix<false, true, CTmpMemoryHandler>(this, CpuInfo, first, firstRowSize, second, secondRowSize,
+	MultiplyMatrix<false, true, CTmpMemoryHandler>(this, getCpuInfo(*this), first, firstRowSize, second, secondRowSize,
 		result, resultRowSize, firstHeight, secondHeight, firstWidth);
 }
 
 void CCpuMathEngine::multiplyMatrixByTransposedMatrixAndAdd( const float* first, int firstHeight, int firstWidth, int firstRowSize,
 	const float* second, int secondHeight, int secondRowSize, float* result, int resultRowSize )
 {
-	MultiplyMatrix<false, true, CTmpMemoryHandler>(this, CpuInfo, first, firstRowSize, second, secondRowSize,
+	MultiplyMatrix<false, true, CTmpMemoryHandler>(this, getCpuInfo(*this), first, firstRowSize, second, secondRowSize,
 		result, resultRowSize, firstHeight, secondHeight, firstWidth);
 }
 
@@ -85,7 +88,7 @@ void CCpuMathEngine::multiplyTransposedMatrixByMatrix(const float* first, int fi
 	auto secondRowSize = secondWidth;
 	auto resultRowSize = secondWidth;
 	nullify(result, firstWidth, secondWidth);
-	MultiplyMatrix<true, false, CTmpMemoryHandler>(this, CpuInfo, first, firstRowSize, second, secondRowSize,
+	MultiplyMatrix<true, false, CTmpMemoryHandler>(this, getCpuInfo(*this), first, firstRowSize, second, secondRowSize,
 		result, resultRowSize, firstWidth, secondWidth, firstHeight);
 }
 
@@ -97,7 +100,7 @@ void CCpuMathEngine::multiplyTransposedMatrixByMatrixAndAdd(const float* first,
 	ASSERT_EXPR(secondWidth <= secondRowSize);
 	ASSERT_EXPR(secondWidth <= resultRowSize);
 
-	MultiplyMatrix<true, false, CTmpMemoryHandler>(this, CpuInfo, first, firstRowSize, second, secondRowSize,
+	MultiplyMatrix<true, false, CTmpMemoryHandler>(this, getCpuInfo(*this), first, firstRowSize, second, secondRowSize,
 		result, resultRowSize, firstWidth, secondWidth, firstHeight);
 }
 
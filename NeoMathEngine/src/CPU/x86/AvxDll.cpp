@@ -67,6 +67,28 @@ static std::string getModuleDir()
 #endif
 	return result;
 }
+
+// The full path to the library with the given name, located in the same directory as this module
+static std::string getLibraryPath( const char* name )
+{
+	std::string libraryPath( getModuleDir() );
+#if FINE_PLATFORM( FINE_WINDOWS )
+	libraryPath += name;
+	libraryPath += ".dll";
+#elif FINE_PLATFORM( FINE_LINUX )
+	libraryPath += "lib";
+	libraryPath += name;
+	libraryPath += ".so";
+#elif FINE_PLATFORM( FINE_DARWIN )
+	libraryPath += "lib";
+	libraryPath += name;
+	libraryPath += ".dylib";
+#else
+	#error "Platform isn't supported!"
+#endif
+	return libraryPath;
+}
+
 namespace NeoML {
 
 CAvxDll::CAvxDll() :
@@ -85,22 +107,17 @@ bool CAvxDll::Load()
 		return true;
 	}
 
-	if( !isAvxAvailable() ) {
+	if( isAvx512Available() ) {
+		// The AVX-512 library is optional; without it the processor uses the common code as before
+		if( !CDll::Load( getLibraryPath( "NeoMathEngineAvx512" ).c_str() ) ) {
+			return false;
+		}
+	} else if( isAvxAvailable() ) {
+		ASSERT_EXPR( CDll::Load( getLibraryPath( "NeoMathEngineAvx" ).c_str() ) );
+	} else {
 		return false;
 	}
 
-	std::string dllPath( getModuleDir() );
-#if FINE_PLATFORM( FINE_WINDOWS )
-	dllPath += "NeoMathEngineAvx.dll";
-#elif FINE_PLATFORM( FINE_LINUX )
-	dllPath += "libNeoMathEngineAvx.so";
-#elif FINE_PLATFORM( FINE_DARWIN )
-	dllPath += "libNeoMathEngineAvx.dylib";
-#else
-	#error "Platform isn't supported!"
-#endif
-	ASSERT_EXPR( CDll::Load( dllPath.c_str() ) );
-
 	ASSERT_EXPR( loadFunctions() );
 
 	return true;
@@ -141,4 +158,14 @@ bool CAvxDll::isAvxAvailable()
 	return res;
 }
 
+bool CAvxDll::isAvx512Available()
+{
+#if defined(_MSC_VER) && _MSC_VER < 1925
+	return false;
+#endif
+
+	static bool res = CCPUInfo::IsAvxAndFmaAvailable() && CCPUInfo::IsAvx512Available();
+	return res;
+}
+
 } // namespace NeoML
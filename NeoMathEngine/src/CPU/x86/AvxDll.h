@@ -46,6 +46,7 @@ private:
 
 	bool loadFunctions();
 	static bool isAvxAvailable();
+	static bool isAvx512Available();
 };
 
 } // namespace NeoML
\ No newline at end of file
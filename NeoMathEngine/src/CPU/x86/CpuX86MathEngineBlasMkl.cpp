@@ -36,15 +36,75 @@ limitations under the License.
 #else
 #include <CPUInfo.h>
 #include <MatrixMultiplyingInterleavedCommon/MatrixMultiplying.h>
-
-// Cache sizes
-// Find the acceptable values or get them from CPU info
-static constexpr CCPUInfo CpuInfo( 0x60000, 0x180000, 0x900000 );
 #endif
 #include <MatrixMultiplyingInterleavedCommon/CpuMemoryHelper.h>
 
 namespace NeoML {
 
+// Multiplies the matrices by the function from the SIMD library, splitting the rows of the result between the threads
+// The row blocks are aligned to the height of the micro-kernels so that each thread uses the widest kernels
+// If called inside a parallel region, uses only the calling thread
+template<bool ATransposed, bool BTransposed>
+static void multiplyMatrixCustom( SgemmFunc sgemmFunction, IMathEngine* engine, int threadCount,
+	const float* aPtr, size_t aRowSize, const float* bPtr, size_t bRowSize,
+	float* cPtr, size_t cRowSize, size_t m, size_t n, size_t k )
+{
+	const int RowAlign = 12;
+	const int rowCount = static_cast<int>( m );
+	const int curThreadCount = OmpGetThreadCount() == 1 && IsOmpRelevant( ( rowCount + RowAlign - 1 ) / RowAlign,
+		static_cast<int64_t>( m ) * n * k ) ? threadCount : 1;
+	if( curThreadCount == 1 ) {
+		sgemmFunction( ATransposed, BTransposed, engine, aPtr, aRowSize, bPtr, bRowSize, cPtr, cRowSize, m, n, k );
+		return;
+	}
+
+	NEOML_OMP_NUM_THREADS( curThreadCount )
+	{
+		int rowIndex;
+		int rowTaskCount;
+		if( OmpGetTaskIndexAndCount( rowCount, RowAlign, rowIndex, rowTaskCount ) ) {
+			const float* aRows = ATransposed ? aPtr + rowIndex : aPtr + rowIndex * aRowSize;
+			sgemmFunction( ATransposed, BTransposed, engine, aRows, aRowSize, bPtr, bRowSize,
+				cPtr + rowIndex * cRowSize, cRowSize, rowTaskCount, n, k );
+		}
+	}
+}
+
+#ifndef NEOML_USE_MKL
+
+// Multiplies the matrices by the built-in algorithm using several threads if it makes sense
+// If called inside a parallel region, uses only the calling thread
+template<bool ATransposed, bool BTransposed>
+static void multiplyMatrixInterleaved( CCpuMathEngine* engine, int threadCount,
+	const float* aPtr, size_t aRowSize, const float* bPtr, size_t bRowSize,
+	float* cPtr, size_t cRowSize, size_t m, size_t n, size_t k )
+{
+	CCpuCacheSizes cacheSizes;
+	engine->GetCpuCacheSizes( cacheSizes );
+	const CCPUInfo cpuInfo( cacheSizes.L1, cacheSizes.L2, cacheSizes.L3 );
+
+	const int curThreadCount = OmpGetThreadCount() == 1
+		&& IsOmpRelevant( threadCount, static_cast<int64_t>( m ) * n * k ) ? threadCount : 1;
+	if( curThreadCount == 1 ) {
+		MultiplyMatrix<ATransposed, BTransposed, CTmpMemoryHandler>( engine, cpuInfo, aPtr, aRowSize, bPtr, bRowSize,
+			cPtr, cRowSize, m, n, k );
+		return;
+	}
+
+	// The threads prepare the blocks of the A matrix together
+	CFloatHandleStackVar sharedBuffer( *engine,
+		GetMultiplyMatrixParallelBufferSize<ATransposed, BTransposed, CTmpMemoryHandler, CCpuMathEngine>( cpuInfo, m, n, k ) );
+	float* sharedBufferRaw = GetRaw( sharedBuffer.GetHandle() );
+	NEOML_OMP_NUM_THREADS( curThreadCount )
+	{
+		MultiplyMatrixParallel<ATransposed, BTransposed, CTmpMemoryHandler>( engine, cpuInfo, sharedBufferRaw,
+			OmpGetThreadNum(), OmpGetThreadCount(), []() { NEOML_OMP_BARRIER( true ); },
+			aPtr, aRowSize, bPtr, bRowSize, cPtr, cRowSize, m, n, k );
+	}
+}
+
+#endif // !NEOML_USE_MKL
+
 void CCpuMathEngine::multiplyMatrixByMatrix( const float* first, int firstHeight,
 	int firstWidth, int firstRowSize, const float* second, int secondWidth, int secondRowSize,
 	float* result, int resultRowSize )
@@ -55,7 +115,7 @@ void CCpuMathEngine::multiplyMatrixByMatrix( const float* first, int firstHeight
 
 	if( customSgemmFunction != nullptr ) {
 		nullify( result, firstHeight, secondWidth, resultRowSize );
-		customSgemmFunction( false, false, this, first, firstRowSize, second, secondRowSize,
+		multiplyMatrixCustom<false, false>( customSgemmFunction, this, threadCount, first, firstRowSize, second, secondRowSize,
 			result, resultRowSize, firstHeight, secondWidth, firstWidth );
 	} else {
 #ifdef NEOML_USE_MKL
@@ -63,7 +123,7 @@ void CCpuMathEngine::multiplyMatrixByMatrix( const float* first, int firstHeight
 			1, first, firstRowSize, second, secondRowSize, 0, result, resultRowSize );
 #else
 		nullify( result, firstHeight, secondWidth, resultRowSize );
-		MultiplyMatrix<false, false, CTmpMemoryHandler>( this, CpuInfo, first, firstRowSize, second, secondRowSize,
+		multiplyMatrixInterleaved<false, false>( this, threadCount, first, firstRowSize, second, secondRowSize,
 			result, resultRowSize, firstHeight, secondWidth, firstWidth );
 #endif
 	}
@@ -77,14 +137,14 @@ void CCpuMathEngine::multiplyMatrixByMatrixAndAdd( const float* first, int first
 	ASSERT_EXPR( secondWidth <= resultRowSize );
 
 	if( customSgemmFunction != nullptr ) {
-		customSgemmFunction( false, false, this, first, firstRowSize, second, secondRowSize,
+		multiplyMatrixCustom<false, false>( customSgemmFunction, this, threadCount, first, firstRowSize, second, secondRowSize,
 			result, resultRowSize, firstHeight, secondWidth, firstWidth );
 	} else {
 #ifdef NEOML_USE_MKL
 		cblas_sgemm( CblasRowMajor, CblasNoTrans, CblasNoTrans, firstHeight, secondWidth, firstWidth,
 			1, first, firstRowSize, second, secondRowSize, 1, result, resultRowSize );
 #else
-		MultiplyMatrix<false, false, CTmpMemoryHandler>( this, CpuInfo, first, firstRowSize, second, secondRowSize,
+		multiplyMatrixInterleaved<false, false>( this, threadCount, first, firstRowSize, second, secondRowSize,
 			result, resultRowSize, firstHeight, secondWidth, firstWidth );
 #endif
 	}
@@ -99,7 +159,7 @@ void CCpuMathEngine::multiplyMatrixByTransposedMatrix(const float* first, int fi
 
 	if( customSgemmFunction != nullptr ) {
 		nullify( result, firstHeight, secondHeight, resultRowSize );
-		customSgemmFunction( false, true, this, first, firstRowSize, second, secondRowSize,
+		multiplyMatrixCustom<false, true>( customSgemmFunction, this, threadCount, first, firstRowSize, second, secondRowSize,
 			result, resultRowSize, firstHeight, secondHeight, firstWidth );
 	} else {
 #ifdef NEOML_USE_MKL
@@ -107,7 +167,7 @@ void CCpuMathEngine::multiplyMatrixByTransposedMatrix(const float* first, int fi
 			1, first, firstRowSize, second, secondRowSize, 0, result, resultRowSize);
 #else
 		nullify( result, firstHeight, secondHeight, resultRowSize );
-		MultiplyMatrix<false, true, CTmpMemoryHandler>( this, CpuInfo, first, firstRowSize, second, secondRowSize,
+		multiplyMatrixInterleaved<false, true>( this, threadCount, first, firstRowSize, second, secondRowSize,
 			result, resultRowSize, firstHeight, secondHeight, firstWidth );
 #endif
 	}
@@ -118,14 +178,14 @@ void CCpuMathEngine::multiplyMatrixByTransposedMatrixAndAdd( const float* first,
 	float* result, int resultRowSize )
 {
 	if( customSgemmFunction != nullptr ) {
-		customSgemmFunction( false, true, this, first, firstRowSize, second, secondRowSize,
+		multiplyMatrixCustom<false, true>( customSgemmFunction, this, threadCount, first, firstRowSize, second, secondRowSize,
 			result, resultRowSize, firstHeight, secondHeight, firstWidth );
 	} else  {
 #ifdef NEOML_USE_MKL
 		cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasTrans, firstHeight, secondHeight, firstWidth,
 			1, first, firstRowSize, second, secondRowSize, 1, result, resultRowSize);
 #else
-		MultiplyMatrix<false, true, CTmpMemoryHandler>( this, CpuInfo, first, firstRowSize, second, secondRowSize,
+		multiplyMatrixInterleaved<false, true>( this, threadCount, first, firstRowSize, second, secondRowSize,
 			result, resultRowSize, firstHeight, secondHeight, firstWidth );
 #endif
 	}
@@ -231,7 +291,7 @@ void CCpuMathEngine::multiplyTransposedMatrixByMatrix(const float* first, int fi
 		auto secondRowSize = secondWidth;
 		auto resultRowSize = secondWidth;
 		nullify( result, firstWidth, secondWidth );
-		customSgemmFunction( true, false, this, first, firstRowSize, second, secondRowSize,
+		multiplyMatrixCustom<true, false>( customSgemmFunction, this, threadCount, first, firstRowSize, second, secondRowSize,
 					 result, resultRowSize, firstWidth, secondWidth, firstHeight );
 	} else {
 #ifdef NEOML_USE_MKL
@@ -242,7 +302,7 @@ void CCpuMathEngine::multiplyTransposedMatrixByMatrix(const float* first, int fi
 		auto secondRowSize = secondWidth;
 		auto resultRowSize = secondWidth;
 		nullify( result, firstWidth, secondWidth );
-		MultiplyMatrix<true, false, CTmpMemoryHandler>( this, CpuInfo, first, firstRowSize, second, secondRowSize,
+		multiplyMatrixInterleaved<true, false>( this, threadCount, first, firstRowSize, second, secondRowSize,
 			result, resultRowSize, firstWidth, secondWidth, firstHeight );
 #endif
 	}
@@ -257,14 +317,14 @@ void CCpuMathEngine::multiplyTransposedMatrixByMatrixAndAdd(const float* first,
 	ASSERT_EXPR(secondWidth <= secondRowSize);
 	ASSERT_EXPR(secondWidth <= resultRowSize);
 	if( customSgemmFunction != nullptr ) {
-		customSgemmFunction( true, false, this, first, firstRowSize, second, secondRowSize,
+		multiplyMatrixCustom<true, false>( customSgemmFunction, this, threadCount, first, firstRowSize, second, secondRowSize,
 					 result, resultRowSize, firstWidth, secondWidth, firstHeight );
 	} else {
 #ifdef NEOML_USE_MKL
 		cblas_sgemm(CblasRowMajor, CblasTrans, CblasNoTrans, firstWidth, secondWidth, firstHeight,
 			1, first, firstRowSize, second, secondRowSize, 1, result, resultRowSize);
 #else
-		MultiplyMatrix<true, false, CTmpMemoryHandler>( this, CpuInfo, first, firstRowSize, second, secondRowSize,
+		multiplyMatrixInterleaved<true, false>( this, threadCount, first, firstRowSize, second, secondRowSize,
 			result, resultRowSize, firstWidth, secondWidth, firstHeight );
 #endif
 	}
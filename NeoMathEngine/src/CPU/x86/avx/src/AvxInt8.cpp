@@ -0,0 +1,36 @@
+/* Copyright © 2017-2021 ABBYY Production LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+--------------------------------------------------------------------------------------------------------------*/
+
+#include <common.h>
+#pragma hdrstop
+
+#include <AvxInt8.h>
+
+namespace NeoML {
+
+// The AVX2 version: the pairs of the products are summed into int16 and then into int32
+// The pair of the products is at most 2 * 127 * 127, so the int16 sum is never saturated
+void Avx2Int8RowByTransposedMatrix( const signed char* row, const signed char* matrix, int height, int width,
+	float rowScale, const float* scales, float* result )
+{
+	const __m256i ones = _mm256_set1_epi16( 1 );
+	Int8RowByTransposedMatrix( row, matrix, height, width, rowScale, scales, result,
+		[&ones]( const __m256i& sum, const __m256i& first, const __m256i& second )
+		{
+			return _mm256_add_epi32( sum, _mm256_madd_epi16( _mm256_maddubs_epi16( first, second ), ones ) );
+		} );
+}
+
+} // namespace NeoML
@@ -0,0 +1,51 @@
+/* Copyright © 2017-2021 ABBYY Production LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+--------------------------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <immintrin.h>
+
+namespace NeoML {
+
+// Multiplies the int8 row by the transposed int8 matrix accumulating in int32
+// and writes the products scaled by rowScale * scales[j] into the result
+// The values must be in [-127, 127]
+// TDot( sum, first, second ) adds the products of the unsigned first and signed second values to the eight int32 sums
+template<class TDot>
+static inline void Int8RowByTransposedMatrix( const signed char* row, const signed char* matrix, int height, int width,
+	float rowScale, const float* scales, float* result, TDot dot )
+{
+	const int vectorWidth = width / 32 * 32;
+	for( int j = 0; j < height; ++j ) {
+		const signed char* matrixRow = matrix + j * width;
+		__m256i sum = _mm256_setzero_si256();
+		for( int k = 0; k < vectorWidth; k += 32 ) {
+			const __m256i rowValues = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( row + k ) );
+			const __m256i matrixValues = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( matrixRow + k ) );
+			// a * b == |a| * ( b * sign( a ) ), so the unsigned by signed multiplication may be used
+			sum = dot( sum, _mm256_sign_epi8( rowValues, rowValues ), _mm256_sign_epi8( matrixValues, rowValues ) );
+		}
+		__m128i sum128 = _mm_add_epi32( _mm256_castsi256_si128( sum ), _mm256_extracti128_si256( sum, 1 ) );
+		sum128 = _mm_add_epi32( sum128, _mm_shuffle_epi32( sum128, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+		sum128 = _mm_add_epi32( sum128, _mm_shuffle_epi32( sum128, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+		int value = _mm_cvtsi128_si32( sum128 );
+		for( int k = vectorWidth; k < width; ++k ) {
+			value += static_cast<int>( row[k] ) * static_cast<int>( matrixRow[k] );
+		}
+		result[j] = value * rowScale * scales[j];
+	}
+}
+
+} // namespace NeoML
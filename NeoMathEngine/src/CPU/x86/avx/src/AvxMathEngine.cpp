@@ -18,6 +18,7 @@ limitations under the License.
 
 #include <NeoMathEngine/SimdMathEngine.h>
 #include <BlobConvolution.h>
+#include <CPUInfo.h>
 
 namespace NeoML {
 
@@ -28,6 +29,13 @@ void AvxMultiplyMatrix( bool transA, bool transB,
 	float* cPtr, size_t cRowSize,
 	size_t m, size_t n, size_t k );
 
+void Avx2Int8RowByTransposedMatrix( const signed char* row, const signed char* matrix, int height, int width,
+	float rowScale, const float* scales, float* result );
+#ifdef NEOML_USE_AVX_VNNI
+void AvxVnniInt8RowByTransposedMatrix( const signed char* row, const signed char* matrix, int height, int width,
+	float rowScale, const float* scales, float* result );
+#endif
+
 struct CAvxConvolutionDesc : public CConvolutionDesc {
 	~CAvxConvolutionDesc() override {}
 
@@ -59,6 +67,8 @@ public:
 
 	SgemmFunc GetSgemmFunction() const override;
 
+	Int8RowByTransposedMatrixFunc GetInt8RowByTransposedMatrixFunction() const override;
+
 private:
 	IMathEngine* mathEngine;
 	int threadCount;
@@ -88,6 +98,19 @@ SgemmFunc CAvxMathEngine::GetSgemmFunction() const
 	return AvxMultiplyMatrix;
 }
 
+Int8RowByTransposedMatrixFunc CAvxMathEngine::GetInt8RowByTransposedMatrixFunction() const
+{
+#ifdef NEOML_USE_AVX_VNNI
+	if( CCPUInfo::IsAvxVnniAvailable() ) {
+		return AvxVnniInt8RowByTransposedMatrix;
+	}
+#endif
+	if( CCPUInfo::IsAvx2Available() ) {
+		return Avx2Int8RowByTransposedMatrix;
+	}
+	return nullptr;
+}
+
 extern "C"
 FME_DLL_EXPORT
 ISimdMathEngine* CreateSimdMathEngine( IMathEngine* mathEngine, int threadCount )
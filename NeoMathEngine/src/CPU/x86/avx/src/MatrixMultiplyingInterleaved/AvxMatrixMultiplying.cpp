@@ -41,7 +41,9 @@ void AvxMultiplyMatrixSelected( bool transA, bool transB,
 	float* cPtr, size_t cRowSize,
 	size_t m, size_t n, size_t k )
 {
-	static const CCPUInfo& cpuinfo = CCPUInfo::GetCPUInfo();
+	CCpuCacheSizes cacheSizes;
+	engine->GetCpuCacheSizes( cacheSizes );
+	const CCPUInfo cpuinfo( cacheSizes.L1, cacheSizes.L2, cacheSizes.L3 );
 
 	unsigned char transSelector = ( transA ? 0b10 : 0 ) + ( transB ? 0b01 : 0 );
 	switch( transSelector ) {
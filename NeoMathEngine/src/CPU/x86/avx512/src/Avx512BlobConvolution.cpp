@@ -0,0 +1,215 @@
+/* Copyright © 2017-2021 ABBYY Production LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+--------------------------------------------------------------------------------------------------------------*/
+
+#include <common.h>
+#pragma hdrstop
+
+#include <Avx512BlobConvolution.h>
+#include <NeoMathEngine/OpenMP.h>
+
+namespace NeoML {
+
+// The number of zmm registers used for the result pixels
+static const int ResultVectorCount = 24;
+
+CAvx512BlobConvolution::CAvx512BlobConvolution( IMathEngine* _mathEngine, int _filterCount, int _channelCount,
+		int _filterHeight, int _filterWidth, int _sourceHeight, int _sourceWidth, int _paddingHeight, int _paddingWidth,
+		int _strideHeight, int _strideWidth, int _dilationHeight, int _dilationWidth,
+		int _resultHeight, int _resultWidth, int _resultObjectCount ) :
+	mathEngine( _mathEngine ),
+	filterCount( _filterCount ),
+	channelCount( _channelCount ),
+	filterHeight( _filterHeight ),
+	filterWidth( _filterWidth ),
+	sourceHeight( _sourceHeight ),
+	sourceWidth( _sourceWidth ),
+	paddingHeight( _paddingHeight ),
+	paddingWidth( _paddingWidth ),
+	strideHeight( _strideHeight ),
+	strideWidth( _strideWidth ),
+	dilationHeight( _dilationHeight ),
+	dilationWidth( _dilationWidth ),
+	resultHeight( _resultHeight ),
+	resultWidth( _resultWidth ),
+	resultObjectCount( _resultObjectCount ),
+	vectorCount( ( _filterCount + 15 ) / 16 ),
+	alignedFilterCount( vectorCount * 16 )
+{
+	// The first column which doesn't need the left padding
+	centralBegin = min( ( paddingWidth + strideWidth - 1 ) / strideWidth, resultWidth );
+	// The column after the last one which doesn't need the right padding
+	const int lastStart = sourceWidth - 1 - ( filterWidth - 1 ) * dilationWidth + paddingWidth;
+	centralEnd = lastStart < 0 ? 0 : min( lastStart / strideWidth + 1, resultWidth );
+	centralEnd = max( centralEnd, centralBegin );
+}
+
+bool CAvx512BlobConvolution::IsAvailable( int filterCount, int filterHeight, int filterWidth )
+{
+	return filterHeight == 3 && filterWidth == 3 && filterCount >= 6 && filterCount <= 32;
+}
+
+void CAvx512BlobConvolution::Process( int threadCount, const float* source, const float* filter, const float* freeTerm,
+	float* result ) const
+{
+	const int filterSize = filterHeight * filterWidth * channelCount * alignedFilterCount;
+	CFloatHandleStackVar buffer( *mathEngine, filterSize + alignedFilterCount );
+	float* rearrangedFilter = static_cast<float*>( mathEngine->GetBuffer( buffer.GetHandle(), 0,
+		buffer.Size() * sizeof( float ), false ) );
+	rearrangeFilter( filter, rearrangedFilter );
+
+	// The free term padded with zeros in the same way as the filter
+	float* alignedFreeTerm = rearrangedFilter + filterSize;
+	for( int f = 0; f < alignedFilterCount; f++ ) {
+		alignedFreeTerm[f] = ( freeTerm != nullptr && f < filterCount ) ? freeTerm[f] : 0.f;
+	}
+
+	const int sourceObjectSize = sourceHeight * sourceWidth * channelCount;
+	const int resultRowSize = resultWidth * filterCount;
+	const int resultRowCount = resultObjectCount * resultHeight;
+	const int curThreadCount = IsOmpRelevant( resultRowCount,
+		static_cast<int64_t>( resultRowCount ) * resultRowSize * filterHeight * filterWidth * channelCount ) ? threadCount : 1;
+
+	NEOML_OMP_NUM_THREADS( curThreadCount )
+	{
+		int rowIndex;
+		int rowCount;
+		if( OmpGetTaskIndexAndCount( resultRowCount, rowIndex, rowCount ) ) {
+			for( int row = rowIndex; row < rowIndex + rowCount; row++ ) {
+				const float* objectSource = source + ( row / resultHeight ) * sourceObjectSize;
+				float* rowResult = result + row * resultRowSize;
+				if( vectorCount == 1 ) {
+					processRow<1>( objectSource, rearrangedFilter, alignedFreeTerm, rowResult, row % resultHeight );
+				} else {
+					processRow<2>( objectSource, rearrangedFilter, alignedFreeTerm, rowResult, row % resultHeight );
+				}
+			}
+		}
+	}
+}
+
+// Rearranges the filter so that the values of all filters for one pixel and channel are stored together:
+// Pixel[0] Channel[0] Filter[0..alignedFilterCount)
+// Pixel[0] Channel[1] Filter[0..alignedFilterCount)
+// ...
+// The filters after filterCount are zeros
+void CAvx512BlobConvolution::rearrangeFilter( const float* filter, float* result ) const
+{
+	const int filterObjectSize = filterHeight * filterWidth * channelCount;
+	for( int i = 0; i < filterObjectSize; i++ ) {
+		for( int f = 0; f < filterCount; f++ ) {
+			*result++ = filter[f * filterObjectSize + i];
+		}
+		for( int f = filterCount; f < alignedFilterCount; f++ ) {
+			*result++ = 0.f;
+		}
+	}
+}
+
+// Calculates one row of the result
+// The pixels which have the whole filter window inside the source are processed in groups
+template<int VectorCount>
+void CAvx512BlobConvolution::processRow( const float* source, const float* filter, const float* freeTerm,
+	float* result, int ry ) const
+{
+	constexpr int WidePixelCount = ResultVectorCount / VectorCount;
+	constexpr int NarrowPixelCount = 4;
+
+	const int sy = ry * strideHeight - paddingHeight;
+	int kyBegin;
+	int kyEnd;
+	getWindowRange( sy, dilationHeight, filterHeight, sourceHeight, kyBegin, kyEnd );
+
+	int rx = 0;
+	for( ; rx < resultWidth; rx++ ) {
+		if( rx == centralBegin ) {
+			for( ; rx + WidePixelCount <= centralEnd; rx += WidePixelCount ) {
+				processPixels<VectorCount, WidePixelCount>( source, filter, freeTerm, result + rx * filterCount,
+					sy, kyBegin, kyEnd, rx * strideWidth - paddingWidth, 0, filterWidth );
+			}
+			for( ; rx + NarrowPixelCount <= centralEnd; rx += NarrowPixelCount ) {
+				processPixels<VectorCount, NarrowPixelCount>( source, filter, freeTerm, result + rx * filterCount,
+					sy, kyBegin, kyEnd, rx * strideWidth - paddingWidth, 0, filterWidth );
+			}
+			if( rx == resultWidth ) {
+				break;
+			}
+		}
+		const int sx = rx * strideWidth - paddingWidth;
+		int kxBegin;
+		int kxEnd;
+		getWindowRange( sx, dilationWidth, filterWidth, sourceWidth, kxBegin, kxEnd );
+		processPixels<VectorCount, 1>( source, filter, freeTerm, result + rx * filterCount,
+			sy, kyBegin, kyEnd, sx, kxBegin, kxEnd );
+	}
+}
+
+// Calculates PixelCount consecutive pixels of the result
+// sy and sx are the source coordinates of the top left corner of the first pixel's window
+// Only the filter rows [kyBegin, kyEnd) and columns [kxBegin, kxEnd) are used
+template<int VectorCount, int PixelCount>
+void CAvx512BlobConvolution::processPixels( const float* source, const float* filter, const float* freeTerm,
+	float* result, int sy, int kyBegin, int kyEnd, int sx, int kxBegin, int kxEnd ) const
+{
+	const int sourcePixelStep = strideWidth * channelCount;
+
+	__m512 r[PixelCount][VectorCount];
+	for( int j = 0; j < VectorCount; j++ ) {
+		const __m512 freeTermValue = _mm512_loadu_ps( freeTerm + 16 * j );
+		for( int p = 0; p < PixelCount; p++ ) {
+			r[p][j] = freeTermValue;
+		}
+	}
+
+	for( int ky = kyBegin; ky < kyEnd; ky++ ) {
+		const float* sourceLine = source + ( sy + ky * dilationHeight ) * sourceWidth * channelCount;
+		for( int kx = kxBegin; kx < kxEnd; kx++ ) {
+			const float* sourcePixel = sourceLine + ( sx + kx * dilationWidth ) * channelCount;
+			const float* filterPixel = filter + ( ky * filterWidth + kx ) * channelCount * alignedFilterCount;
+			for( int c = 0; c < channelCount; c++ ) {
+				__m512 f[VectorCount];
+				for( int j = 0; j < VectorCount; j++ ) {
+					f[j] = _mm512_loadu_ps( filterPixel + 16 * j );
+				}
+				for( int p = 0; p < PixelCount; p++ ) {
+					const __m512 s = _mm512_set1_ps( sourcePixel[p * sourcePixelStep + c] );
+					for( int j = 0; j < VectorCount; j++ ) {
+						r[p][j] = _mm512_fmadd_ps( s, f[j], r[p][j] );
+					}
+				}
+				filterPixel += alignedFilterCount;
+			}
+		}
+	}
+
+	const __mmask16 lastMask = static_cast<__mmask16>( ( 1u << ( filterCount - 16 * ( VectorCount - 1 ) ) ) - 1 );
+	for( int p = 0; p < PixelCount; p++ ) {
+		for( int j = 0; j < VectorCount - 1; j++ ) {
+			_mm512_storeu_ps( result + 16 * j, r[p][j] );
+		}
+		_mm512_mask_storeu_ps( result + 16 * ( VectorCount - 1 ), lastMask, r[p][VectorCount - 1] );
+		result += filterCount;
+	}
+}
+
+// Gets the range [begin, end) of the filter positions which are inside the source
+// start is the source coordinate of the first filter position
+void CAvx512BlobConvolution::getWindowRange( int start, int dilation, int filterSize, int sourceSize, int& begin, int& end )
+{
+	begin = start >= 0 ? 0 : min( ( -start + dilation - 1 ) / dilation, filterSize );
+	end = start >= sourceSize ? 0 : min( ( sourceSize - 1 - start ) / dilation + 1, filterSize );
+	end = max( end, begin );
+}
+
+} // namespace NeoML
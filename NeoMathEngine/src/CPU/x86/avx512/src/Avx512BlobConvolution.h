@@ -0,0 +1,71 @@
+/* Copyright © 2017-2021 ABBYY Production LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+--------------------------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <NeoMathEngine/NeoMathEngine.h>
+
+namespace NeoML {
+
+// The convolution with the 3 * 3 filter and 6 to 32 filters using 512-bit registers
+// The images are stored channel-last, so the result pixel consists of FilterCount consecutive values
+// For each filter pixel and channel the values of all filters are loaded into one or two zmm registers
+// and multiplied by the broadcast source values of several neighboring result pixels at once
+class CAvx512BlobConvolution : public CCrtAllocatedObject {
+public:
+	CAvx512BlobConvolution( IMathEngine* mathEngine, int filterCount, int channelCount, int filterHeight, int filterWidth,
+		int sourceHeight, int sourceWidth, int paddingHeight, int paddingWidth, int strideHeight, int strideWidth,
+		int dilationHeight, int dilationWidth, int resultHeight, int resultWidth, int resultObjectCount );
+
+	// Checks if the convolution with such filter can be calculated
+	static bool IsAvailable( int filterCount, int filterHeight, int filterWidth );
+
+	void Process( int threadCount, const float* source, const float* filter, const float* freeTerm, float* result ) const;
+
+private:
+	IMathEngine* mathEngine;
+	const int filterCount;
+	const int channelCount;
+	const int filterHeight;
+	const int filterWidth;
+	const int sourceHeight;
+	const int sourceWidth;
+	const int paddingHeight;
+	const int paddingWidth;
+	const int strideHeight;
+	const int strideWidth;
+	const int dilationHeight;
+	const int dilationWidth;
+	const int resultHeight;
+	const int resultWidth;
+	const int resultObjectCount;
+	// The number of zmm registers for the values of all filters
+	const int vectorCount;
+	// The filter count rounded up to the register size; the rearranged filter is padded with zeros
+	const int alignedFilterCount;
+	// The result columns [centralBegin, centralEnd) have the whole filter window inside the source
+	int centralBegin;
+	int centralEnd;
+
+	void rearrangeFilter( const float* filter, float* result ) const;
+	template<int VectorCount>
+	void processRow( const float* source, const float* filter, const float* freeTerm, float* result, int ry ) const;
+	template<int VectorCount, int PixelCount>
+	void processPixels( const float* source, const float* filter, const float* freeTerm, float* result,
+		int sy, int kyBegin, int kyEnd, int sx, int kxBegin, int kxEnd ) const;
+	static void getWindowRange( int start, int dilation, int filterSize, int sourceSize, int& begin, int& end );
+};
+
+} // namespace NeoML
@@ -0,0 +1,126 @@
+/* Copyright © 2017-2021 ABBYY Production LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+--------------------------------------------------------------------------------------------------------------*/
+
+#include <common.h>
+#pragma hdrstop
+
+#include <NeoMathEngine/SimdMathEngine.h>
+#include <Avx512BlobConvolution.h>
+#include <CPUInfo.h>
+
+namespace NeoML {
+
+void Avx512MultiplyMatrix( bool transA, bool transB,
+	IMathEngine *engine,
+	const float* aPtr, size_t aRowSize,
+	const float* bPtr, size_t bRowSize,
+	float* cPtr, size_t cRowSize,
+	size_t m, size_t n, size_t k );
+
+// The int8 kernels are shared with the AVX library
+void Avx2Int8RowByTransposedMatrix( const signed char* row, const signed char* matrix, int height, int width,
+	float rowScale, const float* scales, float* result );
+#ifdef NEOML_USE_AVX_VNNI
+void AvxVnniInt8RowByTransposedMatrix( const signed char* row, const signed char* matrix, int height, int width,
+	float rowScale, const float* scales, float* result );
+#endif
+
+struct CAvx512ConvolutionDesc : public CConvolutionDesc {
+	~CAvx512ConvolutionDesc() override {}
+
+	CAvx512ConvolutionDesc( IMathEngine* mathEngine, const CBlobDesc& source, const CBlobDesc& result, const CBlobDesc& filter,
+		int paddingHeight, int paddingWidth, int strideHeight, int strideWidth, int dilationHeight, int dilationWidth );
+
+	CAvx512BlobConvolution BlobConvolution;
+};
+
+CAvx512ConvolutionDesc::CAvx512ConvolutionDesc( IMathEngine* mathEngine, const CBlobDesc& source, const CBlobDesc& result,
+		const CBlobDesc& filter, int paddingHeight, int paddingWidth, int strideHeight, int strideWidth,
+		int dilationHeight, int dilationWidth ) :
+	BlobConvolution( mathEngine, filter.BatchWidth(), filter.Channels() * filter.Depth(), filter.Height(), filter.Width(),
+		source.Height(), source.Width(), paddingHeight, paddingWidth, strideHeight, strideWidth,
+		dilationHeight, dilationWidth, result.Height(), result.Width(), result.ObjectCount() )
+{
+}
+
+class CAvx512MathEngine : public ISimdMathEngine {
+public:
+	CAvx512MathEngine( IMathEngine* _mathEngine, int _threadCount ) : mathEngine( _mathEngine ), threadCount( _threadCount ) {}
+
+	CConvolutionDesc* InitBlobConvolution( const CBlobDesc& source, int paddingHeight, int paddingWidth,
+		int strideHeight, int strideWidth, int dilationHeight, int dilationWidth, const CBlobDesc& filter,
+		const CBlobDesc& result ) const override;
+
+	void BlobConvolution( const CConvolutionDesc& convDesc, const float* source,
+		const float* filter, const float* freeTerm, float* result ) const override;
+
+	SgemmFunc GetSgemmFunction() const override;
+
+	Int8RowByTransposedMatrixFunc GetInt8RowByTransposedMatrixFunction() const override;
+
+private:
+	IMathEngine* mathEngine;
+	int threadCount;
+};
+
+CConvolutionDesc* CAvx512MathEngine::InitBlobConvolution( const CBlobDesc& source, int paddingHeight, int paddingWidth,
+	int strideHeight, int strideWidth, int dilationHeight, int dilationWidth, const CBlobDesc& filter,
+	const CBlobDesc& result ) const
+{
+	if( CAvx512BlobConvolution::IsAvailable( filter.BatchWidth(), filter.Height(), filter.Width() ) ) {
+		return new CAvx512ConvolutionDesc( mathEngine, source, result, filter, paddingHeight, paddingWidth,
+			strideHeight, strideWidth, dilationHeight, dilationWidth );
+	}
+	return nullptr;
+}
+
+void CAvx512MathEngine::BlobConvolution( const CConvolutionDesc& convDesc, const float* source,
+	const float* filter, const float* freeTerm, float* result ) const
+{
+	const CAvx512ConvolutionDesc& desc = static_cast<const CAvx512ConvolutionDesc&>( convDesc );
+	desc.BlobConvolution.Process( threadCount, source, filter, freeTerm, result );
+}
+
+SgemmFunc CAvx512MathEngine::GetSgemmFunction() const
+{
+	return Avx512MultiplyMatrix;
+}
+
+Int8RowByTransposedMatrixFunc CAvx512MathEngine::GetInt8RowByTransposedMatrixFunction() const
+{
+#ifdef NEOML_USE_AVX_VNNI
+	if( CCPUInfo::IsAvxVnniAvailable() ) {
+		return AvxVnniInt8RowByTransposedMatrix;
+	}
+#endif
+	if( CCPUInfo::IsAvx2Available() ) {
+		return Avx2Int8RowByTransposedMatrix;
+	}
+	return nullptr;
+}
+
+extern "C"
+FME_DLL_EXPORT
+ISimdMathEngine* CreateSimdMathEngine( IMathEngine* mathEngine, int threadCount )
+{
+	try {
+		return new CAvx512MathEngine( mathEngine, threadCount );
+	} catch( ... ) {
+		// We cannot throw any exception from C function
+		return nullptr;
+	}
+}
+
+}
@@ -0,0 +1,107 @@
+/* Copyright © 2017-2021 ABBYY Production LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+--------------------------------------------------------------------------------------------------------------*/
+
+#include <NeoMathEngine/SimdMathEngine.h>
+
+#include <CPUInfo.h>
+#include <MatrixMultiplyingInterleavedCommon/MatrixMultiplying.h>
+#include <MatrixMultiplyingInterleavedCommon/CpuMemoryHelper.h>
+
+#include <Avx512Interleavers.h>
+#include <Kernel_AVX512.h>
+
+namespace NeoML {
+
+// The kernels for one row of blocks; the rows of 12, 4 and 1 lines are combined so that
+// the short matrices (for example, a vector by a matrix) don't waste the computations on the zero lines
+template<size_t H>
+using CKernelRow_16 = CKernelCombineHorizontal<CMicroKernelAvx512<H, 32>, CMicroKernelAvx512<H, 16>>;
+template<size_t H>
+using CKernelRow_8 = CKernelCombineHorizontal<CMicroKernelAvx512<H, 32>, CMicroKernelAvx512<H, 16>,
+	CMicroKernelAvx512Narrow<H, 8>>;
+template<size_t H>
+using CKernelRow_4 = CKernelCombineHorizontal<CMicroKernelAvx512<H, 32>, CMicroKernelAvx512<H, 16>,
+	CMicroKernelAvx512Narrow<H, 8>, CMicroKernelAvx512Narrow<H, 4>>;
+template<size_t H>
+using CKernelRow_full = CKernelCombineHorizontal<CMicroKernelAvx512<H, 32>, CMicroKernelAvx512<H, 16>,
+	CMicroKernelAvx512Narrow<H, 8>, CMicroKernelAvx512Narrow<H, 4>, CMicroKernelAvx512Narrow<H, 2>,
+	CMicroKernelAvx512Narrow<H, 1>>;
+
+template<template<size_t> class KernelRow>
+using CKernelCombi = CKernelCombineVertical<KernelRow<12>, KernelRow<4>, KernelRow<1>>;
+
+template< class Kernel>
+void Avx512MultiplyMatrixSelected( bool transA, bool transB,
+	IMathEngine *engine,
+	const float* aPtr, size_t aRowSize,
+	const float* bPtr, size_t bRowSize,
+	float* cPtr, size_t cRowSize,
+	size_t m, size_t n, size_t k )
+{
+	CCpuCacheSizes cacheSizes;
+	engine->GetCpuCacheSizes( cacheSizes );
+	const CCPUInfo cpuinfo( cacheSizes.L1, cacheSizes.L2, cacheSizes.L3 );
+
+	unsigned char transSelector = ( transA ? 0b10 : 0 ) + ( transB ? 0b01 : 0 );
+	switch( transSelector ) {
+	case 0b00:
+		CMatrixMultiplier<Kernel, CInterleaverDefault, false, false, CTmpMemoryHandler, IMathEngine>::Multiply
+				( engine, cpuinfo, aPtr, aRowSize, bPtr, bRowSize, cPtr, cRowSize, m, n, k );
+		break;
+	case 0b01:
+		CMatrixMultiplier<Kernel, CInterleaverDefault, false, true, CTmpMemoryHandler, IMathEngine>::Multiply
+				( engine, cpuinfo, aPtr, aRowSize, bPtr, bRowSize, cPtr, cRowSize, m, n, k );
+		break;
+	case 0b10:
+		CMatrixMultiplier<Kernel, CInterleaverDefault, true, false, CTmpMemoryHandler, IMathEngine>::Multiply
+				( engine, cpuinfo, aPtr, aRowSize, bPtr, bRowSize, cPtr, cRowSize, m, n, k );
+		break;
+	case 0b11:
+		CMatrixMultiplier<Kernel, CInterleaverDefault, true, true, CTmpMemoryHandler, IMathEngine>::Multiply
+				( engine, cpuinfo, aPtr, aRowSize, bPtr, bRowSize, cPtr, cRowSize, m, n, k );
+		break;
+	}
+}
+
+void Avx512MultiplyMatrix( bool transA, bool transB,
+	IMathEngine *engine,
+	const float* aPtr, size_t aRowSize,
+	const float* bPtr, size_t bRowSize,
+	float* cPtr, size_t cRowSize,
+	size_t m, size_t n, size_t k )
+{
+	// As in the AVX version, the last columns are calculated by a wider kernel in one step
+	// when that is cheaper than going through all the narrower kernels
+	switch( n % 16 ) {
+	case 3:
+	case 11:
+		Avx512MultiplyMatrixSelected<CKernelCombi<CKernelRow_4>>( transA, transB, engine, aPtr, aRowSize, bPtr, bRowSize, cPtr, cRowSize, m, n, k );
+		break;
+	case 5:
+	case 6:
+	case 7:
+		Avx512MultiplyMatrixSelected<CKernelCombi<CKernelRow_8>>( transA, transB, engine, aPtr, aRowSize, bPtr, bRowSize, cPtr, cRowSize, m, n, k );
+		break;
+	case 13:
+	case 14:
+	case 15:
+		Avx512MultiplyMatrixSelected<CKernelCombi<CKernelRow_16>>( transA, transB, engine, aPtr, aRowSize, bPtr, bRowSize, cPtr, cRowSize, m, n, k );
+		break;
+	default:
+		Avx512MultiplyMatrixSelected<CKernelCombi<CKernelRow_full>>( transA, transB, engine, aPtr, aRowSize, bPtr, bRowSize, cPtr, cRowSize, m, n, k );
+	}
+}
+
+}
@@ -0,0 +1,173 @@
+/* Copyright © 2017-2021 ABBYY Production LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+--------------------------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+// The AVX interleavers for 4, 6, 8 and 16 rows are used as is
+#include <Interleavers.h>
+
+// Transposes the 8 x 8 block: the column i of the input is written into the row i of the output
+static inline void TransposeBlock8x8( float* out, size_t oStride, const float* in, size_t iStride )
+{
+	const __m256 a = _mm256_loadu_ps( in + 0 * iStride );
+	const __m256 b = _mm256_loadu_ps( in + 1 * iStride );
+	const __m256 c = _mm256_loadu_ps( in + 2 * iStride );
+	const __m256 d = _mm256_loadu_ps( in + 3 * iStride );
+	const __m256 e = _mm256_loadu_ps( in + 4 * iStride );
+	const __m256 f = _mm256_loadu_ps( in + 5 * iStride );
+	const __m256 j = _mm256_loadu_ps( in + 6 * iStride );
+	const __m256 h = _mm256_loadu_ps( in + 7 * iStride );
+
+	// ab0145: a0 b0 a1 b1 a4 b4 a5 b5
+	const __m256 ab0145 = _mm256_unpacklo_ps( a, b );
+	// ab2367: a2 b2 a3 b3 a6 b6 a7 b7
+	const __m256 ab2367 = _mm256_unpackhi_ps( a, b );
+	const __m256 cd0145 = _mm256_unpacklo_ps( c, d );
+	const __m256 cd2367 = _mm256_unpackhi_ps( c, d );
+	const __m256 ef0145 = _mm256_unpacklo_ps( e, f );
+	const __m256 ef2367 = _mm256_unpackhi_ps( e, f );
+	const __m256 jh0145 = _mm256_unpacklo_ps( j, h );
+	const __m256 jh2367 = _mm256_unpackhi_ps( j, h );
+
+	// abcd04: a0 b0 c0 d0 a4 b4 c4 d4
+	const __m256 abcd04 = _mm256_shuffle_ps( ab0145, cd0145, _MM_SHUFFLE( 1, 0, 1, 0 ) );
+	const __m256 abcd15 = _mm256_shuffle_ps( ab0145, cd0145, _MM_SHUFFLE( 3, 2, 3, 2 ) );
+	const __m256 abcd26 = _mm256_shuffle_ps( ab2367, cd2367, _MM_SHUFFLE( 1, 0, 1, 0 ) );
+	const __m256 abcd37 = _mm256_shuffle_ps( ab2367, cd2367, _MM_SHUFFLE( 3, 2, 3, 2 ) );
+	const __m256 efjh04 = _mm256_shuffle_ps( ef0145, jh0145, _MM_SHUFFLE( 1, 0, 1, 0 ) );
+	const __m256 efjh15 = _mm256_shuffle_ps( ef0145, jh0145, _MM_SHUFFLE( 3, 2, 3, 2 ) );
+	const __m256 efjh26 = _mm256_shuffle_ps( ef2367, jh2367, _MM_SHUFFLE( 1, 0, 1, 0 ) );
+	const __m256 efjh37 = _mm256_shuffle_ps( ef2367, jh2367, _MM_SHUFFLE( 3, 2, 3, 2 ) );
+
+	// abcdefjh0: a0 b0 c0 d0 e0 f0 j0 h0
+	_mm256_storeu_ps( out + 0 * oStride, _mm256_permute2f128_ps( abcd04, efjh04, PERMUTE2( 2, 0 ) ) );
+	_mm256_storeu_ps( out + 1 * oStride, _mm256_permute2f128_ps( abcd15, efjh15, PERMUTE2( 2, 0 ) ) );
+	_mm256_storeu_ps( out + 2 * oStride, _mm256_permute2f128_ps( abcd26, efjh26, PERMUTE2( 2, 0 ) ) );
+	_mm256_storeu_ps( out + 3 * oStride, _mm256_permute2f128_ps( abcd37, efjh37, PERMUTE2( 2, 0 ) ) );
+	_mm256_storeu_ps( out + 4 * oStride, _mm256_permute2f128_ps( abcd04, efjh04, PERMUTE2( 3, 1 ) ) );
+	_mm256_storeu_ps( out + 5 * oStride, _mm256_permute2f128_ps( abcd15, efjh15, PERMUTE2( 3, 1 ) ) );
+	_mm256_storeu_ps( out + 6 * oStride, _mm256_permute2f128_ps( abcd26, efjh26, PERMUTE2( 3, 1 ) ) );
+	_mm256_storeu_ps( out + 7 * oStride, _mm256_permute2f128_ps( abcd37, efjh37, PERMUTE2( 3, 1 ) ) );
+}
+
+// Transposes the 4 x 8 block: the column i of the input is written into the row i of the output
+static inline void TransposeBlock4x8( float* out, size_t oStride, const float* in, size_t iStride )
+{
+	const __m256 a = _mm256_loadu_ps( in + 0 * iStride );
+	const __m256 b = _mm256_loadu_ps( in + 1 * iStride );
+	const __m256 c = _mm256_loadu_ps( in + 2 * iStride );
+	const __m256 d = _mm256_loadu_ps( in + 3 * iStride );
+
+	const __m256 ab0145 = _mm256_unpacklo_ps( a, b );
+	const __m256 ab2367 = _mm256_unpackhi_ps( a, b );
+	const __m256 cd0145 = _mm256_unpacklo_ps( c, d );
+	const __m256 cd2367 = _mm256_unpackhi_ps( c, d );
+
+	// abcd04: a0 b0 c0 d0 a4 b4 c4 d4
+	const __m256 abcd04 = _mm256_shuffle_ps( ab0145, cd0145, _MM_SHUFFLE( 1, 0, 1, 0 ) );
+	const __m256 abcd15 = _mm256_shuffle_ps( ab0145, cd0145, _MM_SHUFFLE( 3, 2, 3, 2 ) );
+	const __m256 abcd26 = _mm256_shuffle_ps( ab2367, cd2367, _MM_SHUFFLE( 1, 0, 1, 0 ) );
+	const __m256 abcd37 = _mm256_shuffle_ps( ab2367, cd2367, _MM_SHUFFLE( 3, 2, 3, 2 ) );
+
+	_mm_storeu_ps( out + 0 * oStride, _mm256_castps256_ps128( abcd04 ) );
+	_mm_storeu_ps( out + 1 * oStride, _mm256_castps256_ps128( abcd15 ) );
+	_mm_storeu_ps( out + 2 * oStride, _mm256_castps256_ps128( abcd26 ) );
+	_mm_storeu_ps( out + 3 * oStride, _mm256_castps256_ps128( abcd37 ) );
+	_mm_storeu_ps( out + 4 * oStride, _mm256_extractf128_ps( abcd04, 1 ) );
+	_mm_storeu_ps( out + 5 * oStride, _mm256_extractf128_ps( abcd15, 1 ) );
+	_mm_storeu_ps( out + 6 * oStride, _mm256_extractf128_ps( abcd26, 1 ) );
+	_mm_storeu_ps( out + 7 * oStride, _mm256_extractf128_ps( abcd37, 1 ) );
+}
+
+// Transposes the last rows (fewer than Len) and fills the rest of the block with zeros
+template<size_t Len>
+static inline void TransposeLastRows( float* out, const float* in, size_t stride, size_t width, size_t height )
+{
+	CInterleaverBase<false, 1>::Transpose( out, Len, in, stride, height, width );
+	out += height;
+	const size_t len = ( Len - height ) * sizeof( float );
+	for( ; width > 0; --width ) {
+		memset( out, 0, len );
+		out += Len;
+	}
+}
+
+// Prepare and transpose the matrix
+template<>
+struct CInterleaverBase<true, 12> {
+	static void Prepare( float* out, const float* in, size_t stride, size_t width, size_t height )
+	{
+		const int Len = 12;
+
+		const size_t iStep = stride * Len;
+		const size_t oStep = width * Len;
+
+		for( ; height >= Len; height -= Len ) {
+			const float* tempIn = in;
+			float* tempOut = out;
+			size_t tempWidth = width;
+			for( ; tempWidth >= 8; tempWidth -= 8 ) {
+				TransposeBlock8x8( tempOut, Len, tempIn, stride );
+				TransposeBlock4x8( tempOut + 8, Len, tempIn + 8 * stride, stride );
+				tempIn += 8;
+				tempOut += 8 * Len;
+			}
+			if( tempWidth != 0 ) {
+				CInterleaverBase<false, 1>::Transpose( tempOut, Len, tempIn, stride, Len, tempWidth );
+			}
+			in += iStep;
+			out += oStep;
+		}
+		height %= Len;
+		if( height > 0 ) {
+			TransposeLastRows<Len>( out, in, stride, width, height );
+		}
+	}
+};
+
+// Prepare and transpose the matrix
+template<>
+struct CInterleaverBase<true, 32> {
+	static void Prepare( float* out, const float* in, size_t stride, size_t width, size_t height )
+	{
+		const int Len = 32;
+
+		const size_t iStep = stride * Len;
+		const size_t oStep = width * Len;
+
+		for( ; height >= Len; height -= Len ) {
+			const float* tempIn = in;
+			float* tempOut = out;
+			size_t tempWidth = width;
+			for( ; tempWidth >= 8; tempWidth -= 8 ) {
+				TransposeBlock8x8( tempOut, Len, tempIn, stride );
+				TransposeBlock8x8( tempOut + 8, Len, tempIn + 8 * stride, stride );
+				TransposeBlock8x8( tempOut + 16, Len, tempIn + 16 * stride, stride );
+				TransposeBlock8x8( tempOut + 24, Len, tempIn + 24 * stride, stride );
+				tempIn += 8;
+				tempOut += 8 * Len;
+			}
+			if( tempWidth != 0 ) {
+				CInterleaverBase<false, 1>::Transpose( tempOut, Len, tempIn, stride, Len, tempWidth );
+			}
+			in += iStep;
+			out += oStep;
+		}
+		height %= Len;
+		if( height > 0 ) {
+			TransposeLastRows<Len>( out, in, stride, width, height );
+		}
+	}
+};
@@ -0,0 +1,99 @@
+/* Copyright © 2017-2021 ABBYY Production LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+--------------------------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <immintrin.h>
+#include <MicroKernels/MicroKernelBase.h>
+
+// The micro-kernel which keeps the H x W block of the result in H * W / 16 zmm registers
+// Each step over k loads W / 16 registers of the B row and broadcasts H values of the A column
+// The width must be a multiple of 16; the 12 x 32 kernel uses 24 of 32 registers for the result
+template<size_t H, size_t W>
+struct CMicroKernelAvx512 : public CMicroKernelBase<H, W> {
+	static_assert( W % 16 == 0, "The kernel width must be a multiple of 16" );
+	static constexpr size_t VecCount = W / 16;
+
+	static void Calculate( const float* aPtr, const float* bPtr, float* cPtr, size_t cRowSize, size_t k )
+	{
+		for( size_t i = 0; i < H; ++i ) {
+			_mm_prefetch( reinterpret_cast<const char*>( cPtr + i * cRowSize ), _MM_HINT_T0 );
+		}
+
+		__m512 c[H][VecCount];
+		for( size_t i = 0; i < H; ++i ) {
+			for( size_t j = 0; j < VecCount; ++j ) {
+				c[i][j] = _mm512_setzero_ps();
+			}
+		}
+
+		for( ; k > 0; --k ) {
+			_mm_prefetch( reinterpret_cast<const char*>( aPtr + 8 * H ), _MM_HINT_T0 );
+			__m512 b[VecCount];
+			for( size_t j = 0; j < VecCount; ++j ) {
+				b[j] = _mm512_loadu_ps( bPtr + 16 * j );
+			}
+			for( size_t i = 0; i < H; ++i ) {
+				const __m512 a = _mm512_set1_ps( aPtr[i] );
+				for( size_t j = 0; j < VecCount; ++j ) {
+					c[i][j] = _mm512_fmadd_ps( a, b[j], c[i][j] );
+				}
+			}
+			aPtr += H;
+			bPtr += W;
+		}
+
+		for( size_t i = 0; i < H; ++i ) {
+			for( size_t j = 0; j < VecCount; ++j ) {
+				_mm512_storeu_ps( cPtr + 16 * j, _mm512_add_ps( c[i][j], _mm512_loadu_ps( cPtr + 16 * j ) ) );
+			}
+			cPtr += cRowSize;
+		}
+	}
+};
+
+// The micro-kernel for the narrow blocks which keeps each of the W columns of the result in one zmm register
+// Each step over k loads the A column with a mask and broadcasts W values of the B row
+// The height must not exceed 16
+template<size_t H, size_t W>
+struct CMicroKernelAvx512Narrow : public CMicroKernelBase<H, W> {
+	static_assert( H <= 16, "The kernel height must not exceed 16" );
+
+	static void Calculate( const float* aPtr, const float* bPtr, float* cPtr, size_t cRowSize, size_t k )
+	{
+		const __mmask16 rowMask = static_cast<__mmask16>( ( 1u << H ) - 1 );
+
+		__m512 c[W];
+		for( size_t j = 0; j < W; ++j ) {
+			c[j] = _mm512_setzero_ps();
+		}
+
+		for( ; k > 0; --k ) {
+			const __m512 a = _mm512_maskz_loadu_ps( rowMask, aPtr );
+			for( size_t j = 0; j < W; ++j ) {
+				c[j] = _mm512_fmadd_ps( a, _mm512_set1_ps( bPtr[j] ), c[j] );
+			}
+			aPtr += H;
+			bPtr += W;
+		}
+
+		float column[16];
+		for( size_t j = 0; j < W; ++j ) {
+			_mm512_storeu_ps( column, c[j] );
+			for( size_t i = 0; i < H; ++i ) {
+				cPtr[i * cRowSize + j] += column[i];
+			}
+		}
+	}
+};
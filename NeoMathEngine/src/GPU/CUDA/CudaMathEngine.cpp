@@ -63,6 +63,21 @@ size_t CCudaMathEngine::GetMemoryInPools() const
 	return memoryPool->GetMemoryInPools();
 }
 
+void CCudaMathEngine::GetMemoryPoolStatistics( CMemoryPoolStatistics& statistics ) const
+{
+	memoryPool->GetStatistics( statistics );
+}
+
+void CCudaMathEngine::SetCpuCacheSizes( const CCpuCacheSizes& )
+{
+	// The blocking is chosen by the device libraries
+}
+
+void CCudaMathEngine::GetCpuCacheSizes( CCpuCacheSizes& sizes ) const
+{
+	sizes = CCpuCacheSizes();
+}
+
 void CCudaMathEngine::SetReuseMemoryMode( bool )
 {
 	// Always true, because allocation is sync
@@ -1026,6 +1026,26 @@ void CCudaMathEngine::vectorMultichannelLookupAndAddToTable(int batchSize, int c
 	}
 }
 
+void CCudaMathEngine::QuantizeMatrixRowsInt8( const CConstFloatHandle& matrixHandle, int, int,
+	const CInt8Handle& resultHandle, const CFloatHandle& scalesHandle )
+{
+	ASSERT_EXPR( matrixHandle.GetMathEngine() == this );
+	ASSERT_EXPR( resultHandle.GetMathEngine() == this );
+	ASSERT_EXPR( scalesHandle.GetMathEngine() == this );
+	ASSERT_EXPR( false );
+}
+
+void CCudaMathEngine::MultiplyMatrixByTransposedInt8Matrix( const CConstFloatHandle& firstHandle, int, int, float,
+	const CConstInt8Handle& secondHandle, const CConstFloatHandle& secondScalesHandle, int,
+	const CFloatHandle& resultHandle )
+{
+	ASSERT_EXPR( firstHandle.GetMathEngine() == this );
+	ASSERT_EXPR( secondHandle.GetMathEngine() == this );
+	ASSERT_EXPR( secondScalesHandle.GetMathEngine() == this );
+	ASSERT_EXPR( resultHandle.GetMathEngine() == this );
+	ASSERT_EXPR( false );
+}
+
 } // namespace NeoML
 
 #endif // NEOML_USE_CUDA
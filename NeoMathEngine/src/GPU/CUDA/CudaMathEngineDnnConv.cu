@@ -235,6 +235,36 @@ void CCudaMathEngine::BlobConvolutionLearnAdd( const CConvolutionDesc& convDesc,
 		tempMatrix, matrixWidth, matrixWidth, filterDiff, matrixWidth, desc.Filter.BlobSize() );
 }
 
+void CCudaMathEngine::SetConvolutionAutotuning( bool )
+{
+}
+
+bool CCudaMathEngine::SaveConvolutionAutotuningCache( const char* ) const
+{
+	return false;
+}
+
+bool CCudaMathEngine::LoadConvolutionAutotuningCache( const char* )
+{
+	return false;
+}
+
+const char* CCudaMathEngine::GetConvolutionAlgorithmName( const CConvolutionDesc&, bool ) const
+{
+	return "";
+}
+
+void CCudaMathEngine::BlobConvolutionInt8( const CConvolutionDesc&, const CFloatHandle& source, float,
+	const CConstInt8Handle& filter, const CConstFloatHandle& filterScales, const CFloatHandle*,
+	const CFloatHandle& result )
+{
+	ASSERT_EXPR( source.GetMathEngine() == this );
+	ASSERT_EXPR( filter.GetMathEngine() == this );
+	ASSERT_EXPR( filterScales.GetMathEngine() == this );
+	ASSERT_EXPR( result.GetMathEngine() == this );
+	ASSERT_EXPR( false );
+}
+
 } // namespace NeoML
 
 #endif // NEOML_USE_CUDA
@@ -144,6 +144,21 @@ size_t CMetalMathEngine::GetMemoryInPools() const
 	return memoryPool->GetMemoryInPools();
 }
 
+void CMetalMathEngine::GetMemoryPoolStatistics( CMemoryPoolStatistics& statistics ) const
+{
+	memoryPool->GetStatistics( statistics );
+}
+
+void CMetalMathEngine::SetCpuCacheSizes( const CCpuCacheSizes& )
+{
+	// The blocking is chosen by the device libraries
+}
+
+void CMetalMathEngine::GetCpuCacheSizes( CCpuCacheSizes& sizes ) const
+{
+	sizes = CCpuCacheSizes();
+}
+
 void CMetalMathEngine::CleanUp()
 {
 	std::lock_guard<CMutex> lock( *mutex );
@@ -19,6 +19,8 @@ limitations under the License.
 
 #include <MetalMathEngine.h>
 #include <MathEngineCommon.h>
+#include <MathEngineDnnAttention.h>
+#include <MathEngineDnnRecurrent.h>
 #include <MetalKernel.h>
 
 @import Foundation;
@@ -589,6 +591,51 @@ void CMetalMathEngine::IndRnnRecurrentLearn( bool /*reverse*/, int /*sequenceLen
     ASSERT_EXPR( false );
 }
 
+void CMetalMathEngine::LstmRecurrent( bool reverse, int sequenceLength, int batchSize, int hiddenSize,
+    const CConstFloatHandle& inputGates, const CConstFloatHandle& recurWeights,
+    const CConstFloatHandle& initialHidden, const CConstFloatHandle& initialState,
+    const CFloatHandle& hidden, const CFloatHandle& state )
+{
+    ASSERT_EXPR( inputGates.GetMathEngine() == this );
+    ASSERT_EXPR( recurWeights.GetMathEngine() == this );
+    ASSERT_EXPR( initialHidden.IsNull() || initialHidden.GetMathEngine() == this );
+    ASSERT_EXPR( initialState.IsNull() || initialState.GetMathEngine() == this );
+    ASSERT_EXPR( hidden.GetMathEngine() == this );
+    ASSERT_EXPR( state.GetMathEngine() == this );
+
+    LstmRecurrentByPrimitives( *this, reverse, sequenceLength, batchSize, hiddenSize,
+        inputGates, recurWeights, initialHidden, initialState, hidden, state );
+}
+
+void CMetalMathEngine::GruRecurrent( bool reverse, int sequenceLength, int batchSize, int hiddenSize,
+    const CConstFloatHandle& inputGates, const CConstFloatHandle& inputMain,
+    const CConstFloatHandle& gateWeights, const CConstFloatHandle& mainWeights,
+    const CConstFloatHandle& initialHidden, const CFloatHandle& hidden )
+{
+    ASSERT_EXPR( inputGates.GetMathEngine() == this );
+    ASSERT_EXPR( inputMain.GetMathEngine() == this );
+    ASSERT_EXPR( gateWeights.GetMathEngine() == this );
+    ASSERT_EXPR( mainWeights.GetMathEngine() == this );
+    ASSERT_EXPR( initialHidden.IsNull() || initialHidden.GetMathEngine() == this );
+    ASSERT_EXPR( hidden.GetMathEngine() == this );
+
+    GruRecurrentByPrimitives( *this, reverse, sequenceLength, batchSize, hiddenSize,
+        inputGates, inputMain, gateWeights, mainWeights, initialHidden, hidden );
+}
+
+void CMetalMathEngine::MultiheadAttention( int batchSize, int headCount, int headSize, int seqQ, int seqK, float multiplier,
+    const CConstFloatHandle& q, const CConstFloatHandle& k, const CConstFloatHandle& v,
+    const CConstFloatHandle& mask, const CFloatHandle& result )
+{
+    ASSERT_EXPR( q.GetMathEngine() == this );
+    ASSERT_EXPR( k.GetMathEngine() == this );
+    ASSERT_EXPR( v.GetMathEngine() == this );
+    ASSERT_EXPR( mask.IsNull() || mask.GetMathEngine() == this );
+    ASSERT_EXPR( result.GetMathEngine() == this );
+
+    MultiheadAttentionByHeads( *this, batchSize, headCount, headSize, seqQ, seqK, multiplier, q, k, v, mask, result );
+}
+
 } // namespace NeoML
 
 #endif // NEOML_USE_METAL
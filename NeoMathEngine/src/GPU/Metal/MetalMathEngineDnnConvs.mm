@@ -663,6 +663,36 @@ void CMetalMathEngine::BlobRleConvolutionLearnAdd( const CRleConvolutionDesc&, c
 	ASSERT_EXPR( false );
 }
 
+void CMetalMathEngine::SetConvolutionAutotuning( bool )
+{
+}
+
+bool CMetalMathEngine::SaveConvolutionAutotuningCache( const char* ) const
+{
+	return false;
+}
+
+bool CMetalMathEngine::LoadConvolutionAutotuningCache( const char* )
+{
+	return false;
+}
+
+const char* CMetalMathEngine::GetConvolutionAlgorithmName( const CConvolutionDesc&, bool ) const
+{
+	return "";
+}
+
+void CMetalMathEngine::BlobConvolutionInt8( const CConvolutionDesc&, const CFloatHandle& source, float,
+	const CConstInt8Handle& filter, const CConstFloatHandle& filterScales, const CFloatHandle*,
+	const CFloatHandle& result )
+{
+	ASSERT_EXPR( source.GetMathEngine() == this );
+	ASSERT_EXPR( filter.GetMathEngine() == this );
+	ASSERT_EXPR( filterScales.GetMathEngine() == this );
+	ASSERT_EXPR( result.GetMathEngine() == this );
+	ASSERT_EXPR( false );
+}
+
 } // namespace NeoML
 
 #endif // NEOML_USE_METAL
@@ -150,6 +150,21 @@ size_t CVulkanMathEngine::GetMemoryInPools() const
 	return memoryPool->GetMemoryInPools();
 }
 
+void CVulkanMathEngine::GetMemoryPoolStatistics( CMemoryPoolStatistics& statistics ) const
+{
+	memoryPool->GetStatistics( statistics );
+}
+
+void CVulkanMathEngine::SetCpuCacheSizes( const CCpuCacheSizes& )
+{
+	// The blocking is chosen by the device libraries
+}
+
+void CVulkanMathEngine::GetCpuCacheSizes( CCpuCacheSizes& sizes ) const
+{
+	sizes = CCpuCacheSizes();
+}
+
 void CVulkanMathEngine::CleanUp()
 {
 	std::lock_guard<std::mutex> lock( mutex );
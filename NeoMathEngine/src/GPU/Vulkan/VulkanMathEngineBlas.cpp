@@ -1152,6 +1152,26 @@ void CVulkanMathEngine::MultiplyVectorByTransposedLookupVectorAndAddToTable( int
 	ASSERT_EXPR( false );
 }
 
+void CVulkanMathEngine::QuantizeMatrixRowsInt8( const CConstFloatHandle& matrixHandle, int, int,
+	const CInt8Handle& resultHandle, const CFloatHandle& scalesHandle )
+{
+	ASSERT_EXPR( matrixHandle.GetMathEngine() == this );
+	ASSERT_EXPR( resultHandle.GetMathEngine() == this );
+	ASSERT_EXPR( scalesHandle.GetMathEngine() == this );
+	ASSERT_EXPR( false );
+}
+
+void CVulkanMathEngine::MultiplyMatrixByTransposedInt8Matrix( const CConstFloatHandle& firstHandle, int, int, float,
+	const CConstInt8Handle& secondHandle, const CConstFloatHandle& secondScalesHandle, int,
+	const CFloatHandle& resultHandle )
+{
+	ASSERT_EXPR( firstHandle.GetMathEngine() == this );
+	ASSERT_EXPR( secondHandle.GetMathEngine() == this );
+	ASSERT_EXPR( secondScalesHandle.GetMathEngine() == this );
+	ASSERT_EXPR( resultHandle.GetMathEngine() == this );
+	ASSERT_EXPR( false );
+}
+
 } // namespace NeoML
 
 #endif // NEOML_USE_VULKAN
@@ -1061,6 +1061,36 @@ void CVulkanMathEngine::BlobChannelwiseConvolutionLearnAdd( const CChannelwiseCo
 	ASSERT_EXPR( false );
 }
 
+void CVulkanMathEngine::SetConvolutionAutotuning( bool )
+{
+}
+
+bool CVulkanMathEngine::SaveConvolutionAutotuningCache( const char* ) const
+{
+	return false;
+}
+
+bool CVulkanMathEngine::LoadConvolutionAutotuningCache( const char* )
+{
+	return false;
+}
+
+const char* CVulkanMathEngine::GetConvolutionAlgorithmName( const CConvolutionDesc&, bool ) const
+{
+	return "";
+}
+
+void CVulkanMathEngine::BlobConvolutionInt8( const CConvolutionDesc&, const CFloatHandle& source, float,
+	const CConstInt8Handle& filter, const CConstFloatHandle& filterScales, const CFloatHandle*,
+	const CFloatHandle& result )
+{
+	ASSERT_EXPR( source.GetMathEngine() == this );
+	ASSERT_EXPR( filter.GetMathEngine() == this );
+	ASSERT_EXPR( filterScales.GetMathEngine() == this );
+	ASSERT_EXPR( result.GetMathEngine() == this );
+	ASSERT_EXPR( false );
+}
+
 } // namespace NeoML
 
 #endif // NEOML_USE_VULKAN
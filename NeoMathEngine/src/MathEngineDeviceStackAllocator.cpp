@@ -172,9 +172,51 @@ private:
 
 //------------------------------------------------------------------------------------------------------------
 
+// The thread-local cache of the stacks for the last allocators used by the thread
+// The allocator identifiers are never reused, so the entries of the destroyed allocators never match
+// The entries are ordered from the most to the least recently used
+struct CStackManagerCacheEntry {
+	size_t AllocatorId;
+	CDeviceStackMemoryManager* Manager;
+};
+
+static const int StackManagerCacheSize = 4;
+static thread_local CStackManagerCacheEntry stackManagerCache[StackManagerCacheSize];
+
+static std::atomic<size_t> deviceStackAllocatorNextId( 1 );
+
+// Finds the stack in the cache and moves it to the front; returns nullptr if the allocator is not in the cache
+static CDeviceStackMemoryManager* findInStackManagerCache( size_t allocatorId )
+{
+	for( int i = 0; i < StackManagerCacheSize; ++i ) {
+		if( stackManagerCache[i].AllocatorId == allocatorId ) {
+			const CStackManagerCacheEntry entry = stackManagerCache[i];
+			for( int j = i; j > 0; --j ) {
+				stackManagerCache[j] = stackManagerCache[j - 1];
+			}
+			stackManagerCache[0] = entry;
+			return entry.Manager;
+		}
+	}
+	return nullptr;
+}
+
+// Adds the stack to the front of the cache, evicting the least recently used entry
+static void addToStackManagerCache( size_t allocatorId, CDeviceStackMemoryManager* manager )
+{
+	for( int i = StackManagerCacheSize - 1; i > 0; --i ) {
+		stackManagerCache[i] = stackManagerCache[i - 1];
+	}
+	stackManagerCache[0].AllocatorId = allocatorId;
+	stackManagerCache[0].Manager = manager;
+}
+
+//------------------------------------------------------------------------------------------------------------
+
 CDeviceStackAllocator::CDeviceStackAllocator( CMemoryPool& _memoryPool, int _memoryAlignment ) :
 	memoryPool( _memoryPool ),
-	memoryAlignment( _memoryAlignment )
+	memoryAlignment( _memoryAlignment ),
+	id( deviceStackAllocatorNextId++ )
 {
 }
 
@@ -187,11 +229,9 @@ CDeviceStackAllocator::~CDeviceStackAllocator()
 
 void CDeviceStackAllocator::CleanUp()
 {
-	thread::id id = this_thread::get_id();
-
-	auto iterator = stackManagers.find( id );
-	if( iterator != stackManagers.end() ) {
-		iterator->second->CleanUp();
+	CDeviceStackMemoryManager* deviceManager = findManager( false );
+	if( deviceManager != 0 ) {
+		deviceManager->CleanUp();
 	}
 }
 
@@ -199,18 +239,7 @@ CMemoryHandle CDeviceStackAllocator::Alloc( size_t size )
 {
 	// Align size to keep correct data alignment
 	size = ( ( size + memoryAlignment - 1 ) / memoryAlignment ) * memoryAlignment;
-	CDeviceStackMemoryManager* deviceManager = 0;
-	thread::id id = this_thread::get_id();
-
-	{
-		auto result = stackManagers.find( id );
-		if( result == stackManagers.end() ) {
-			result = stackManagers.insert( make_pair( id,  new CDeviceStackMemoryManager( memoryPool ) ) ).first;
-		}
-		deviceManager = result->second;
-	}
-
-	return deviceManager->Alloc(size);
+	return findManager( true )->Alloc(size);
 }
 
 void CDeviceStackAllocator::Free( const CMemoryHandle& ptr )
@@ -219,14 +248,36 @@ void CDeviceStackAllocator::Free( const CMemoryHandle& ptr )
 		return;
 	}
 
-	CDeviceStackMemoryManager* deviceManager = 0;
-	thread::id id = this_thread::get_id();
+	findManager( false )->Free(ptr);
+}
+
+// Finds the stack of the current thread
+// The stack is usually found in the thread-local cache; the map of the stacks is locked only on a cache miss
+CDeviceStackMemoryManager* CDeviceStackAllocator::findManager( bool create )
+{
+	CDeviceStackMemoryManager* manager = findInStackManagerCache( id );
+	if( manager != nullptr ) {
+		return manager;
+	}
 
+	thread::id threadId = this_thread::get_id();
 	{
-		deviceManager = stackManagers.find( id )->second;
+		if( !mutex.try_lock() ) {
+			memoryPool.AddLockContention();
+			mutex.lock();
+		}
+		std::lock_guard<std::mutex> lock( mutex, std::adopt_lock );
+		auto result = stackManagers.find( threadId );
+		if( result == stackManagers.end() ) {
+			if( !create ) {
+				return 0;
+			}
+			result = stackManagers.insert( make_pair( threadId, new CDeviceStackMemoryManager( memoryPool ) ) ).first;
+		}
+		manager = result->second;
 	}
-
-	deviceManager->Free(ptr);
+	addToStackManagerCache( id, manager );
+	return manager;
 }
 
 } // namespace NeoML
@@ -22,6 +22,7 @@ limitations under the License.
 #include <mutex>
 #include <unordered_map>
 #include <thread>
+#include <atomic>
 
 using namespace std;
 
@@ -43,8 +44,12 @@ public:
 private:
 	CMemoryPool& memoryPool;
 	const int memoryAlignment;
+	const size_t id; // the unique identifier of the allocator, used as a key in the thread-local cache
+	std::mutex mutex; // protects the map of the thread stacks
 	std::unordered_map< thread::id, CDeviceStackMemoryManager*,
 		hash<thread::id>, equal_to<thread::id>, CrtAllocator< pair<const thread::id, CDeviceStackMemoryManager*> > > stackManagers;
+
+	CDeviceStackMemoryManager* findManager( bool create );
 };
 
 } // namespace NeoML
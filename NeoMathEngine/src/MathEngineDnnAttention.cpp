@@ -0,0 +1,63 @@
+/* Copyright © 2017-2021 ABBYY Production LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+--------------------------------------------------------------------------------------------------------------*/
+
+#include <common.h>
+#pragma hdrstop
+
+#include <MathEngineDnnAttention.h>
+#include <NeoMathEngine/NeoMathEngine.h>
+
+namespace NeoML {
+
+void MultiheadAttentionByHeads( IMathEngine& mathEngine, int batchSize, int headCount, int headSize,
+	int seqQ, int seqK, float multiplier, const CConstFloatHandle& q, const CConstFloatHandle& k,
+	const CConstFloatHandle& v, const CConstFloatHandle& mask, const CFloatHandle& result )
+{
+	const int rowSize = headCount * headSize;
+	const int attentionSize = seqQ * seqK;
+
+	// The attention matrix is stored transposed [seqK x seqQ]
+	// That allows to multiply it by the strided V_i without any copying
+	CFloatHandleStackVar attention( mathEngine, attentionSize );
+	CFloatHandleStackVar transposedMask( mathEngine, mask.IsNull() ? 1 : attentionSize );
+	if( !mask.IsNull() ) {
+		mathEngine.TransposeMatrix( 1, mask, seqQ, 1, seqK, 1, transposedMask, attentionSize );
+	}
+	CFloatHandleStackVar multiplierVar( mathEngine, 1 );
+	multiplierVar.SetValue( multiplier );
+
+	mathEngine.VectorFill( result, 0.f, batchSize * seqQ * rowSize );
+	for( int batch = 0; batch < batchSize; ++batch ) {
+		for( int head = 0; head < headCount; ++head ) {
+			const int qOffset = batch * seqQ * rowSize + head * headSize;
+			const int kOffset = batch * seqK * rowSize + head * headSize;
+
+			// K_i * Q_i^T
+			mathEngine.MultiplyMatrixByTransposedMatrix( k + kOffset, seqK, headSize, rowSize,
+				q + qOffset, seqQ, rowSize, attention, seqQ, attentionSize );
+			mathEngine.VectorMultiply( attention, attention, attentionSize, multiplierVar );
+			if( !mask.IsNull() ) {
+				mathEngine.VectorAdd( attention, transposedMask, attention, attentionSize );
+			}
+			mathEngine.MatrixSoftmaxByColumns( attention, seqK, seqQ, attention );
+
+			// softmax( Q_i * K_i^T ) * V_i
+			mathEngine.MultiplyTransposedMatrixByMatrixAndAdd( attention, seqK, seqQ, seqQ,
+				v + kOffset, headSize, rowSize, result + qOffset, rowSize, ( seqQ - 1 ) * rowSize + headSize );
+		}
+	}
+}
+
+} // namespace NeoML
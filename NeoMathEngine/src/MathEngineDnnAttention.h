@@ -0,0 +1,29 @@
+/* Copyright © 2017-2021 ABBYY Production LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+--------------------------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <NeoMathEngine/NeoMathEngine.h>
+
+namespace NeoML {
+
+// Calculates IDnnEngine::MultiheadAttention with the general-purpose operations of the given math engine
+// Processes the heads one by one, so only one [seqK x seqQ] attention matrix is stored at a time
+// Used by the math engines which don't have the specialized implementation
+void MultiheadAttentionByHeads( IMathEngine& mathEngine, int batchSize, int headCount, int headSize,
+	int seqQ, int seqK, float multiplier, const CConstFloatHandle& q, const CConstFloatHandle& k,
+	const CConstFloatHandle& v, const CConstFloatHandle& mask, const CFloatHandle& result );
+
+} // namespace NeoML
@@ -0,0 +1,113 @@
+/* Copyright © 2017-2021 ABBYY Production LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+--------------------------------------------------------------------------------------------------------------*/
+
+#include <common.h>
+#pragma hdrstop
+
+#include <MathEngineDnnRecurrent.h>
+#include <NeoMathEngine/NeoMathEngine.h>
+
+namespace NeoML {
+
+void LstmRecurrentByPrimitives( IMathEngine& mathEngine, bool reverse, int sequenceLength, int batchSize, int hiddenSize,
+	const CConstFloatHandle& inputGates, const CConstFloatHandle& recurWeights,
+	const CConstFloatHandle& initialHidden, const CConstFloatHandle& initialState,
+	const CFloatHandle& hidden, const CFloatHandle& state )
+{
+	const int stepSize = batchSize * hiddenSize;
+	const int gateSize = 4 * hiddenSize;
+	const int gatesStepSize = batchSize * gateSize;
+
+	CFloatHandleStackVar gates( mathEngine, gatesStepSize );
+	CFloatHandleStackVar stateTanh( mathEngine, hiddenSize );
+	CFloatHandleStackVar zeros( mathEngine, stepSize );
+	mathEngine.VectorFill( zeros, 0.f, stepSize );
+
+	CConstFloatHandle hPrev = initialHidden.IsNull() ? CConstFloatHandle( zeros.GetHandle() ) : initialHidden;
+	CConstFloatHandle cPrev = initialState.IsNull() ? CConstFloatHandle( zeros.GetHandle() ) : initialState;
+	for( int step = 0; step < sequenceLength; ++step ) {
+		const int pos = reverse ? sequenceLength - 1 - step : step;
+		const CFloatHandle h = hidden + pos * stepSize;
+
+		mathEngine.MultiplyMatrixByTransposedMatrix( hPrev, batchSize, hiddenSize, hiddenSize,
+			recurWeights, gateSize, hiddenSize, gates, gateSize, gatesStepSize );
+		mathEngine.VectorAdd( gates, inputGates + pos * gatesStepSize, gates, gatesStepSize );
+
+		for( int b = 0; b < batchSize; ++b ) {
+			const CFloatHandle main = gates.GetHandle() + b * gateSize;
+			const CFloatHandle forget = main + hiddenSize;
+			const CFloatHandle input = forget + hiddenSize;
+			const CFloatHandle output = input + hiddenSize;
+			const CFloatHandle c = state + pos * stepSize + b * hiddenSize;
+
+			mathEngine.VectorTanh( main, main, hiddenSize );
+			mathEngine.VectorSigmoid( forget, forget, 3 * hiddenSize );
+			mathEngine.VectorEltwiseMultiply( input, main, c, hiddenSize );
+			mathEngine.VectorEltwiseMultiplyAdd( forget, cPrev + b * hiddenSize, c, hiddenSize );
+			mathEngine.VectorTanh( c, stateTanh, hiddenSize );
+			mathEngine.VectorEltwiseMultiply( output, stateTanh, h + b * hiddenSize, hiddenSize );
+		}
+
+		hPrev = h;
+		cPrev = state + pos * stepSize;
+	}
+}
+
+void GruRecurrentByPrimitives( IMathEngine& mathEngine, bool reverse, int sequenceLength, int batchSize, int hiddenSize,
+	const CConstFloatHandle& inputGates, const CConstFloatHandle& inputMain,
+	const CConstFloatHandle& gateWeights, const CConstFloatHandle& mainWeights,
+	const CConstFloatHandle& initialHidden, const CFloatHandle& hidden )
+{
+	const int stepSize = batchSize * hiddenSize;
+	const int gateSize = 2 * hiddenSize;
+	const int gatesStepSize = batchSize * gateSize;
+
+	CFloatHandleStackVar gates( mathEngine, gatesStepSize );
+	CFloatHandleStackVar resetHidden( mathEngine, stepSize );
+	CFloatHandleStackVar main( mathEngine, stepSize );
+	CFloatHandleStackVar zeros( mathEngine, stepSize );
+	mathEngine.VectorFill( zeros, 0.f, stepSize );
+
+	CConstFloatHandle hPrev = initialHidden.IsNull() ? CConstFloatHandle( zeros.GetHandle() ) : initialHidden;
+	for( int step = 0; step < sequenceLength; ++step ) {
+		const int pos = reverse ? sequenceLength - 1 - step : step;
+		const CFloatHandle h = hidden + pos * stepSize;
+
+		mathEngine.MultiplyMatrixByTransposedMatrix( hPrev, batchSize, hiddenSize, hiddenSize,
+			gateWeights, gateSize, hiddenSize, gates, gateSize, gatesStepSize );
+		mathEngine.VectorAdd( gates, inputGates + pos * gatesStepSize, gates, gatesStepSize );
+		mathEngine.VectorSigmoid( gates, gates, gatesStepSize );
+
+		for( int b = 0; b < batchSize; ++b ) {
+			mathEngine.VectorEltwiseMultiply( gates.GetHandle() + b * gateSize + hiddenSize, hPrev + b * hiddenSize,
+				resetHidden.GetHandle() + b * hiddenSize, hiddenSize );
+		}
+		mathEngine.MultiplyMatrixByTransposedMatrix( resetHidden, batchSize, hiddenSize, hiddenSize,
+			mainWeights, hiddenSize, hiddenSize, main, hiddenSize, stepSize );
+		mathEngine.VectorAdd( main, inputMain + pos * stepSize, main, stepSize );
+		mathEngine.VectorTanh( main, main, stepSize );
+
+		// h = main + update * ( hPrev - main )
+		mathEngine.VectorSub( hPrev, main, h, stepSize );
+		for( int b = 0; b < batchSize; ++b ) {
+			mathEngine.VectorEltwiseMultiply( gates.GetHandle() + b * gateSize, h + b * hiddenSize, h + b * hiddenSize, hiddenSize );
+		}
+		mathEngine.VectorAdd( h, main, h, stepSize );
+
+		hPrev = h;
+	}
+}
+
+} // namespace NeoML
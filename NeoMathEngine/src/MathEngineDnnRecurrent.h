@@ -0,0 +1,33 @@
+/* Copyright © 2017-2021 ABBYY Production LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+--------------------------------------------------------------------------------------------------------------*/
+
+#pragma once
+
+#include <NeoMathEngine/NeoMathEngine.h>
+
+namespace NeoML {
+
+// Calculate IDnnEngine::LstmRecurrent and IDnnEngine::GruRecurrent with the general-purpose operations of the given math engine
+// Used by the math engines which don't have the specialized implementation
+void LstmRecurrentByPrimitives( IMathEngine& mathEngine, bool reverse, int sequenceLength, int batchSize, int hiddenSize,
+	const CConstFloatHandle& inputGates, const CConstFloatHandle& recurWeights,
+	const CConstFloatHandle& initialHidden, const CConstFloatHandle& initialState,
+	const CFloatHandle& hidden, const CFloatHandle& state );
+void GruRecurrentByPrimitives( IMathEngine& mathEngine, bool reverse, int sequenceLength, int batchSize, int hiddenSize,
+	const CConstFloatHandle& inputGates, const CConstFloatHandle& inputMain,
+	const CConstFloatHandle& gateWeights, const CConstFloatHandle& mainWeights,
+	const CConstFloatHandle& initialHidden, const CFloatHandle& hidden );
+
+} // namespace NeoML
@@ -96,108 +96,254 @@ static const unsigned int BufferSizes[] = {
 template <typename T, int size>
 inline constexpr int lengthof( T(&)[size] ) { return size; }
 
+// The thread-local cache of the thread data for the last pools used by the thread
+// The pool identifiers are never reused, so the entries of the destroyed pools never match
+// The entries are ordered from the most to the least recently used
+struct CThreadDataCacheEntry {
+	size_t PoolId;
+	void* Data;
+};
+
+static const int ThreadDataCacheSize = 4;
+static thread_local CThreadDataCacheEntry threadDataCache[ThreadDataCacheSize];
+
+// Finds the data of the pool in the cache and moves it to the front; returns nullptr if the pool is not in the cache
+static void* findInThreadDataCache( size_t poolId )
+{
+	for( int i = 0; i < ThreadDataCacheSize; ++i ) {
+		if( threadDataCache[i].PoolId == poolId ) {
+			const CThreadDataCacheEntry entry = threadDataCache[i];
+			for( int j = i; j > 0; --j ) {
+				threadDataCache[j] = threadDataCache[j - 1];
+			}
+			threadDataCache[0] = entry;
+			return entry.Data;
+		}
+	}
+	return nullptr;
+}
+
+// Adds the data of the pool to the front of the cache, evicting the least recently used entry
+static void addToThreadDataCache( size_t poolId, void* data )
+{
+	for( int i = ThreadDataCacheSize - 1; i > 0; --i ) {
+		threadDataCache[i] = threadDataCache[i - 1];
+	}
+	threadDataCache[0].PoolId = poolId;
+	threadDataCache[0].Data = data;
+}
+
+static std::atomic<size_t> memoryPoolNextId( 1 );
+
+// Takes the lock and counts the cases when it was held by another thread
+template<class TMutex, class TCounter>
+static inline void lockCounted( TMutex& mutex, TCounter& contentions )
+{
+	if( !mutex.try_lock() ) {
+		++contentions;
+		mutex.lock();
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------
+
+CMemoryPool::CThreadData::CThreadData( bool enabled ) :
+	Enabled( enabled ),
+	UsedMemory( 0 ),
+	PoolAllocations( 0 ),
+	DeviceAllocations( 0 ),
+	LocalFrees( 0 ),
+	CrossThreadFrees( 0 ),
+	LockContentions( 0 )
+{
+	for( size_t i = 0; i < sizeof( BufferSizes ) / sizeof( *BufferSizes ); ++i ) {
+		Pool.push_back( new CMemoryBufferPool( BufferSizes[i] ) );
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------
+
 CMemoryPool::CMemoryPool( size_t _memoryLimit, IRawMemoryManager* _rawMemoryManager, bool reuseMemoryMode ) :
 	memoryLimit( _memoryLimit ),
 	rawMemoryManager( _rawMemoryManager ),
 	defaultReuseMemoryMode( reuseMemoryMode ),
+	id( memoryPoolNextId++ ),
 	allocatedMemory( 0 ),
-	freeMemorySize( _memoryLimit ),
-	peakMemoryUsage( 0 )
+	peakMemoryUsage( 0 ),
+	registryLockContentions( 0 )
 {
 }
 
 CMemoryPool::~CMemoryPool()
 {
 	for( auto curPool : pools ) {
-		cleanUp( curPool.first );
-		for( auto curMemBufferPool : curPool.second.Pool ) {
+		cleanUp( *curPool.second );
+		for( auto curMemBufferPool : curPool.second->Pool ) {
 			delete curMemBufferPool;
 		}
+		delete curPool.second;
 	}
 }
 
 void CMemoryPool::SetReuseMemoryMode( bool enable )
 {
-	thread::id id = this_thread::get_id();
-	auto pool = pools.find( id );
-	if( pool == pools.end() ) {
-		createPools( id );
-		pool = pools.find( id );
-	}
-
-	pool->second.Enabled = enable;
+	CThreadData& data = getThreadData();
+	std::lock_guard<std::mutex> lock( data.Mutex );
+	data.Enabled = enable;
 }
 
 CMemoryHandle CMemoryPool::Alloc( size_t size )
 {
-	thread::id id = this_thread::get_id();
-	auto pool = pools.find( id );
-	if( pool == pools.end() ) {
-		createPools( id );
-		pool = pools.find( id );
-	}
+	CThreadData& data = getThreadData();
+	lockCounted( data.Mutex, data.LockContentions );
+	std::lock_guard<std::mutex> lock( data.Mutex, std::adopt_lock );
 
-	CMemoryHandle result = tryAlloc( size, pool->second );
+	CMemoryHandle result = tryAlloc( size, data );
 	if( !result.IsNull() ) {
 		return result;
 	}
 
 	// Not enough memory. Try to free all allocated pools
-	CleanUp();
-	return tryAlloc( size, pool->second );
+	cleanUp( data );
+	return tryAlloc( size, data );
 }
 
 void CMemoryPool::Free( const CMemoryHandle& handle )
 {
-	TUsedAddressMap::const_iterator pos = usedMap.find( GetRaw(handle) );
-	const CUsedInfo& info = pos->second;
-	if( info.pool != 0 ) {
-		info.pool->Free(info.buffer);
-		freeMemorySize += info.pool->BufferSize;
-	} else {
-		// Large buffer, don't use the pool
-		freeMemory(info.size, handle);
-		freeMemorySize += info.size;
+	void* ptr = GetRaw( handle );
+
+	// Fast path: the block was allocated on the current thread
+	CThreadData& data = getThreadData();
+	{
+		lockCounted( data.Mutex, data.LockContentions );
+		std::lock_guard<std::mutex> lock( data.Mutex, std::adopt_lock );
+		if( tryFree( ptr, handle, data ) ) {
+			data.LocalFrees++;
+			return;
+		}
+	}
+
+	// Slow path: find the thread that allocated the block
+	lockRegistry();
+	std::lock_guard<std::mutex> registryLock( registryMutex, std::adopt_lock );
+	for( auto cur : pools ) {
+		CThreadData& owner = *cur.second;
+		if( &owner == &data ) {
+			continue;
+		}
+		lockCounted( owner.Mutex, data.LockContentions );
+		std::lock_guard<std::mutex> lock( owner.Mutex, std::adopt_lock );
+		if( tryFree( ptr, handle, owner ) ) {
+			owner.CrossThreadFrees++;
+			return;
+		}
+	}
+	ASSERT_EXPR( false );
+}
+
+size_t CMemoryPool::GetFreeMemorySize() const
+{
+	size_t usedMemory = 0;
+	lockRegistry();
+	std::lock_guard<std::mutex> lock( registryMutex, std::adopt_lock );
+	for( auto cur : pools ) {
+		usedMemory += cur.second->UsedMemory;
 	}
-	usedMap.erase( pos );
+	return usedMemory < memoryLimit ? memoryLimit - usedMemory : 0;
 }
 
 size_t CMemoryPool::GetMemoryInPools() const
 {
-	thread::id id = this_thread::get_id();
-	auto pool = pools.find( id );
-	if( pool == pools.end() ) {
+	CThreadData* data = findThreadData();
+	if( data == nullptr ) {
 		return 0;
 	}
-	const TPoolVector& threadPools = pool->second.Pool;
+	std::lock_guard<std::mutex> lock( data->Mutex );
+	const TPoolVector& threadPools = data->Pool;
 	return std::accumulate( threadPools.begin(), threadPools.end(), size_t( 0 ),
 		[] ( const size_t& sum, const CMemoryBufferPool* cur ) { return sum + cur->GetMemoryInPool(); } );
 }
 
+void CMemoryPool::GetStatistics( CMemoryPoolStatistics& statistics ) const
+{
+	statistics = CMemoryPoolStatistics();
+	lockRegistry();
+	std::lock_guard<std::mutex> registryLock( registryMutex, std::adopt_lock );
+	for( auto cur : pools ) {
+		CThreadData& data = *cur.second;
+		std::lock_guard<std::mutex> lock( data.Mutex );
+		statistics.ThreadCount++;
+		statistics.PoolAllocations += data.PoolAllocations;
+		statistics.DeviceAllocations += data.DeviceAllocations;
+		statistics.LocalFrees += data.LocalFrees;
+		statistics.CrossThreadFrees += data.CrossThreadFrees;
+		statistics.LockContentions += data.LockContentions;
+	}
+	statistics.LockContentions += registryLockContentions;
+}
+
 void CMemoryPool::CleanUp()
 {
-	cleanUp( this_thread::get_id() );
+	CThreadData* data = findThreadData();
+	if( data != nullptr ) {
+		std::lock_guard<std::mutex> lock( data->Mutex );
+		cleanUp( *data );
+	}
 }
 
-void CMemoryPool::createPools( thread::id id )
+// Gets the data of the current thread, creating it if necessary
+CMemoryPool::CThreadData& CMemoryPool::getThreadData()
 {
-	CThreadData threadData;
-	threadData.Enabled = defaultReuseMemoryMode;
-	for( size_t i = 0; i < sizeof( BufferSizes ) / sizeof( *BufferSizes ); ++i ) {
-		threadData.Pool.push_back( new CMemoryBufferPool( BufferSizes[i] ) );
+	CThreadData* result = findThreadData();
+	if( result != nullptr ) {
+		return *result;
 	}
 
-	pools[id] = threadData;
+	{
+		lockRegistry();
+		std::lock_guard<std::mutex> lock( registryMutex, std::adopt_lock );
+		CThreadData*& data = pools[this_thread::get_id()];
+		if( data == nullptr ) {
+			data = new CThreadData( defaultReuseMemoryMode );
+		}
+		result = data;
+	}
+
+	addToThreadDataCache( id, result );
+	return *result;
 }
 
-void CMemoryPool::cleanUp( thread::id id )
+// Finds the data of the current thread; returns nullptr if the thread has not used the pool yet
+CMemoryPool::CThreadData* CMemoryPool::findThreadData() const
 {
-	auto pool = pools.find( id );
-	if( pool == pools.end() ) {
-		return;
+	void* cached = findInThreadDataCache( id );
+	if( cached != nullptr ) {
+		return static_cast<CThreadData*>( cached );
 	}
 
-	for( auto cur : pool->second.Pool ) {
+	// The thread data may exist but have been evicted from the cache
+	CThreadData* result = nullptr;
+	{
+		lockRegistry();
+		std::lock_guard<std::mutex> lock( registryMutex, std::adopt_lock );
+		auto pool = pools.find( this_thread::get_id() );
+		if( pool == pools.end() ) {
+			return nullptr;
+		}
+		result = pool->second;
+	}
+	addToThreadDataCache( id, result );
+	return result;
+}
+
+void CMemoryPool::lockRegistry() const
+{
+	lockCounted( registryMutex, registryLockContentions );
+}
+
+void CMemoryPool::cleanUp( CThreadData& data )
+{
+	for( auto cur : data.Pool ) {
 		CMemoryBuffer* buffer = cur->TryAlloc();
 		while( buffer != 0 ) {
 			freeMemory(cur->BufferSize, buffer->Data);
@@ -219,8 +365,9 @@ CMemoryHandle CMemoryPool::tryAlloc( size_t size, CThreadData& data )
 		// Allocate without using the buffers pool
 		CMemoryHandle result = alloc( size );
 		if( !result.IsNull() ) {
-			usedMap[GetRaw( result )] = CUsedInfo( size, 0, 0 );
-			freeMemorySize -= size;
+			data.UsedMap[GetRaw( result )] = CUsedInfo( size, 0, 0 );
+			data.UsedMemory += size;
+			data.DeviceAllocations++;
 		}
 		return result;
 	}
@@ -237,25 +384,59 @@ CMemoryHandle CMemoryPool::tryAlloc( size_t size, CThreadData& data )
 			delete buffer;
 			return CMemoryHandle();
 		}
+		data.DeviceAllocations++;
+	} else {
+		data.PoolAllocations++;
 	}
-	freeMemorySize -= pool->BufferSize;
-	usedMap[GetRaw(buffer->Data)] = CUsedInfo(size, buffer, pool);
+	data.UsedMemory += pool->BufferSize;
+	data.UsedMap[GetRaw(buffer->Data)] = CUsedInfo(size, buffer, pool);
 
 	return buffer->Data;
 }
 
+// Frees the block if it was allocated by the given thread; the thread data must be locked
+bool CMemoryPool::tryFree( void* ptr, const CMemoryHandle& handle, CThreadData& data )
+{
+	TUsedAddressMap::const_iterator pos = data.UsedMap.find( ptr );
+	if( pos == data.UsedMap.end() ) {
+		return false;
+	}
+
+	const CUsedInfo& info = pos->second;
+	if( info.pool != 0 ) {
+		info.pool->Free(info.buffer);
+		data.UsedMemory -= info.pool->BufferSize;
+	} else {
+		// Large buffer, don't use the pool
+		freeMemory(info.size, handle);
+		data.UsedMemory -= info.size;
+	}
+	data.UsedMap.erase( pos );
+	return true;
+}
+
 CMemoryHandle CMemoryPool::alloc( size_t size )
 {
-	if( size > memoryLimit || allocatedMemory > memoryLimit - size ) {
+	if( size > memoryLimit ) {
+		return CMemoryHandle();
+	}
+	// Reserve the memory first so that the concurrent allocations can't exceed the limit together
+	const size_t newAllocatedMemory = allocatedMemory.fetch_add( size ) + size;
+	if( newAllocatedMemory > memoryLimit ) {
+		allocatedMemory -= size;
 		return CMemoryHandle();
 	}
-	
+
 	CMemoryHandle result = rawMemoryManager->Alloc( size );
 
-	if( !result.IsNull() ) {
-		allocatedMemory += size;
+	if( result.IsNull() ) {
+		allocatedMemory -= size;
+		return result;
+	}
+
+	size_t peak = peakMemoryUsage;
+	while( peak < newAllocatedMemory && !peakMemoryUsage.compare_exchange_weak( peak, newAllocatedMemory ) ) {
 	}
-	peakMemoryUsage = max( peakMemoryUsage, allocatedMemory );
 
 	return result;
 }
@@ -16,11 +16,14 @@ limitations under the License.
 #pragma once
 
 #include <MathEngineAllocator.h>
+#include <NeoMathEngine/NeoMathEngine.h>
 #include <NeoMathEngine/MemoryHandle.h>
 #include <NeoMathEngine/CrtAllocatedObject.h>
 #include <RawMemoryManager.h>
 #include <unordered_map>
 #include <thread>
+#include <mutex>
+#include <atomic>
 
 namespace NeoML {
 
@@ -28,6 +31,10 @@ class CMemoryBufferPool;
 class CMemoryBuffer;
 
 // The memory manager
+// Each thread has its own set of pools that are found via a thread-local cache,
+// so that allocating and freeing on the same thread never takes a lock shared with other threads.
+// Only the first access from a new thread, the statistics queries and the frees of the blocks allocated on another thread
+// go through the shared registry lock
 class CMemoryPool : public CCrtAllocatedObject {
 public:
 	CMemoryPool( size_t memoryLimit, IRawMemoryManager* rawMemoryManager, bool reuseMemoryMode );
@@ -43,7 +50,7 @@ public:
 	void Free( const CMemoryHandle& handle );
 
 	// Gets the amount of memory currently available
-	size_t GetFreeMemorySize() const { return freeMemorySize; }
+	size_t GetFreeMemorySize() const;
 
 	// Gets the peak memory usage achieved during processing
 	size_t GetPeakMemoryUsage() const { return peakMemoryUsage; }
@@ -51,26 +58,18 @@ public:
 	// Gets the amount of memory used for the pools
 	size_t GetMemoryInPools() const;
 
+	// Gets the statistics aggregated over all threads
+	void GetStatistics( CMemoryPoolStatistics& statistics ) const;
+
 	// Frees all memory on the current thread
 	void CleanUp();
 
+	// Counts the contention of a lock that protects the per-thread data of an allocator working over this pool
+	// The contentions are reported in the statistics
+	void AddLockContention() { registryLockContentions++; }
+
 private:
 	typedef std::vector< CMemoryBufferPool*, CrtAllocator<CMemoryBufferPool*> > TPoolVector;
-	struct CThreadData {
-		TPoolVector Pool;
-		bool Enabled;
-	};
-	typedef std::unordered_map< std::thread::id, CThreadData, std::hash<std::thread::id>, std::equal_to<std::thread::id>,
-		CrtAllocator< std::pair<const std::thread::id, CThreadData> > > TPoolMap;
-
-	const size_t memoryLimit;
-	IRawMemoryManager* const rawMemoryManager;
-	const bool defaultReuseMemoryMode;
-
-	TPoolMap pools;
-	size_t allocatedMemory; // the amount of memory allocated on device (belonging to the user + used for the pools)
-	size_t freeMemorySize; // the amount of free avialable memory
-	size_t peakMemoryUsage; // peak memory usage
 
 	// The information about a memory block
 	struct CUsedInfo {
@@ -85,11 +84,44 @@ private:
 	};
 	typedef std::unordered_map< void*, CUsedInfo, std::hash<void*>, std::equal_to<void*>,
 		CrtAllocator< std::pair<void* const, CUsedInfo> > > TUsedAddressMap;
-	TUsedAddressMap usedMap;
 
-	void createPools( std::thread::id id );
-	void cleanUp( std::thread::id id );
+	// The data of one thread
+	// The mutex is taken only by the owner thread unless another thread frees its block or collects the statistics
+	struct CThreadData : public CCrtAllocatedObject {
+		std::mutex Mutex;
+		TPoolVector Pool;
+		bool Enabled;
+		TUsedAddressMap UsedMap; // the blocks allocated by this thread
+		std::atomic<size_t> UsedMemory; // the memory given to the user by this thread
+		// The statistics
+		size_t PoolAllocations;
+		size_t DeviceAllocations;
+		size_t LocalFrees;
+		size_t CrossThreadFrees;
+		size_t LockContentions;
+
+		explicit CThreadData( bool enabled );
+	};
+	typedef std::unordered_map< std::thread::id, CThreadData*, std::hash<std::thread::id>, std::equal_to<std::thread::id>,
+		CrtAllocator< std::pair<const std::thread::id, CThreadData*> > > TPoolMap;
+
+	const size_t memoryLimit;
+	IRawMemoryManager* const rawMemoryManager;
+	const bool defaultReuseMemoryMode;
+	const size_t id; // the unique identifier of the pool, used as a key in the thread-local cache
+
+	mutable std::mutex registryMutex; // protects the pools map
+	TPoolMap pools;
+	std::atomic<size_t> allocatedMemory; // the amount of memory allocated on device (belonging to the user + used for the pools)
+	std::atomic<size_t> peakMemoryUsage; // peak memory usage
+	mutable std::atomic<size_t> registryLockContentions; // the number of times the registry lock was contended
+
+	CThreadData& getThreadData();
+	CThreadData* findThreadData() const;
+	void lockRegistry() const;
+	void cleanUp( CThreadData& data );
 	CMemoryHandle tryAlloc( size_t size, CThreadData& data );
+	bool tryFree( void* ptr, const CMemoryHandle& handle, CThreadData& data );
 	CMemoryHandle alloc( size_t size );
 	void freeMemory( size_t size, const CMemoryHandle& data );
 };
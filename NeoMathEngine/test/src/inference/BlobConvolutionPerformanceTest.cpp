@@ -143,8 +143,13 @@ static void blobConvolutionImpl( const CTestParams& params, int seed )
 		paddingHeight, paddingWidth, filterCount, filterHeight, filterWidth,
 		dilationHeight, dilationWidth, strideHeight, strideWidth );
 
+	// Each value is the sum of filterSize products up to 100 in absolute value
+	// The partial sums are large even when the result is small, so the absolute rounding error grows with the filter size
+	const int filterSize = filterHeight * filterWidth * inputDepth * inputChannels;
+	const float absPrecision = 1e-4f * filterSize;
 	for( int i = 0; i < outputSize; ++i ) {
-		ASSERT_TRUE( FloatEq( expectedData[i], actualData[i] ) );
+		ASSERT_TRUE( FloatEq( expectedData[i], actualData[i], 1e-3f )
+			|| std::fabs( expectedData[i] - actualData[i] ) < absPrecision );
 	}
 }
 
@@ -14,6 +14,9 @@ limitations under the License.
 --------------------------------------------------------------------------------------------------------------*/
 
 #include <TestFixture.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
 
 using namespace NeoML;
 using namespace NeoMLTest;
@@ -635,6 +638,26 @@ INSTANTIATE_TEST_CASE_P( CMathEngineBlobConvolutionTestInstantiation, CMathEngin
 			"IsZeroFreeTerm = 1;"
 			"Values = (-10..10);"
 			"TestCount = 1;"
+		),
+		CTestParams(
+			"InputLength = 1;"
+			"InputBatch = (1..3);"
+			"InputHeight = (4..20);"
+			"InputWidth = (4..20);"
+			"InputDepth = (1..2);"
+			"InputChannels = (8..24);"
+			"FilterCount = (8..24);"
+			"FilterHeight = 3;"
+			"FilterWidth = 3;"
+			"PaddingHeight = (0..2);"
+			"PaddingWidth = (0..2);"
+			"DilationHeight = 1;"
+			"DilationWidth = 1;"
+			"StrideHeight = 1;"
+			"StrideWidth = 1;"
+			"IsZeroFreeTerm = (0..1);"
+			"Values = (-1..1);"
+			"TestCount = 20;"
 		)
 	)
 );
@@ -643,3 +666,245 @@ TEST_P( CMathEngineBlobConvolutionTest, Random )
 {
 	RUN_TEST_IMPL( blobConvolutionImpl );
 }
+
+// Turns on the convolution autotuning of the shared math engine for the lifetime of the object
+class CConvolutionAutotuningScope {
+public:
+	CConvolutionAutotuningScope() { MathEngine().SetConvolutionAutotuning( true ); }
+	~CConvolutionAutotuningScope() { MathEngine().SetConvolutionAutotuning( false ); }
+};
+
+TEST_P( CMathEngineBlobConvolutionTest, Autotune )
+{
+	CConvolutionAutotuningScope autotuning;
+	RUN_TEST_IMPL( blobConvolutionImpl );
+}
+
+static bool isConvolutionAutotuningSupported()
+{
+	CMathEngineInfo meInfo;
+	MathEngine().GetMathEngineInfo( meInfo );
+	return meInfo.Type == MET_Cpu;
+}
+
+// Runs the convolution with a wide 1*N filter and checks the result
+static void checkWideFilterConvolution( IMathEngine& engine, std::string& forwardAlgo, std::string& backwardAlgo )
+{
+	const int batch = 2;
+	const int height = 6;
+	const int width = 40;
+	const int channels = 5;
+	const int filterCount = 7;
+	const int filterWidth = 9;
+	const int paddingWidth = 4;
+	const int outputWidth = calcConvOutputSize( width, paddingWidth, filterWidth, 1, 1 );
+
+	CRandom random( 0x1234 );
+	CREATE_FILL_FLOAT_ARRAY( inputData, -1, 1, batch * height * width * channels, random )
+	CREATE_FILL_FLOAT_ARRAY( filterData, -1, 1, filterCount * filterWidth * channels, random )
+	std::vector<float> freeTermData( filterCount, 0.f );
+	std::vector<float> expectedData( batch * height * outputWidth * filterCount );
+	batchConvolutionForward( inputData.data(), filterData.data(), freeTermData.data(), expectedData.data(),
+		1, batch, height, width, 1, channels, 0, paddingWidth, filterCount, 1, filterWidth, 1, 1, 1, 1 );
+
+	CFloatBlob inputBlob( engine, 1, batch, 1, height, width, 1, channels );
+	inputBlob.CopyFrom( inputData.data() );
+	CFloatBlob filterBlob( engine, filterCount, 1, filterWidth, 1, channels );
+	filterBlob.CopyFrom( filterData.data() );
+	CFloatBlob outputBlob( engine, 1, batch, 1, height, outputWidth, 1, filterCount );
+
+	std::unique_ptr<CConvolutionDesc> convDesc( engine.InitBlobConvolution( inputBlob.GetDesc(),
+		0, paddingWidth, 1, 1, 1, 1, filterBlob.GetDesc(), outputBlob.GetDesc() ) );
+	engine.BlobConvolution( *convDesc, inputBlob.GetData(), filterBlob.GetData(), nullptr, outputBlob.GetData() );
+	forwardAlgo = engine.GetConvolutionAlgorithmName( *convDesc, true );
+	backwardAlgo = engine.GetConvolutionAlgorithmName( *convDesc, false );
+
+	std::vector<float> actualData( expectedData.size() );
+	outputBlob.CopyTo( actualData.data() );
+	for( size_t i = 0; i < actualData.size(); ++i ) {
+		ASSERT_TRUE( FloatEq( expectedData[i], actualData[i], 1e-3f ) );
+	}
+}
+
+// Creates the descriptor of a convolution with 1*1 filter and returns the chosen algorithms
+static void getPointwiseConvolutionAlgo( IMathEngine& engine, std::string& forwardAlgo, std::string& backwardAlgo )
+{
+	CFloatBlob inputBlob( engine, 1, 2, 1, 8, 8, 1, 16 );
+	CFloatBlob filterBlob( engine, 16, 1, 1, 1, 16 );
+	CFloatBlob outputBlob( engine, 1, 2, 1, 8, 8, 1, 16 );
+	std::unique_ptr<CConvolutionDesc> convDesc( engine.InitBlobConvolution( inputBlob.GetDesc(),
+		0, 0, 1, 1, 1, 1, filterBlob.GetDesc(), outputBlob.GetDesc() ) );
+	forwardAlgo = engine.GetConvolutionAlgorithmName( *convDesc, true );
+	backwardAlgo = engine.GetConvolutionAlgorithmName( *convDesc, false );
+}
+
+TEST_F( CMathEngineBlobConvolutionTest, AutotuneCache )
+{
+	if( !isConvolutionAutotuningSupported() ) {
+		return;
+	}
+
+	const char* fileName = "ConvolutionAutotuneCache.txt";
+	std::unique_ptr<IMathEngine> tunedEngine( CreateCpuMathEngine( 1, 0 ) );
+	std::unique_ptr<IMathEngine> loadedEngine( CreateCpuMathEngine( 1, 0 ) );
+
+	std::string tunedForward;
+	std::string tunedBackward;
+	tunedEngine->SetConvolutionAutotuning( true );
+	checkWideFilterConvolution( *tunedEngine, tunedForward, tunedBackward );
+	ASSERT_TRUE( tunedEngine->SaveConvolutionAutotuningCache( fileName ) );
+
+	std::string loadedForward;
+	std::string loadedBackward;
+	ASSERT_TRUE( loadedEngine->LoadConvolutionAutotuningCache( fileName ) );
+	checkWideFilterConvolution( *loadedEngine, loadedForward, loadedBackward );
+	EXPECT_EQ( tunedForward, loadedForward );
+	EXPECT_EQ( tunedBackward, loadedBackward );
+
+	std::remove( fileName );
+}
+
+TEST_F( CMathEngineBlobConvolutionTest, AutotuneCacheChoice )
+{
+	if( !isConvolutionAutotuningSupported() ) {
+		return;
+	}
+
+	const char* fileName = "ConvolutionAutotuneCacheChoice.txt";
+	std::unique_ptr<IMathEngine> tunedEngine( CreateCpuMathEngine( 1, 0 ) );
+	std::unique_ptr<IMathEngine> loadedEngine( CreateCpuMathEngine( 1, 0 ) );
+
+	// Without the cache the 1*1 convolution uses either the simd or the 1*1 algorithm
+	std::string forwardAlgo;
+	std::string backwardAlgo;
+	getPointwiseConvolutionAlgo( *loadedEngine, forwardAlgo, backwardAlgo );
+	ASSERT_NE( "gemm", forwardAlgo );
+	ASSERT_NE( "gemm", backwardAlgo );
+
+	// The choice written to the file is replaced by the general matrix multiplication
+	tunedEngine->SetConvolutionAutotuning( true );
+	getPointwiseConvolutionAlgo( *tunedEngine, forwardAlgo, backwardAlgo );
+	ASSERT_TRUE( tunedEngine->SaveConvolutionAutotuningCache( fileName ) );
+	std::vector<std::string> lines;
+	{
+		std::ifstream file( fileName );
+		for( std::string line; std::getline( file, line ); ) {
+			lines.push_back( line );
+		}
+	}
+	ASSERT_EQ( 2u, lines.size() );
+	const size_t backwardPos = lines[1].rfind( ' ' );
+	const size_t forwardPos = lines[1].rfind( ' ', backwardPos - 1 );
+	lines[1] = lines[1].substr( 0, forwardPos ) + " gemm gemm";
+	{
+		std::ofstream file( fileName );
+		for( const std::string& line : lines ) {
+			file << line << '\n';
+		}
+	}
+
+	ASSERT_TRUE( loadedEngine->LoadConvolutionAutotuningCache( fileName ) );
+	getPointwiseConvolutionAlgo( *loadedEngine, forwardAlgo, backwardAlgo );
+	EXPECT_EQ( "gemm", forwardAlgo );
+	EXPECT_EQ( "gemm", backwardAlgo );
+
+	// The wrong files are not loaded
+	EXPECT_FALSE( loadedEngine->LoadConvolutionAutotuningCache( "ConvolutionAutotuneCacheMissing.txt" ) );
+	{
+		std::ofstream file( fileName );
+		file << lines[0] << '\n' << "1 2 3\n";
+	}
+	EXPECT_FALSE( loadedEngine->LoadConvolutionAutotuningCache( fileName ) );
+	{
+		std::ofstream file( fileName );
+		file << lines[0] << '\n' << lines[1].substr( 0, forwardPos ) << " gemm unknown\n";
+	}
+	EXPECT_FALSE( loadedEngine->LoadConvolutionAutotuningCache( fileName ) );
+
+	std::remove( fileName );
+}
+
+// Runs the 3*3 convolution with the given filter and checks the result
+static void checkWinogradConvolution( IMathEngine& engine, const CConvolutionDesc& convDesc, CRandom& random )
+{
+	const int batch = 2;
+	const int size = 10;
+	const int channels = 16;
+	const int filterCount = 12;
+
+	CREATE_FILL_FLOAT_ARRAY( inputData, -1, 1, batch * size * size * channels, random )
+	CREATE_FILL_FLOAT_ARRAY( filterData, -1, 1, filterCount * 3 * 3 * channels, random )
+	CREATE_FILL_FLOAT_ARRAY( freeTermData, -1, 1, filterCount, random )
+	std::vector<float> expectedData( batch * size * size * filterCount );
+	batchConvolutionForward( inputData.data(), filterData.data(), freeTermData.data(), expectedData.data(),
+		1, batch, size, size, 1, channels, 1, 1, filterCount, 3, 3, 1, 1, 1, 1 );
+
+	CFloatBlob inputBlob( engine, 1, batch, 1, size, size, 1, channels );
+	inputBlob.CopyFrom( inputData.data() );
+	CFloatBlob filterBlob( engine, filterCount, 3, 3, 1, channels );
+	filterBlob.CopyFrom( filterData.data() );
+	CFloatBlob freeTermBlob( engine, 1, 1, 1, filterCount );
+	freeTermBlob.CopyFrom( freeTermData.data() );
+	CFloatBlob outputBlob( engine, 1, batch, 1, size, size, 1, filterCount );
+	const CFloatHandle freeTerm = freeTermBlob.GetData();
+	engine.BlobConvolution( convDesc, inputBlob.GetData(), filterBlob.GetData(), &freeTerm, outputBlob.GetData() );
+
+	std::vector<float> actualData( expectedData.size() );
+	outputBlob.CopyTo( actualData.data() );
+	for( size_t i = 0; i < actualData.size(); ++i ) {
+		ASSERT_TRUE( FloatEq( expectedData[i], actualData[i], 1e-3f ) );
+	}
+}
+
+TEST_F( CMathEngineBlobConvolutionTest, WinogradFromAutotuneCache )
+{
+	if( !isConvolutionAutotuningSupported() ) {
+		return;
+	}
+
+	const char* fileName = "ConvolutionAutotuneCacheWinograd.txt";
+	std::unique_ptr<IMathEngine> tunedEngine( CreateCpuMathEngine( 1, 0 ) );
+	std::unique_ptr<IMathEngine> loadedEngine( CreateCpuMathEngine( 1, 0 ) );
+
+	const CBlobDesc source = CFloatBlob( *loadedEngine, 1, 2, 1, 10, 10, 1, 16 ).GetDesc();
+	const CBlobDesc filter = CFloatBlob( *loadedEngine, 12, 3, 3, 1, 16 ).GetDesc();
+	const CBlobDesc result = CFloatBlob( *loadedEngine, 1, 2, 1, 10, 10, 1, 12 ).GetDesc();
+
+	// The Winograd algorithm is not used by default
+	std::unique_ptr<CConvolutionDesc> convDesc( loadedEngine->InitBlobConvolution( source, 1, 1, 1, 1, 1, 1,
+		filter, result ) );
+	EXPECT_STRNE( "winograd", loadedEngine->GetConvolutionAlgorithmName( *convDesc, true ) );
+
+	// The forward algorithm in the file is replaced by the Winograd algorithm
+	tunedEngine->SetConvolutionAutotuning( true );
+	convDesc.reset( tunedEngine->InitBlobConvolution( source, 1, 1, 1, 1, 1, 1, filter, result ) );
+	ASSERT_TRUE( tunedEngine->SaveConvolutionAutotuningCache( fileName ) );
+	std::vector<std::string> lines;
+	{
+		std::ifstream file( fileName );
+		for( std::string line; std::getline( file, line ); ) {
+			lines.push_back( line );
+		}
+	}
+	ASSERT_EQ( 2u, lines.size() );
+	const size_t backwardPos = lines[1].rfind( ' ' );
+	const size_t forwardPos = lines[1].rfind( ' ', backwardPos - 1 );
+	lines[1] = lines[1].substr( 0, forwardPos ) + " winograd" + lines[1].substr( backwardPos );
+	{
+		std::ofstream file( fileName );
+		for( const std::string& line : lines ) {
+			file << line << '\n';
+		}
+	}
+
+	ASSERT_TRUE( loadedEngine->LoadConvolutionAutotuningCache( fileName ) );
+	convDesc.reset( loadedEngine->InitBlobConvolution( source, 1, 1, 1, 1, 1, 1, filter, result ) );
+	EXPECT_STREQ( "winograd", loadedEngine->GetConvolutionAlgorithmName( *convDesc, true ) );
+
+	// The transformed filter is kept by the descriptor and must be updated when the filter changes
+	CRandom random( 0x3333 );
+	checkWinogradConvolution( *loadedEngine, *convDesc, random );
+	checkWinogradConvolution( *loadedEngine, *convDesc, random );
+
+	std::remove( fileName );
+}
@@ -0,0 +1,140 @@
+/* Copyright © 2017-2021 ABBYY Production LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+--------------------------------------------------------------------------------------------------------------*/
+#include <TestFixture.h>
+
+using namespace NeoML;
+using namespace NeoMLTest;
+
+static inline float sigmoid( float x )
+{
+	return 1.f / ( 1.f + ::expf( -x ) );
+}
+
+static void gruRecurrentNaive( bool reverse, int seqLength, int batchSize, int hiddenSize,
+	const float* inputGates, const float* inputMain, const float* gateWeights, const float* mainWeights,
+	const float* initialHidden, float* hidden )
+{
+	const int stepSize = batchSize * hiddenSize;
+	std::vector<float> gates( 2 * hiddenSize );
+	std::vector<float> resetHidden( hiddenSize );
+	for( int step = 0; step < seqLength; ++step ) {
+		const int pos = reverse ? seqLength - 1 - step : step;
+		const int prevPos = reverse ? pos + 1 : pos - 1;
+		for( int b = 0; b < batchSize; ++b ) {
+			const float* hPrev = step == 0 ? initialHidden + b * hiddenSize : hidden + prevPos * stepSize + b * hiddenSize;
+			for( int g = 0; g < 2 * hiddenSize; ++g ) {
+				float sum = inputGates[( pos * batchSize + b ) * 2 * hiddenSize + g];
+				for( int i = 0; i < hiddenSize; ++i ) {
+					sum += hPrev[i] * gateWeights[g * hiddenSize + i];
+				}
+				gates[g] = sigmoid( sum );
+			}
+			for( int i = 0; i < hiddenSize; ++i ) {
+				resetHidden[i] = gates[hiddenSize + i] * hPrev[i];
+			}
+			float* h = hidden + pos * stepSize + b * hiddenSize;
+			for( int j = 0; j < hiddenSize; ++j ) {
+				float sum = inputMain[( pos * batchSize + b ) * hiddenSize + j];
+				for( int i = 0; i < hiddenSize; ++i ) {
+					sum += resetHidden[i] * mainWeights[j * hiddenSize + i];
+				}
+				const float main = ::tanhf( sum );
+				h[j] = ( 1.f - gates[j] ) * main + gates[j] * hPrev[j];
+			}
+		}
+	}
+}
+
+static void gruInferenceTestImpl( const CTestParams& params, int seed )
+{
+	CRandom random( seed );
+	const CInterval batchLengthInterval = params.GetInterval( "BatchLength" );
+	const CInterval batchWidthInterval = params.GetInterval( "BatchWidth" );
+	const CInterval hiddenSizeInterval = params.GetInterval( "HiddenSize" );
+
+	const int batchLength = random.UniformInt( batchLengthInterval.Begin, batchLengthInterval.End );
+	const int batchWidth = random.UniformInt( batchWidthInterval.Begin, batchWidthInterval.End );
+	const int hiddenSize = random.UniformInt( hiddenSizeInterval.Begin, hiddenSizeInterval.End );
+	const bool reverse = random.Next() % 2 == 1;
+	const bool hasInitialHidden = random.Next() % 2 == 1;
+
+	const int stepSize = batchWidth * hiddenSize;
+	const int dataSize = batchLength * stepSize;
+
+	CREATE_FILL_FLOAT_ARRAY( inputGatesData, -2.f, 2.f, 2 * dataSize, random );
+	CFloatBlob inputGatesBlob( MathEngine(), batchLength, batchWidth, 1, 1, 1, 1, 2 * hiddenSize );
+	inputGatesBlob.CopyFrom( inputGatesData.data() );
+
+	CREATE_FILL_FLOAT_ARRAY( inputMainData, -2.f, 2.f, dataSize, random );
+	CFloatBlob inputMainBlob( MathEngine(), batchLength, batchWidth, 1, 1, 1, 1, hiddenSize );
+	inputMainBlob.CopyFrom( inputMainData.data() );
+
+	CREATE_FILL_FLOAT_ARRAY( gateWeightsData, -0.5f, 0.5f, 2 * hiddenSize * hiddenSize, random );
+	CFloatBlob gateWeightsBlob( MathEngine(), 1, 2 * hiddenSize, 1, 1, 1, 1, hiddenSize );
+	gateWeightsBlob.CopyFrom( gateWeightsData.data() );
+
+	CREATE_FILL_FLOAT_ARRAY( mainWeightsData, -0.5f, 0.5f, hiddenSize * hiddenSize, random );
+	CFloatBlob mainWeightsBlob( MathEngine(), 1, hiddenSize, 1, 1, 1, 1, hiddenSize );
+	mainWeightsBlob.CopyFrom( mainWeightsData.data() );
+
+	std::vector<float> initialHiddenData( stepSize, 0.f );
+	CFloatBlob initialHiddenBlob( MathEngine(), 1, batchWidth, 1, 1, 1, 1, hiddenSize );
+	if( hasInitialHidden ) {
+		for( int i = 0; i < stepSize; ++i ) {
+			initialHiddenData[i] = static_cast<float>( random.Uniform( -1., 1. ) );
+		}
+		initialHiddenBlob.CopyFrom( initialHiddenData.data() );
+	}
+
+	std::vector<float> expectedData( dataSize );
+	gruRecurrentNaive( reverse, batchLength, batchWidth, hiddenSize, inputGatesData.data(), inputMainData.data(),
+		gateWeightsData.data(), mainWeightsData.data(), initialHiddenData.data(), expectedData.data() );
+
+	CFloatBlob hiddenBlob( MathEngine(), batchLength, batchWidth, 1, 1, 1, 1, hiddenSize );
+	MathEngine().GruRecurrent( reverse, batchLength, batchWidth, hiddenSize,
+		inputGatesBlob.GetData(), inputMainBlob.GetData(), gateWeightsBlob.GetData(), mainWeightsBlob.GetData(),
+		hasInitialHidden ? initialHiddenBlob.GetData() : CFloatHandle(), hiddenBlob.GetData() );
+	std::vector<float> actualData( dataSize );
+	hiddenBlob.CopyTo( actualData.data() );
+
+	for( int i = 0; i < dataSize; ++i ) {
+		EXPECT_TRUE( FloatEq( expectedData[i], actualData[i], 1e-4f ) );
+	}
+}
+
+class CGruInferenceTest : public CTestFixtureWithParams {
+};
+
+INSTANTIATE_TEST_CASE_P( CGruInferenceTest, CGruInferenceTest,
+	::testing::Values(
+		CTestParams(
+			"BatchLength = (1..20);"
+			"BatchWidth = (1..10);"
+			"HiddenSize = (1..10);"
+			"TestCount = 300;"
+		),
+		CTestParams(
+			"BatchLength = (1..10);"
+			"BatchWidth = (20..60);"
+			"HiddenSize = (30..70);"
+			"TestCount = 10;"
+		)
+	)
+);
+
+TEST_P( CGruInferenceTest, Random )
+{
+	RUN_TEST_IMPL( gruInferenceTestImpl );
+}
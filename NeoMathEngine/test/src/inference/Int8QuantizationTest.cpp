@@ -0,0 +1,238 @@
+/* Copyright © 2017-2021 ABBYY Production LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+--------------------------------------------------------------------------------------------------------------*/
+
+#include <TestFixture.h>
+
+using namespace NeoML;
+using namespace NeoMLTest;
+
+// Quantizes the row the same way as the math engine does
+static void quantizeRowNaive( const float* row, int width, float scale, std::vector<int>& quantized )
+{
+	quantized.resize( width );
+	for( int i = 0; i < width; ++i ) {
+		quantized[i] = static_cast<int>( std::min( 127.f, std::max( -127.f, ::roundf( row[i] / scale ) ) ) );
+	}
+}
+
+static float rowScaleNaive( const float* row, int width )
+{
+	float maxAbs = 0;
+	for( int i = 0; i < width; ++i ) {
+		maxAbs = std::max( maxAbs, ::fabsf( row[i] ) );
+	}
+	return maxAbs > 0 ? maxAbs / 127.f : 1.f;
+}
+
+static bool isInt8Supported()
+{
+	CMathEngineInfo meInfo;
+	MathEngine().GetMathEngineInfo( meInfo );
+	return meInfo.Type == MET_Cpu;
+}
+
+static void int8MatrixMultiplicationTestImpl( const CTestParams& params, int seed )
+{
+	if( !isInt8Supported() ) {
+		return;
+	}
+
+	CRandom random( seed );
+	const CInterval heightInterval = params.GetInterval( "Height" );
+	const CInterval widthInterval = params.GetInterval( "Width" );
+
+	const int firstHeight = random.UniformInt( heightInterval.Begin, heightInterval.End );
+	const int secondHeight = random.UniformInt( heightInterval.Begin, heightInterval.End );
+	const int width = random.UniformInt( widthInterval.Begin, widthInterval.End );
+	const float firstScale = random.Next() % 2 == 1 ? 0.f : 2.f / 127;
+
+	CREATE_FILL_FLOAT_ARRAY( firstData, -2.f, 2.f, firstHeight * width, random );
+	CREATE_FILL_FLOAT_ARRAY( secondData, -1.f, 1.f, secondHeight * width, random );
+
+	CFloatBlob firstBlob( MathEngine(), 1, firstHeight, 1, 1, 1, 1, width );
+	firstBlob.CopyFrom( firstData.data() );
+	CFloatBlob secondBlob( MathEngine(), 1, secondHeight, 1, 1, 1, 1, width );
+	secondBlob.CopyFrom( secondData.data() );
+
+	CInt8HandleVar secondInt8( MathEngine(), secondHeight * width );
+	CFloatBlob secondScalesBlob( MathEngine(), 1, 1, 1, secondHeight );
+	MathEngine().QuantizeMatrixRowsInt8( secondBlob.GetData(), secondHeight, width,
+		secondInt8.GetHandle(), secondScalesBlob.GetData() );
+
+	std::vector<signed char> secondInt8Data( secondHeight * width );
+	MathEngine().DataExchangeTyped<signed char>( secondInt8Data.data(), secondInt8.GetHandle(), secondInt8Data.size() );
+	std::vector<float> secondScales( secondHeight );
+	secondScalesBlob.CopyTo( secondScales.data() );
+
+	std::vector<int> quantized;
+	for( int i = 0; i < secondHeight; ++i ) {
+		const float* row = secondData.data() + i * width;
+		ASSERT_TRUE( FloatEq( rowScaleNaive( row, width ), secondScales[i] ) );
+		quantizeRowNaive( row, width, secondScales[i], quantized );
+		for( int j = 0; j < width; ++j ) {
+			ASSERT_EQ( quantized[j], static_cast<int>( secondInt8Data[i * width + j] ) );
+		}
+	}
+
+	CFloatBlob resultBlob( MathEngine(), 1, firstHeight, 1, 1, 1, 1, secondHeight );
+	MathEngine().MultiplyMatrixByTransposedInt8Matrix( firstBlob.GetData(), firstHeight, width, firstScale,
+		secondInt8.GetHandle(), secondScalesBlob.GetData(), secondHeight, resultBlob.GetData() );
+	std::vector<float> actualData( firstHeight * secondHeight );
+	resultBlob.CopyTo( actualData.data() );
+
+	for( int i = 0; i < firstHeight; ++i ) {
+		const float* row = firstData.data() + i * width;
+		const float rowScale = firstScale > 0 ? firstScale : rowScaleNaive( row, width );
+		quantizeRowNaive( row, width, rowScale, quantized );
+		for( int j = 0; j < secondHeight; ++j ) {
+			int dot = 0;
+			float floatDot = 0;
+			for( int k = 0; k < width; ++k ) {
+				dot += quantized[k] * secondInt8Data[j * width + k];
+				floatDot += row[k] * secondData[j * width + k];
+			}
+			const float actual = actualData[i * secondHeight + j];
+			ASSERT_TRUE( FloatEq( dot * rowScale * secondScales[j], actual, 1e-4f ) );
+			// The quantization error is limited by the half of the quantization steps
+			const float maxError = 0.5f * width * ( rowScale * 1.f + secondScales[j] * 2.f ) + 1e-4f;
+			ASSERT_LE( ::fabsf( floatDot - actual ), maxError );
+		}
+	}
+}
+
+static void int8ConvolutionTestImpl( const CTestParams& params, int seed )
+{
+	if( !isInt8Supported() ) {
+		return;
+	}
+
+	CRandom random( seed );
+	const CInterval batchInterval = params.GetInterval( "Batch" );
+	const CInterval sizeInterval = params.GetInterval( "Size" );
+	const CInterval channelsInterval = params.GetInterval( "Channels" );
+	const CInterval filterSizeInterval = params.GetInterval( "FilterSize" );
+	const CInterval paddingInterval = params.GetInterval( "Padding" );
+	const CInterval strideInterval = params.GetInterval( "Stride" );
+
+	const int batch = random.UniformInt( batchInterval.Begin, batchInterval.End );
+	const int height = random.UniformInt( sizeInterval.Begin, sizeInterval.End );
+	const int width = random.UniformInt( sizeInterval.Begin, sizeInterval.End );
+	const int channels = random.UniformInt( channelsInterval.Begin, channelsInterval.End );
+	const int filterCount = random.UniformInt( channelsInterval.Begin, channelsInterval.End );
+	const int filterHeight = random.UniformInt( filterSizeInterval.Begin, std::min( height, filterSizeInterval.End ) );
+	const int filterWidth = random.UniformInt( filterSizeInterval.Begin, std::min( width, filterSizeInterval.End ) );
+	// The padding must be less than the filter size
+	const int padding = random.UniformInt( paddingInterval.Begin,
+		std::min( paddingInterval.End, std::min( filterHeight, filterWidth ) - 1 ) );
+	const int stride = random.UniformInt( strideInterval.Begin, strideInterval.End );
+	const int outputHeight = 1 + ( height - filterHeight + 2 * padding ) / stride;
+	const int outputWidth = 1 + ( width - filterWidth + 2 * padding ) / stride;
+	const float sourceScale = 1.f / 127;
+
+	const int filterSize = filterHeight * filterWidth * channels;
+	CREATE_FILL_FLOAT_ARRAY( inputData, -1.f, 1.f, batch * height * width * channels, random );
+	CREATE_FILL_FLOAT_ARRAY( filterData, -1.f, 1.f, filterCount * filterSize, random );
+	CREATE_FILL_FLOAT_ARRAY( freeTermData, -1.f, 1.f, filterCount, random );
+
+	CFloatBlob inputBlob( MathEngine(), 1, batch, 1, height, width, 1, channels );
+	inputBlob.CopyFrom( inputData.data() );
+	CFloatBlob filterBlob( MathEngine(), filterCount, filterHeight, filterWidth, 1, channels );
+	filterBlob.CopyFrom( filterData.data() );
+	CFloatBlob freeTermBlob( MathEngine(), 1, 1, 1, filterCount );
+	freeTermBlob.CopyFrom( freeTermData.data() );
+	CFloatBlob outputBlob( MathEngine(), 1, batch, 1, outputHeight, outputWidth, 1, filterCount );
+	CFloatHandle freeTerm = freeTermBlob.GetData();
+
+	CInt8HandleVar filterInt8( MathEngine(), filterCount * filterSize );
+	CFloatBlob filterScalesBlob( MathEngine(), 1, 1, 1, filterCount );
+	MathEngine().QuantizeMatrixRowsInt8( filterBlob.GetData(), filterCount, filterSize,
+		filterInt8.GetHandle(), filterScalesBlob.GetData() );
+
+	CConvolutionDesc* convDesc = MathEngine().InitBlobConvolution( inputBlob.GetDesc(), padding, padding,
+		stride, stride, 1, 1, filterBlob.GetDesc(), outputBlob.GetDesc() );
+	MathEngine().BlobConvolutionInt8( *convDesc, inputBlob.GetData(), sourceScale, filterInt8.GetHandle(),
+		filterScalesBlob.GetData(), &freeTerm, outputBlob.GetData() );
+	std::vector<float> actualData( outputBlob.GetDataSize() );
+	outputBlob.CopyTo( actualData.data() );
+
+	// The reference is the float convolution of the quantized and dequantized data
+	std::vector<signed char> filterInt8Data( filterCount * filterSize );
+	MathEngine().DataExchangeTyped<signed char>( filterInt8Data.data(), filterInt8.GetHandle(), filterInt8Data.size() );
+	std::vector<float> filterScales( filterCount );
+	filterScalesBlob.CopyTo( filterScales.data() );
+	for( int i = 0; i < filterCount * filterSize; ++i ) {
+		filterData[i] = filterInt8Data[i] * filterScales[i / filterSize];
+	}
+	filterBlob.CopyFrom( filterData.data() );
+	std::vector<int> quantized;
+	quantizeRowNaive( inputData.data(), static_cast<int>( inputData.size() ), sourceScale, quantized );
+	for( size_t i = 0; i < inputData.size(); ++i ) {
+		inputData[i] = quantized[i] * sourceScale;
+	}
+	inputBlob.CopyFrom( inputData.data() );
+
+	CFloatBlob expectedBlob( MathEngine(), 1, batch, 1, outputHeight, outputWidth, 1, filterCount );
+	MathEngine().BlobConvolution( *convDesc, inputBlob.GetData(), filterBlob.GetData(), &freeTerm,
+		expectedBlob.GetData() );
+	delete convDesc;
+	std::vector<float> expectedData( expectedBlob.GetDataSize() );
+	expectedBlob.CopyTo( expectedData.data() );
+
+	for( size_t i = 0; i < expectedData.size(); ++i ) {
+		ASSERT_TRUE( FloatEq( expectedData[i], actualData[i], 1e-3f ) );
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------
+
+class CInt8MatrixMultiplicationTest : public CTestFixtureWithParams {
+};
+
+INSTANTIATE_TEST_CASE_P( CInt8MatrixMultiplicationTestInstantiation, CInt8MatrixMultiplicationTest,
+	::testing::Values(
+		CTestParams(
+			"Height = (1..50);"
+			"Width = (1..300);"
+			"TestCount = 100;"
+		)
+	)
+);
+
+TEST_P( CInt8MatrixMultiplicationTest, Random )
+{
+	RUN_TEST_IMPL( int8MatrixMultiplicationTestImpl );
+}
+
+class CInt8ConvolutionTest : public CTestFixtureWithParams {
+};
+
+INSTANTIATE_TEST_CASE_P( CInt8ConvolutionTestInstantiation, CInt8ConvolutionTest,
+	::testing::Values(
+		CTestParams(
+			"Batch = (1..3);"
+			"Size = (1..20);"
+			"Channels = (1..16);"
+			"FilterSize = (1..5);"
+			"Padding = (0..2);"
+			"Stride = (1..2);"
+			"TestCount = 50;"
+		)
+	)
+);
+
+TEST_P( CInt8ConvolutionTest, Random )
+{
+	RUN_TEST_IMPL( int8ConvolutionTestImpl );
+}
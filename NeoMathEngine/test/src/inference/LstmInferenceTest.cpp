@@ -0,0 +1,136 @@
+/* Copyright © 2017-2021 ABBYY Production LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+--------------------------------------------------------------------------------------------------------------*/
+#include <TestFixture.h>
+
+using namespace NeoML;
+using namespace NeoMLTest;
+
+static inline float sigmoid( float x )
+{
+	return 1.f / ( 1.f + ::expf( -x ) );
+}
+
+static void lstmRecurrentNaive( bool reverse, int seqLength, int batchSize, int hiddenSize,
+	const float* inputGates, const float* recurWeights, const float* initialHidden, const float* initialState,
+	float* hidden, float* state )
+{
+	const int stepSize = batchSize * hiddenSize;
+	std::vector<float> gates( 4 * hiddenSize );
+	for( int step = 0; step < seqLength; ++step ) {
+		const int pos = reverse ? seqLength - 1 - step : step;
+		const int prevPos = reverse ? pos + 1 : pos - 1;
+		for( int b = 0; b < batchSize; ++b ) {
+			const float* hPrev = step == 0 ? initialHidden + b * hiddenSize : hidden + prevPos * stepSize + b * hiddenSize;
+			const float* cPrev = step == 0 ? initialState + b * hiddenSize : state + prevPos * stepSize + b * hiddenSize;
+			for( int g = 0; g < 4 * hiddenSize; ++g ) {
+				gates[g] = inputGates[( pos * batchSize + b ) * 4 * hiddenSize + g];
+				for( int i = 0; i < hiddenSize; ++i ) {
+					gates[g] += hPrev[i] * recurWeights[g * hiddenSize + i];
+				}
+			}
+			float* h = hidden + pos * stepSize + b * hiddenSize;
+			float* c = state + pos * stepSize + b * hiddenSize;
+			for( int i = 0; i < hiddenSize; ++i ) {
+				c[i] = sigmoid( gates[hiddenSize + i] ) * cPrev[i] + sigmoid( gates[2 * hiddenSize + i] ) * ::tanhf( gates[i] );
+				h[i] = sigmoid( gates[3 * hiddenSize + i] ) * ::tanhf( c[i] );
+			}
+		}
+	}
+}
+
+static void lstmInferenceTestImpl( const CTestParams& params, int seed )
+{
+	CRandom random( seed );
+	const CInterval batchLengthInterval = params.GetInterval( "BatchLength" );
+	const CInterval batchWidthInterval = params.GetInterval( "BatchWidth" );
+	const CInterval hiddenSizeInterval = params.GetInterval( "HiddenSize" );
+
+	const int batchLength = random.UniformInt( batchLengthInterval.Begin, batchLengthInterval.End );
+	const int batchWidth = random.UniformInt( batchWidthInterval.Begin, batchWidthInterval.End );
+	const int hiddenSize = random.UniformInt( hiddenSizeInterval.Begin, hiddenSizeInterval.End );
+	const bool reverse = random.Next() % 2 == 1;
+	const bool hasInitialState = random.Next() % 2 == 1;
+
+	const int stepSize = batchWidth * hiddenSize;
+	const int dataSize = batchLength * stepSize;
+
+	CREATE_FILL_FLOAT_ARRAY( inputGatesData, -2.f, 2.f, 4 * dataSize, random );
+	CFloatBlob inputGatesBlob( MathEngine(), batchLength, batchWidth, 1, 1, 1, 1, 4 * hiddenSize );
+	inputGatesBlob.CopyFrom( inputGatesData.data() );
+
+	CREATE_FILL_FLOAT_ARRAY( weightsData, -0.5f, 0.5f, 4 * hiddenSize * hiddenSize, random );
+	CFloatBlob weightsBlob( MathEngine(), 1, 4 * hiddenSize, 1, 1, 1, 1, hiddenSize );
+	weightsBlob.CopyFrom( weightsData.data() );
+
+	std::vector<float> initialHiddenData( stepSize, 0.f );
+	std::vector<float> initialStateData( stepSize, 0.f );
+	CFloatBlob initialHiddenBlob( MathEngine(), 1, batchWidth, 1, 1, 1, 1, hiddenSize );
+	CFloatBlob initialStateBlob( MathEngine(), 1, batchWidth, 1, 1, 1, 1, hiddenSize );
+	if( hasInitialState ) {
+		for( int i = 0; i < stepSize; ++i ) {
+			initialHiddenData[i] = static_cast<float>( random.Uniform( -1., 1. ) );
+			initialStateData[i] = static_cast<float>( random.Uniform( -1., 1. ) );
+		}
+		initialHiddenBlob.CopyFrom( initialHiddenData.data() );
+		initialStateBlob.CopyFrom( initialStateData.data() );
+	}
+
+	std::vector<float> expectedHidden( dataSize );
+	std::vector<float> expectedState( dataSize );
+	lstmRecurrentNaive( reverse, batchLength, batchWidth, hiddenSize, inputGatesData.data(), weightsData.data(),
+		initialHiddenData.data(), initialStateData.data(), expectedHidden.data(), expectedState.data() );
+
+	CFloatBlob hiddenBlob( MathEngine(), batchLength, batchWidth, 1, 1, 1, 1, hiddenSize );
+	CFloatBlob stateBlob( MathEngine(), batchLength, batchWidth, 1, 1, 1, 1, hiddenSize );
+	MathEngine().LstmRecurrent( reverse, batchLength, batchWidth, hiddenSize,
+		inputGatesBlob.GetData(), weightsBlob.GetData(),
+		hasInitialState ? initialHiddenBlob.GetData() : CFloatHandle(),
+		hasInitialState ? initialStateBlob.GetData() : CFloatHandle(),
+		hiddenBlob.GetData(), stateBlob.GetData() );
+	std::vector<float> actualHidden( dataSize );
+	std::vector<float> actualState( dataSize );
+	hiddenBlob.CopyTo( actualHidden.data() );
+	stateBlob.CopyTo( actualState.data() );
+
+	for( int i = 0; i < dataSize; ++i ) {
+		EXPECT_TRUE( FloatEq( expectedHidden[i], actualHidden[i], 1e-4f ) );
+		EXPECT_TRUE( FloatEq( expectedState[i], actualState[i], 1e-4f ) );
+	}
+}
+
+class CLstmInferenceTest : public CTestFixtureWithParams {
+};
+
+INSTANTIATE_TEST_CASE_P( CLstmInferenceTest, CLstmInferenceTest,
+	::testing::Values(
+		CTestParams(
+			"BatchLength = (1..20);"
+			"BatchWidth = (1..10);"
+			"HiddenSize = (1..10);"
+			"TestCount = 300;"
+		),
+		CTestParams(
+			"BatchLength = (1..10);"
+			"BatchWidth = (20..60);"
+			"HiddenSize = (30..70);"
+			"TestCount = 10;"
+		)
+	)
+);
+
+TEST_P( CLstmInferenceTest, Random )
+{
+	RUN_TEST_IMPL( lstmInferenceTestImpl );
+}
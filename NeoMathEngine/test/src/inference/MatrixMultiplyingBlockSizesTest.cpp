@@ -0,0 +1,104 @@
+/* Copyright © 2017-2020 ABBYY Production LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+--------------------------------------------------------------------------------------------------------------*/
+
+#include <TestFixture.h>
+
+#include <chrono>
+#include <iomanip>
+
+using namespace NeoML;
+using namespace NeoMLTest;
+using namespace std::chrono;
+
+TEST( CMatrixMultiplyingBlockSizesTest, SetCacheSizes )
+{
+	if( MathEngine().GetType() != MET_Cpu ) {
+		return;
+	}
+
+	CCpuCacheSizes defaultSizes;
+	MathEngine().GetCpuCacheSizes( defaultSizes );
+	EXPECT_NE( 0u, defaultSizes.L1 );
+	EXPECT_NE( 0u, defaultSizes.L2 );
+
+	CCpuCacheSizes sizes;
+	MathEngine().SetCpuCacheSizes( CCpuCacheSizes( 0x4000, 0, 0x100000 ) );
+	MathEngine().GetCpuCacheSizes( sizes );
+	EXPECT_EQ( 0x4000u, sizes.L1 );
+	EXPECT_EQ( defaultSizes.L2, sizes.L2 );
+	EXPECT_EQ( 0x100000u, sizes.L3 );
+
+	// The zero sizes restore the default ones
+	MathEngine().SetCpuCacheSizes( CCpuCacheSizes() );
+	MathEngine().GetCpuCacheSizes( sizes );
+	EXPECT_EQ( defaultSizes.L1, sizes.L1 );
+	EXPECT_EQ( defaultSizes.L2, sizes.L2 );
+	EXPECT_EQ( defaultSizes.L3, sizes.L3 );
+}
+
+// Measures the matrix multiplication with the block sizes calculated for the different cache sizes
+// The results are printed to choose the cache sizes for a processor model
+TEST( CMatrixMultiplyingBlockSizesTest, Sweep )
+{
+	if( MathEngine().GetType() != MET_Cpu ) {
+		return;
+	}
+
+	CCpuCacheSizes defaultSizes;
+	MathEngine().GetCpuCacheSizes( defaultSizes );
+	GTEST_LOG_( INFO ) << "Default cache sizes: L1 " << defaultSizes.L1 << ", L2 " << defaultSizes.L2
+		<< ", L3 " << defaultSizes.L3;
+
+	const int sizes[][3] = { { 256, 256, 256 }, { 64, 1024, 512 }, { 1024, 64, 512 } };
+	const size_t l1Sizes[] = { 0x4000, 0x8000, 0xC000, 0x10000 };
+	const size_t l2Sizes[] = { 0x40000, 0x80000, 0x100000, 0x200000 };
+	CRandom random( 0xB10C );
+	for( const auto& size : sizes ) {
+		const int m = size[0];
+		const int n = size[1];
+		const int k = size[2];
+		CREATE_FILL_FLOAT_ARRAY( a, -1.f, 1.f, m * k, random )
+		CREATE_FILL_FLOAT_ARRAY( b, -1.f, 1.f, k * n, random )
+		CFloatBlob aBlob( MathEngine(), 1, m, k, 1 );
+		aBlob.CopyFrom( a.data() );
+		CFloatBlob bBlob( MathEngine(), 1, k, n, 1 );
+		bBlob.CopyFrom( b.data() );
+		CFloatBlob cBlob( MathEngine(), 1, m, n, 1 );
+
+		MathEngine().SetCpuCacheSizes( CCpuCacheSizes() );
+		MathEngine().MultiplyMatrixByMatrix( 1, aBlob.GetData(), m, k, bBlob.GetData(), n, cBlob.GetData(), m * n );
+		std::vector<float> expected( m * n );
+		cBlob.CopyTo( expected.data() );
+
+		for( size_t l1 : l1Sizes ) {
+			for( size_t l2 : l2Sizes ) {
+				MathEngine().SetCpuCacheSizes( CCpuCacheSizes( l1, l2, 0 ) );
+				auto startTime = high_resolution_clock::now();
+				MathEngine().MultiplyMatrixByMatrix( 1, aBlob.GetData(), m, k, bBlob.GetData(), n, cBlob.GetData(), m * n );
+				auto stopTime = high_resolution_clock::now();
+				const double seconds = duration_cast<duration<double>>( stopTime - startTime ).count();
+				GTEST_LOG_( INFO ) << m << " * " << k << " * " << n << ", L1 " << l1 << ", L2 " << l2 << ": "
+					<< std::setprecision( 3 ) << 2. * m * n * k / seconds / 1e9 << " GFLOPS";
+
+				std::vector<float> actual( m * n );
+				cBlob.CopyTo( actual.data() );
+				for( int i = 0; i < m * n; ++i ) {
+					ASSERT_TRUE( FloatEq( expected[i], actual[i], 1e-4f ) );
+				}
+			}
+		}
+	}
+	MathEngine().SetCpuCacheSizes( CCpuCacheSizes() );
+}
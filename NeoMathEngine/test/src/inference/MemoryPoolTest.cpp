@@ -0,0 +1,152 @@
+/* Copyright © 2017-2021 ABBYY Production LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+--------------------------------------------------------------------------------------------------------------*/
+
+#include <TestFixture.h>
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace NeoML;
+using namespace NeoMLTest;
+
+// Allocates and frees the blocks of different sizes in the memory reuse mode
+static void allocFreeBlocks( IMathEngine& mathEngine, int runCount )
+{
+	mathEngine.SetReuseMemoryMode( true );
+	std::vector<CMemoryHandle> handles;
+	for( int run = 0; run < runCount; ++run ) {
+		for( size_t size = 64; size <= 1024 * 1024; size *= 4 ) {
+			handles.push_back( mathEngine.HeapAlloc( size ) );
+		}
+		for( const CMemoryHandle& handle : handles ) {
+			mathEngine.HeapFree( handle );
+		}
+		handles.clear();
+	}
+}
+
+TEST( CMemoryPoolTest, PerThreadPools )
+{
+	const int threadCount = 4;
+	const int runCount = 100;
+	std::unique_ptr<IMathEngine> mathEngine( CreateCpuMathEngine( 1, 0 ) );
+	const size_t freeMemorySize = mathEngine->GetFreeMemorySize();
+
+	std::vector<std::thread> threads;
+	for( int i = 0; i < threadCount; ++i ) {
+		threads.emplace_back( allocFreeBlocks, std::ref( *mathEngine ), runCount );
+	}
+	for( std::thread& thread : threads ) {
+		thread.join();
+	}
+
+	CMemoryPoolStatistics statistics;
+	mathEngine->GetMemoryPoolStatistics( statistics );
+	const size_t blocksPerRun = 8;
+	EXPECT_EQ( static_cast<size_t>( threadCount ), statistics.ThreadCount );
+	// Only the first run of each thread requests memory from the device
+	EXPECT_EQ( threadCount * blocksPerRun, statistics.DeviceAllocations );
+	EXPECT_EQ( threadCount * blocksPerRun * ( runCount - 1 ), statistics.PoolAllocations );
+	EXPECT_EQ( threadCount * blocksPerRun * runCount, statistics.LocalFrees );
+	EXPECT_EQ( 0u, statistics.CrossThreadFrees );
+	EXPECT_EQ( freeMemorySize, mathEngine->GetFreeMemorySize() );
+}
+
+TEST( CMemoryPoolTest, CrossThreadFree )
+{
+	const int blockCount = 16;
+	std::unique_ptr<IMathEngine> mathEngine( CreateCpuMathEngine( 1, 0 ) );
+	const size_t freeMemorySize = mathEngine->GetFreeMemorySize();
+
+	std::vector<CMemoryHandle> handles;
+	std::thread thread( [&]() {
+		for( int i = 0; i < blockCount; ++i ) {
+			handles.push_back( mathEngine->HeapAlloc( ( i + 1 ) * 1000 ) );
+		}
+	} );
+	thread.join();
+	EXPECT_GT( freeMemorySize, mathEngine->GetFreeMemorySize() );
+
+	for( const CMemoryHandle& handle : handles ) {
+		mathEngine->HeapFree( handle );
+	}
+
+	CMemoryPoolStatistics statistics;
+	mathEngine->GetMemoryPoolStatistics( statistics );
+	EXPECT_EQ( static_cast<size_t>( blockCount ), statistics.CrossThreadFrees );
+	EXPECT_EQ( 0u, statistics.LocalFrees );
+	EXPECT_EQ( freeMemorySize, mathEngine->GetFreeMemorySize() );
+}
+
+// After the first access of each thread the allocations and frees on the same thread take no contended locks
+TEST( CMemoryPoolTest, NoLockContentionInSteadyState )
+{
+	const int threadCount = 4;
+	const int runCount = 100;
+	std::unique_ptr<IMathEngine> mathEngine( CreateCpuMathEngine( 1, 0 ) );
+
+	std::mutex mutex;
+	std::condition_variable condition;
+	int warmedUpCount = 0;
+	bool isSteadyState = false;
+
+	std::vector<std::thread> threads;
+	for( int i = 0; i < threadCount; ++i ) {
+		threads.emplace_back( [&]() {
+			// The first access registers the thread
+			// The stack keeps its block taken from the pool, so the second run allocates the block for the heap again
+			CMemoryHandle stackBlock;
+			for( int run = 0; run < 2; ++run ) {
+				allocFreeBlocks( *mathEngine, 1 );
+				stackBlock = mathEngine->StackAlloc( 1024 );
+				mathEngine->StackFree( stackBlock );
+			}
+			{
+				std::unique_lock<std::mutex> lock( mutex );
+				warmedUpCount++;
+				condition.notify_all();
+				condition.wait( lock, [&]() { return isSteadyState; } );
+			}
+
+			for( int run = 0; run < runCount; ++run ) {
+				allocFreeBlocks( *mathEngine, 1 );
+				stackBlock = mathEngine->StackAlloc( 1024 );
+				mathEngine->StackFree( stackBlock );
+			}
+		} );
+	}
+
+	CMemoryPoolStatistics before;
+	{
+		std::unique_lock<std::mutex> lock( mutex );
+		condition.wait( lock, [&]() { return warmedUpCount == threadCount; } );
+		mathEngine->GetMemoryPoolStatistics( before );
+		isSteadyState = true;
+		condition.notify_all();
+	}
+	for( std::thread& thread : threads ) {
+		thread.join();
+	}
+
+	CMemoryPoolStatistics after;
+	mathEngine->GetMemoryPoolStatistics( after );
+	EXPECT_EQ( static_cast<size_t>( threadCount ), after.ThreadCount );
+	EXPECT_EQ( before.DeviceAllocations, after.DeviceAllocations );
+	EXPECT_EQ( 0u, after.CrossThreadFrees );
+	EXPECT_EQ( before.LockContentions, after.LockContentions );
+}
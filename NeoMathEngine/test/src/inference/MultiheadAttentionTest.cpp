@@ -0,0 +1,129 @@
+/* Copyright © 2017-2021 ABBYY Production LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+--------------------------------------------------------------------------------------------------------------*/
+#include <TestFixture.h>
+
+using namespace NeoML;
+using namespace NeoMLTest;
+
+static void multiheadAttentionNaive( int batchSize, int headCount, int headSize, int seqQ, int seqK, float multiplier,
+	const float* q, const float* k, const float* v, const float* mask, float* result )
+{
+	const int rowSize = headCount * headSize;
+	std::vector<float> attention( seqK );
+	for( int b = 0; b < batchSize; ++b ) {
+		for( int h = 0; h < headCount; ++h ) {
+			for( int i = 0; i < seqQ; ++i ) {
+				const float* qRow = q + ( b * seqQ + i ) * rowSize + h * headSize;
+				float maxValue = -FLT_MAX;
+				for( int j = 0; j < seqK; ++j ) {
+					const float* kRow = k + ( b * seqK + j ) * rowSize + h * headSize;
+					float dot = 0;
+					for( int c = 0; c < headSize; ++c ) {
+						dot += qRow[c] * kRow[c];
+					}
+					attention[j] = dot * multiplier + ( mask == nullptr ? 0.f : mask[i * seqK + j] );
+					maxValue = std::max( maxValue, attention[j] );
+				}
+				float sum = 0;
+				for( int j = 0; j < seqK; ++j ) {
+					attention[j] = ::expf( attention[j] - maxValue );
+					sum += attention[j];
+				}
+				float* resultRow = result + ( b * seqQ + i ) * rowSize + h * headSize;
+				for( int c = 0; c < headSize; ++c ) {
+					float value = 0;
+					for( int j = 0; j < seqK; ++j ) {
+						value += attention[j] * v[( b * seqK + j ) * rowSize + h * headSize + c];
+					}
+					resultRow[c] = value / sum;
+				}
+			}
+		}
+	}
+}
+
+static void multiheadAttentionTestImpl( const CTestParams& params, int seed )
+{
+	CRandom random( seed );
+	const CInterval batchSizeInterval = params.GetInterval( "BatchSize" );
+	const CInterval headCountInterval = params.GetInterval( "HeadCount" );
+	const CInterval headSizeInterval = params.GetInterval( "HeadSize" );
+	const CInterval seqLengthInterval = params.GetInterval( "SeqLength" );
+
+	const int batchSize = random.UniformInt( batchSizeInterval.Begin, batchSizeInterval.End );
+	const int headCount = random.UniformInt( headCountInterval.Begin, headCountInterval.End );
+	const int headSize = random.UniformInt( headSizeInterval.Begin, headSizeInterval.End );
+	const int seqQ = random.UniformInt( seqLengthInterval.Begin, seqLengthInterval.End );
+	const int seqK = random.UniformInt( seqLengthInterval.Begin, seqLengthInterval.End );
+	const bool useMask = random.Next() % 2 == 1;
+	const float multiplier = static_cast<float>( 1.0 / sqrt( 1.0 * headCount * headSize ) );
+
+	const int rowSize = headCount * headSize;
+	CREATE_FILL_FLOAT_ARRAY( qData, -2.f, 2.f, batchSize * seqQ * rowSize, random );
+	CREATE_FILL_FLOAT_ARRAY( kData, -2.f, 2.f, batchSize * seqK * rowSize, random );
+	CREATE_FILL_FLOAT_ARRAY( vData, -2.f, 2.f, batchSize * seqK * rowSize, random );
+	CREATE_FILL_FLOAT_ARRAY( maskData, -5.f, 0.f, seqQ * seqK, random );
+
+	CFloatBlob qBlob( MathEngine(), 1, batchSize, seqQ, 1, 1, 1, rowSize );
+	qBlob.CopyFrom( qData.data() );
+	CFloatBlob kBlob( MathEngine(), 1, batchSize, seqK, 1, 1, 1, rowSize );
+	kBlob.CopyFrom( kData.data() );
+	CFloatBlob vBlob( MathEngine(), 1, batchSize, seqK, 1, 1, 1, rowSize );
+	vBlob.CopyFrom( vData.data() );
+	CFloatBlob maskBlob( MathEngine(), 1, 1, 1, 1, 1, 1, seqQ * seqK );
+	maskBlob.CopyFrom( maskData.data() );
+
+	std::vector<float> expectedData( batchSize * seqQ * rowSize );
+	multiheadAttentionNaive( batchSize, headCount, headSize, seqQ, seqK, multiplier, qData.data(), kData.data(),
+		vData.data(), useMask ? maskData.data() : nullptr, expectedData.data() );
+
+	CFloatBlob actualBlob( MathEngine(), 1, batchSize, seqQ, 1, 1, 1, rowSize );
+	MathEngine().MultiheadAttention( batchSize, headCount, headSize, seqQ, seqK, multiplier,
+		qBlob.GetData(), kBlob.GetData(), vBlob.GetData(), useMask ? maskBlob.GetData() : CFloatHandle(),
+		actualBlob.GetData() );
+	std::vector<float> actualData( expectedData.size() );
+	actualBlob.CopyTo( actualData.data() );
+
+	for( size_t i = 0; i < expectedData.size(); ++i ) {
+		EXPECT_TRUE( FloatEq( expectedData[i], actualData[i], 1e-4f ) );
+	}
+}
+
+class CMultiheadAttentionTest : public CTestFixtureWithParams {
+};
+
+INSTANTIATE_TEST_CASE_P( CMultiheadAttentionTest, CMultiheadAttentionTest,
+	::testing::Values(
+		CTestParams(
+			"BatchSize = (1..5);"
+			"HeadCount = (1..4);"
+			"HeadSize = (1..16);"
+			"SeqLength = (1..20);"
+			"TestCount = 200;"
+		),
+		CTestParams(
+			"BatchSize = (1..2);"
+			"HeadCount = (1..8);"
+			"HeadSize = (16..64);"
+			"SeqLength = (100..600);"
+			"TestCount = 5;"
+		)
+	)
+);
+
+TEST_P( CMultiheadAttentionTest, Random )
+{
+	RUN_TEST_IMPL( multiheadAttentionTestImpl );
+}
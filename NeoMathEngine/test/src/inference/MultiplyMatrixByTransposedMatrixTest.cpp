@@ -15,6 +15,8 @@ limitations under the License.
 
 #include <TestFixture.h>
 
+#include <memory>
+
 using namespace NeoML;
 using namespace NeoMLTest;
 
@@ -150,3 +152,61 @@ TEST_P( CBatchMultiplyMatrixByTransposedMatrixTest, Random )
 {
 	RUN_TEST_IMPL( batchMultiplyMatrixByTransposedMatrixTestImpl );
 }
+
+//---------------------------------------------------------------------------------------------------------------------
+
+// Calculates the products in all transposition variants
+static void multiplyMatricesAllVariants( IMathEngine& mathEngine, std::vector<float>& a, std::vector<float>& b,
+	int m, int n, int k, std::vector<float>& ab, std::vector<float>& abT, std::vector<float>& aTb )
+{
+	ab.assign( m * n, 0.f );
+	abT.assign( m * n, 0.f );
+	aTb.assign( m * n, 0.f );
+	// a is m * k matrix, b is k * n matrix; the same data are used as T(a) and T(b)
+	mathEngine.MultiplyMatrixByMatrix( 1, CFloatWrapper( mathEngine, a.data(), m * k ), m, k,
+		CFloatWrapper( mathEngine, b.data(), k * n ), n, CFloatWrapper( mathEngine, ab.data(), m * n ), m * n );
+	mathEngine.MultiplyMatrixByTransposedMatrix( CFloatWrapper( mathEngine, a.data(), m * k ), m, k, k,
+		CFloatWrapper( mathEngine, b.data(), k * n ), n, k, CFloatWrapper( mathEngine, abT.data(), m * n ), n, m * n );
+	mathEngine.MultiplyTransposedMatrixByMatrix( 1, CFloatWrapper( mathEngine, a.data(), m * k ), k, m,
+		CFloatWrapper( mathEngine, b.data(), k * n ), n, CFloatWrapper( mathEngine, aTb.data(), m * n ), m * n );
+}
+
+// The result of the multithreaded matrix product is the same as of the single-threaded one
+TEST( CMultithreadedMatrixMultiplyingTest, SameAsSingleThreaded )
+{
+	if( MathEngine().GetType() != MET_Cpu ) {
+		return;
+	}
+
+	std::unique_ptr<IMathEngine> singleThreadEngine( CreateCpuMathEngine( 1, 0 ) );
+	// The sizes that are not divisible by the thread count or by the kernel size, and the vector cases
+	const int sizes[][3] = { { 1, 37, 300 }, { 123, 1, 70 }, { 5, 301, 64 }, { 257, 129, 700 }, { 3, 7, 11 } };
+	// The default cache sizes and the small ones that split the matrices into many blocks
+	const CCpuCacheSizes cacheSizes[] = { CCpuCacheSizes(), CCpuCacheSizes( 4096, 32768, 0 ) };
+	for( const CCpuCacheSizes& cacheSize : cacheSizes ) {
+		singleThreadEngine->SetCpuCacheSizes( cacheSize );
+		for( int threadCount : { 2, 3, 4, 7 } ) {
+			std::unique_ptr<IMathEngine> engine( CreateCpuMathEngine( threadCount, 0 ) );
+			engine->SetCpuCacheSizes( cacheSize );
+			CRandom random( 0x5DE + threadCount );
+			for( const auto& size : sizes ) {
+				const int m = size[0];
+				const int n = size[1];
+				const int k = size[2];
+				CREATE_FILL_FLOAT_ARRAY( a, -1.f, 1.f, m * k, random )
+				CREATE_FILL_FLOAT_ARRAY( b, -1.f, 1.f, k * n, random )
+
+				std::vector<float> expectedAB, expectedABT, expectedATB;
+				multiplyMatricesAllVariants( *singleThreadEngine, a, b, m, n, k, expectedAB, expectedABT, expectedATB );
+				std::vector<float> ab, abT, aTb;
+				multiplyMatricesAllVariants( *engine, a, b, m, n, k, ab, abT, aTb );
+
+				for( int i = 0; i < m * n; ++i ) {
+					ASSERT_EQ( expectedAB[i], ab[i] );
+					ASSERT_EQ( expectedABT[i], abT[i] );
+					ASSERT_EQ( expectedATB[i], aTb[i] );
+				}
+			}
+		}
+	}
+}
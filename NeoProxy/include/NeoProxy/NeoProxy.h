@@ -167,4 +167,35 @@ NEOPROXY_API const char* GetOutputName( const struct CDnnDesc* dnn, int index, s
 // If an error occurs its description will be written into the errorInfo parameter and the function will return 0
 NEOPROXY_API const struct CDnnBlobDesc* GetOutputBlob( const struct CDnnDesc* dnn, int index, struct CDnnErrorInfo* errorInfo );
 
+//------------------------------------------------------------------------------------------------------------
+// Dynamic batching functions
+
+// The batching executor descriptor
+// The executor accepts the requests from several threads, joins them into one batch along the BatchWidth dimension,
+// runs the network once for the whole batch and returns to each request its part of the outputs
+// All network outputs must have the same BatchWidth as the inputs
+struct NEOPROXY_API CDnnBatchExecutorDesc {
+	const CDnnDesc* Dnn; // the network
+	int MaxBatchSize; // the maximum total BatchWidth of the requests in one batch
+	int MaxDelay; // the maximum time in milliseconds the request waits for other requests to join its batch
+};
+
+// Creates the batching executor for the network
+// The network should not be used directly while the executor exists
+// The executor should be destroyed after use (and before the network) with the help of the DestroyDnnBatchExecutor function
+// If an error occurs its description will be written into the errorInfo parameter and the function will return 0
+NEOPROXY_API const struct CDnnBatchExecutorDesc* CreateDnnBatchExecutor( const struct CDnnDesc* dnn,
+	int maxBatchSize, int maxDelay, struct CDnnErrorInfo* errorInfo );
+
+// Destroys the batching executor; the requests already sent are processed before that
+NEOPROXY_API void DestroyDnnBatchExecutor( const struct CDnnBatchExecutorDesc* executor );
+
+// Runs the network for one request and waits for the result; may be called from several threads simultaneously
+// The inputs array contains InputCount blobs in the order of GetInputName; all of them should have the same BatchWidth
+// The outputs array of OutputCount elements is filled with the request outputs in the order of GetOutputName
+// The output blobs should be destroyed after use with the help of the DestroyDnnBlob function
+// If an error occurs its description will be written into the errorInfo parameter and the function will return false
+NEOPROXY_API bool DnnBatchRun( const struct CDnnBatchExecutorDesc* executor, const struct CDnnBlobDesc* const* inputs,
+	const struct CDnnBlobDesc** outputs, struct CDnnErrorInfo* errorInfo );
+
 } // extern "C"
@@ -23,6 +23,10 @@ limitations under the License.
 #include <NeoOnnx/NeoOnnx.h>
 
 #include <cstdio>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 using namespace NeoML;
 
@@ -734,4 +738,330 @@ const struct CDnnBlobDesc* GetOutputBlob( const struct CDnnDesc* dnnDesc, int in
 	return nullptr;
 }
 
+//------------------------------------------------------------------------------------------------------------
+// CDnnBatchExecutorDesc implementation
+
+class CDnnBatchExecutorImpl : public CDnnBatchExecutorDesc {
+public:
+	CDnnBatchExecutorImpl( const CDnnDescImpl* dnnDesc, int maxBatchSize, int maxDelay );
+	~CDnnBatchExecutorImpl();
+
+	// Sends the request to the batch and waits until it is processed
+	// The outputs are filled only if the request is successful
+	bool Run( const CObjectArray<CDnnBlob>& inputs, CObjectArray<CDnnBlob>& outputs, struct CDnnErrorInfo* errorInfo ) const;
+
+private:
+	// The request waiting in the queue
+	struct CRequest {
+		CObjectArray<CDnnBlob> Inputs;
+		CObjectArray<CDnnBlob> Outputs;
+		std::chrono::steady_clock::time_point ArrivalTime;
+		bool IsDone;
+		bool IsSucceeded;
+		CDnnErrorInfo ErrorInfo;
+
+		CRequest() : IsDone( false ), IsSucceeded( false ) { ErrorInfo.Type = DET_OK; ErrorInfo.Description[0] = 0; }
+		int BatchWidth() const { return Inputs[0]->GetBatchWidth(); }
+	};
+
+	CDnnDescImpl* const dnn;
+
+	mutable std::mutex mutex;
+	mutable std::condition_variable queueChanged; // a request is added or the executor is stopped
+	mutable std::condition_variable batchProcessed; // the requests of a batch are done
+	mutable CArray<CRequest*> queue;
+	bool isStopped;
+	std::thread worker;
+
+	void workerLoop();
+	int getBatchRequestCount() const;
+	static bool isCompatible( const CRequest& first, const CRequest& second );
+	void processBatch( const CArray<CRequest*>& batch );
+	bool runBatch( const CArray<CRequest*>& batch );
+};
+
+CDnnBatchExecutorImpl::CDnnBatchExecutorImpl( const CDnnDescImpl* dnnDesc, int maxBatchSize, int maxDelay ) :
+	dnn( const_cast<CDnnDescImpl*>( dnnDesc ) ),
+	isStopped( false )
+{
+	CDnnBatchExecutorDesc::Dnn = dnnDesc;
+	CDnnBatchExecutorDesc::MaxBatchSize = maxBatchSize;
+	CDnnBatchExecutorDesc::MaxDelay = maxDelay;
+	worker = std::thread( &CDnnBatchExecutorImpl::workerLoop, this );
+}
+
+CDnnBatchExecutorImpl::~CDnnBatchExecutorImpl()
+{
+	{
+		std::lock_guard<std::mutex> lock( mutex );
+		isStopped = true;
+	}
+	queueChanged.notify_one();
+	worker.join();
+}
+
+bool CDnnBatchExecutorImpl::Run( const CObjectArray<CDnnBlob>& inputs, CObjectArray<CDnnBlob>& outputs,
+	struct CDnnErrorInfo* errorInfo ) const
+{
+	CRequest request;
+	inputs.CopyTo( request.Inputs );
+	request.ArrivalTime = std::chrono::steady_clock::now();
+
+	std::unique_lock<std::mutex> lock( mutex );
+	queue.Add( &request );
+	queueChanged.notify_one();
+	batchProcessed.wait( lock, [&request] { return request.IsDone; } );
+
+	if( !request.IsSucceeded ) {
+		initErrorInfo( request.ErrorInfo.Type, request.ErrorInfo.Description, errorInfo );
+		return false;
+	}
+	request.Outputs.MoveTo( outputs );
+	return true;
+}
+
+// The requests may be processed together if their inputs differ only in BatchWidth
+bool CDnnBatchExecutorImpl::isCompatible( const CRequest& first, const CRequest& second )
+{
+	for( int i = 0; i < first.Inputs.Size(); ++i ) {
+		if( first.Inputs[i]->GetDataType() != second.Inputs[i]->GetDataType() ) {
+			return false;
+		}
+		CBlobDesc desc = second.Inputs[i]->GetDesc();
+		desc.SetDimSize( BD_BatchWidth, first.Inputs[i]->GetBatchWidth() );
+		if( !desc.HasEqualDimensions( first.Inputs[i]->GetDesc() ) ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Gets the number of requests from the start of the queue that fit into one batch (at least one)
+int CDnnBatchExecutorImpl::getBatchRequestCount() const
+{
+	int batchWidth = queue[0]->BatchWidth();
+	int count = 1;
+	while( count < queue.Size() && isCompatible( *queue[0], *queue[count] )
+		&& batchWidth + queue[count]->BatchWidth() <= MaxBatchSize )
+	{
+		batchWidth += queue[count]->BatchWidth();
+		++count;
+	}
+	return count;
+}
+
+void CDnnBatchExecutorImpl::workerLoop()
+{
+	CArray<CRequest*> batch;
+	std::unique_lock<std::mutex> lock( mutex );
+	while( true ) {
+		queueChanged.wait( lock, [this] { return isStopped || !queue.IsEmpty(); } );
+		if( queue.IsEmpty() ) {
+			return;
+		}
+
+		// Waits for the other requests until the batch is full or the first request has waited too long
+		const std::chrono::steady_clock::time_point deadline = queue[0]->ArrivalTime + std::chrono::milliseconds( MaxDelay );
+		queueChanged.wait_until( lock, deadline, [this] {
+			const int count = getBatchRequestCount();
+			int batchWidth = 0;
+			for( int i = 0; i < count; ++i ) {
+				batchWidth += queue[i]->BatchWidth();
+			}
+			return isStopped || batchWidth >= MaxBatchSize || count < queue.Size();
+		} );
+
+		const int count = getBatchRequestCount();
+		batch.SetSize( count );
+		for( int i = 0; i < count; ++i ) {
+			batch[i] = queue[i];
+		}
+		queue.DeleteAt( 0, count );
+
+		lock.unlock();
+		processBatch( batch );
+		lock.lock();
+
+		for( int i = 0; i < batch.Size(); ++i ) {
+			batch[i]->IsDone = true;
+		}
+		batchProcessed.notify_all();
+	}
+}
+
+void CDnnBatchExecutorImpl::processBatch( const CArray<CRequest*>& batch )
+{
+	try {
+		const bool isSucceeded = runBatch( batch );
+		for( int i = 0; i < batch.Size(); ++i ) {
+			batch[i]->IsSucceeded = isSucceeded;
+			if( !isSucceeded ) {
+				initErrorInfo( DET_RunDnnError, "The output batch width doesn't match the input batch width.", &batch[i]->ErrorInfo );
+			}
+		}
+		return;
+#ifdef NEOML_USE_FINEOBJ
+	} catch( CException* e ) {
+		for( int i = 0; i < batch.Size(); ++i ) {
+			initErrorInfo( DET_RunDnnError, e->MessageText().CreateString( CP_UTF8 ), &batch[i]->ErrorInfo );
+		}
+		delete e;
+	}
+#else
+	} catch( std::exception& e ) {
+		for( int i = 0; i < batch.Size(); ++i ) {
+			initErrorInfo( DET_RunDnnError, e.what(), &batch[i]->ErrorInfo );
+		}
+	}
+#endif
+}
+
+// Returns false if the outputs can't be split between the requests
+bool CDnnBatchExecutorImpl::runBatch( const CArray<CRequest*>& batch )
+{
+	IMathEngine& mathEngine = dnn->Dnn().GetMathEngine();
+
+	// Merges the inputs along BatchWidth
+	int batchWidth = 0;
+	for( int i = 0; i < batch.Size(); ++i ) {
+		batchWidth += batch[i]->BatchWidth();
+	}
+	for( int input = 0; input < dnn->InputCount; ++input ) {
+		if( batch.Size() == 1 ) {
+			dnn->SetInputBlob( input, batch[0]->Inputs[input] );
+			continue;
+		}
+		CObjectArray<CDnnBlob> parts;
+		for( int i = 0; i < batch.Size(); ++i ) {
+			parts.Add( batch[i]->Inputs[input] );
+		}
+		CBlobDesc desc = parts[0]->GetDesc();
+		desc.SetDimSize( BD_BatchWidth, batchWidth );
+		CPtr<CDnnBlob> merged = CDnnBlob::CreateBlob( mathEngine, parts[0]->GetDataType(), desc );
+		CDnnBlob::MergeByDim( mathEngine, BD_BatchWidth, parts, merged );
+		dnn->SetInputBlob( input, merged );
+	}
+
+	dnn->Dnn().RunOnce();
+
+	// Splits the outputs between the requests
+	// The sink blobs are copied because they are overwritten by the next run
+	// The batch widths are checked even for a single request so that the result doesn't depend on the batch size
+	for( int output = 0; output < dnn->OutputCount; ++output ) {
+		if( dnn->GetOutputBlob( output )->GetBatchWidth() != batchWidth ) {
+			return false;
+		}
+	}
+	for( int output = 0; output < dnn->OutputCount; ++output ) {
+		CPtr<CDnnBlob> blob = dnn->GetOutputBlob( output );
+		if( batch.Size() == 1 ) {
+			batch[0]->Outputs.Add( blob->GetCopy() );
+			continue;
+		}
+		CObjectArray<CDnnBlob> parts;
+		for( int i = 0; i < batch.Size(); ++i ) {
+			CBlobDesc desc = blob->GetDesc();
+			desc.SetDimSize( BD_BatchWidth, batch[i]->BatchWidth() );
+			parts.Add( CDnnBlob::CreateBlob( mathEngine, blob->GetDataType(), desc ) );
+			batch[i]->Outputs.Add( parts[i] );
+		}
+		CDnnBlob::SplitByDim( mathEngine, BD_BatchWidth, blob, parts );
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------
+// Dynamic batching functions
+
+const struct CDnnBatchExecutorDesc* CreateDnnBatchExecutor( const struct CDnnDesc* dnnDesc,
+	int maxBatchSize, int maxDelay, struct CDnnErrorInfo* errorInfo )
+{
+	if( dnnDesc == 0 ) {
+		initErrorInfo( DET_InvalidParameter, "Invalid CDnnDesc parameter.", errorInfo );
+		return nullptr;
+	}
+	if( maxBatchSize <= 0 ) {
+		initErrorInfo( DET_InvalidParameter, "Invalid maxBatchSize parameter.", errorInfo );
+		return nullptr;
+	}
+	if( maxDelay < 0 ) {
+		initErrorInfo( DET_InvalidParameter, "Invalid maxDelay parameter.", errorInfo );
+		return nullptr;
+	}
+	if( dnnDesc->InputCount == 0 ) {
+		initErrorInfo( DET_InvalidParameter, "The network has no inputs.", errorInfo );
+		return nullptr;
+	}
+
+	try {
+		return FINE_DEBUG_NEW CDnnBatchExecutorImpl( static_cast<const CDnnDescImpl*>( dnnDesc ), maxBatchSize, maxDelay );
+#ifdef NEOML_USE_FINEOBJ
+	} catch( CException* e ) {
+		initErrorInfo( DET_InternalError, e->MessageText().CreateString( CP_UTF8 ), errorInfo );
+		delete e;
+	}
+#else
+	} catch( std::exception& e ) {
+		initErrorInfo( DET_InternalError, e.what(), errorInfo );
+	}
+#endif
+	return nullptr;
+}
+
+void DestroyDnnBatchExecutor( const struct CDnnBatchExecutorDesc* executor )
+{
+	delete static_cast<const CDnnBatchExecutorImpl*>( executor );
+}
+
+bool DnnBatchRun( const struct CDnnBatchExecutorDesc* executorDesc, const struct CDnnBlobDesc* const* inputs,
+	const struct CDnnBlobDesc** outputs, struct CDnnErrorInfo* errorInfo )
+{
+	if( executorDesc == 0 ) {
+		initErrorInfo( DET_InvalidParameter, "Invalid CDnnBatchExecutorDesc parameter.", errorInfo );
+		return false;
+	}
+	if( inputs == 0 || outputs == 0 ) {
+		initErrorInfo( DET_InvalidParameter, "Invalid inputs or outputs parameter.", errorInfo );
+		return false;
+	}
+
+	const CDnnBatchExecutorImpl* executor = static_cast<const CDnnBatchExecutorImpl*>( executorDesc );
+	const CDnnMathEngineDescImpl* mathEngineDescImpl = static_cast<const CDnnMathEngineDescImpl*>( executor->Dnn->MathEngine );
+
+	CObjectArray<CDnnBlob> inputBlobs;
+	for( int i = 0; i < executor->Dnn->InputCount; ++i ) {
+		if( inputs[i] == 0 || inputs[i]->MathEngine != executor->Dnn->MathEngine ) {
+			initErrorInfo( DET_InvalidParameter, "Invalid CDnnBlobDesc parameter.", errorInfo );
+			return false;
+		}
+		inputBlobs.Add( static_cast<const CDnnBlobDescImpl*>( inputs[i] )->Blob );
+		if( inputBlobs[i]->GetBatchWidth() != inputBlobs[0]->GetBatchWidth() ) {
+			initErrorInfo( DET_InvalidParameter, "All inputs must have the same batch width.", errorInfo );
+			return false;
+		}
+	}
+
+	CObjectArray<CDnnBlob> outputBlobs;
+	if( !executor->Run( inputBlobs, outputBlobs, errorInfo ) ) {
+		return false;
+	}
+
+	try {
+		for( int i = 0; i < outputBlobs.Size(); ++i ) {
+			outputs[i] = FINE_DEBUG_NEW CDnnBlobDescImpl( outputBlobs[i], mathEngineDescImpl );
+		}
+		return true;
+#ifdef NEOML_USE_FINEOBJ
+	} catch( CException* e ) {
+		initErrorInfo( DET_InternalError, e->MessageText().CreateString( CP_UTF8 ), errorInfo );
+		delete e;
+	}
+#else
+	} catch( std::exception& e ) {
+		initErrorInfo( DET_InternalError, e.what(), errorInfo );
+	}
+#endif
+	return false;
+}
+
 } // extern "C"
@@ -0,0 +1,186 @@
+/* Copyright © 2017-2021 ABBYY Production LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+--------------------------------------------------------------------------------------------------------------*/
+
+#include <NeoML/NeoML.h>
+#include <NeoProxy/NeoProxy.h>
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace NeoML;
+
+static const int InputSize = 6;
+static const int OutputSize = 4;
+
+// Saves the network to a file
+static void saveDnn( CDnn& dnn, const char* fileName )
+{
+	CArchiveFile file( fileName, CArchive::SD_Storing );
+	CArchive archive( &file, CArchive::SD_Storing );
+	dnn.Serialize( archive );
+}
+
+// source -> fc -> sink; the output has the same batch width as the input
+static void createFcDnn( const char* fileName )
+{
+	CRandom random( 0x123 );
+	CDnn dnn( random, GetDefaultCpuMathEngine() );
+	CPtr<CSourceLayer> source = new CSourceLayer( dnn.GetMathEngine() );
+	source->SetName( "source" );
+	dnn.AddLayer( *source );
+	CPtr<CFullyConnectedLayer> fc = new CFullyConnectedLayer( dnn.GetMathEngine() );
+	fc->SetName( "fc" );
+	fc->SetNumberOfElements( OutputSize );
+	fc->Connect( *source );
+	dnn.AddLayer( *fc );
+	CPtr<CSinkLayer> sink = new CSinkLayer( dnn.GetMathEngine() );
+	sink->SetName( "sink" );
+	sink->Connect( *fc );
+	dnn.AddLayer( *sink );
+
+	// Initializes the weights
+	CPtr<CDnnBlob> input = CDnnBlob::CreateDataBlob( dnn.GetMathEngine(), CT_Float, 1, 1, InputSize );
+	input->Fill( 1.f );
+	source->SetBlob( input );
+	dnn.RunOnce();
+	saveDnn( dnn, fileName );
+}
+
+// source -> transpose( BatchWidth, Channels ) -> sink; the output batch width is InputSize
+static void createTransposeDnn( const char* fileName )
+{
+	CRandom random( 0x123 );
+	CDnn dnn( random, GetDefaultCpuMathEngine() );
+	CPtr<CSourceLayer> source = new CSourceLayer( dnn.GetMathEngine() );
+	source->SetName( "source" );
+	dnn.AddLayer( *source );
+	CPtr<CTransposeLayer> transpose = new CTransposeLayer( dnn.GetMathEngine() );
+	transpose->SetName( "transpose" );
+	transpose->SetTransposedDimensions( BD_BatchWidth, BD_Channels );
+	transpose->Connect( *source );
+	dnn.AddLayer( *transpose );
+	CPtr<CSinkLayer> sink = new CSinkLayer( dnn.GetMathEngine() );
+	sink->SetName( "sink" );
+	sink->Connect( *transpose );
+	dnn.AddLayer( *sink );
+	saveDnn( dnn, fileName );
+}
+
+static const CDnnBlobDesc* createInput( const CDnnMathEngineDesc* mathEngine, int batchWidth, float value )
+{
+	CDnnErrorInfo errorInfo;
+	const CDnnBlobDesc* blob = CreateDnnBlob( mathEngine, DBT_Float, 1, batchWidth, 1, 1, 1, InputSize, &errorInfo );
+	EXPECT_TRUE( blob != nullptr );
+	std::vector<float> data( batchWidth * InputSize );
+	for( size_t i = 0; i < data.size(); ++i ) {
+		data[i] = value + 0.1f * static_cast<float>( i );
+	}
+	EXPECT_TRUE( CopyToBlob( blob, data.data(), &errorInfo ) );
+	return blob;
+}
+
+static std::vector<float> getData( const CDnnBlobDesc* blob )
+{
+	CDnnErrorInfo errorInfo;
+	std::vector<float> data( blob->DataSize / sizeof( float ) );
+	EXPECT_TRUE( CopyFromBlob( data.data(), blob, &errorInfo ) );
+	return data;
+}
+
+TEST( CDnnBatchExecutorTest, ConcurrentRequests )
+{
+	const char* fileName = "NeoProxyBatchExecutorFc.cnnarch";
+	createFcDnn( fileName );
+
+	CDnnErrorInfo errorInfo;
+	const CDnnMathEngineDesc* mathEngine = CreateCPUMathEngine( 1, &errorInfo );
+	ASSERT_TRUE( mathEngine != nullptr );
+	const CDnnDesc* dnn = CreateDnnFromFile( mathEngine, fileName, &errorInfo );
+	ASSERT_TRUE( dnn != nullptr );
+
+	// The expected results are calculated by the network itself
+	const int requestCount = 8;
+	std::vector<const CDnnBlobDesc*> inputs;
+	std::vector<std::vector<float>> expected;
+	for( int i = 0; i < requestCount; ++i ) {
+		inputs.push_back( createInput( mathEngine, 1 + i % 3, static_cast<float>( i ) ) );
+		ASSERT_TRUE( SetInputBlob( dnn, 0, inputs[i], &errorInfo ) );
+		ASSERT_TRUE( DnnRunOnce( dnn, &errorInfo ) );
+		const CDnnBlobDesc* output = GetOutputBlob( dnn, 0, &errorInfo );
+		expected.push_back( getData( output ) );
+		DestroyDnnBlob( output );
+	}
+
+	const CDnnBatchExecutorDesc* executor = CreateDnnBatchExecutor( dnn, 6, 5, &errorInfo );
+	ASSERT_TRUE( executor != nullptr );
+	std::vector<std::vector<float>> actual( requestCount );
+	std::vector<int> isSucceeded( requestCount, 0 );
+	std::vector<std::thread> threads;
+	for( int i = 0; i < requestCount; ++i ) {
+		threads.emplace_back( [&, i]() {
+			CDnnErrorInfo threadErrorInfo;
+			const CDnnBlobDesc* output = nullptr;
+			isSucceeded[i] = DnnBatchRun( executor, &inputs[i], &output, &threadErrorInfo ) ? 1 : 0;
+			if( isSucceeded[i] != 0 ) {
+				actual[i] = getData( output );
+				DestroyDnnBlob( output );
+			}
+		} );
+	}
+	for( std::thread& thread : threads ) {
+		thread.join();
+	}
+	DestroyDnnBatchExecutor( executor );
+
+	for( int i = 0; i < requestCount; ++i ) {
+		ASSERT_EQ( 1, isSucceeded[i] );
+		ASSERT_EQ( expected[i].size(), actual[i].size() );
+		for( size_t j = 0; j < actual[i].size(); ++j ) {
+			EXPECT_NEAR( expected[i][j], actual[i][j], 1e-5 );
+		}
+		DestroyDnnBlob( inputs[i] );
+	}
+
+	DestroyDnn( dnn );
+	DestroyMathEngine( mathEngine );
+	std::remove( fileName );
+}
+
+// The request fails even if it is processed alone
+TEST( CDnnBatchExecutorTest, OutputBatchWidthMismatch )
+{
+	const char* fileName = "NeoProxyBatchExecutorTranspose.cnnarch";
+	createTransposeDnn( fileName );
+
+	CDnnErrorInfo errorInfo;
+	const CDnnMathEngineDesc* mathEngine = CreateCPUMathEngine( 1, &errorInfo );
+	ASSERT_TRUE( mathEngine != nullptr );
+	const CDnnDesc* dnn = CreateDnnFromFile( mathEngine, fileName, &errorInfo );
+	ASSERT_TRUE( dnn != nullptr );
+	const CDnnBatchExecutorDesc* executor = CreateDnnBatchExecutor( dnn, 4, 0, &errorInfo );
+	ASSERT_TRUE( executor != nullptr );
+
+	const CDnnBlobDesc* input = createInput( mathEngine, 1, 0.f );
+	const CDnnBlobDesc* output = nullptr;
+	EXPECT_FALSE( DnnBatchRun( executor, &input, &output, &errorInfo ) );
+	EXPECT_EQ( DET_RunDnnError, errorInfo.Type );
+
+	DestroyDnnBlob( input );
+	DestroyDnnBatchExecutor( executor );
+	DestroyDnn( dnn );
+	DestroyMathEngine( mathEngine );
+	std::remove( fileName );
+}
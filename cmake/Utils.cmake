@@ -52,6 +52,21 @@ function(add_gtest_for_target TARGET_NAME MATH_ENGINE_TYPE WORKING_DIR)
                 )
             endif()
         endif()
+
+    add_dependencies(${TARGET_NAME} NeoMathEngineAvx512)
+        if(TARGET NeoMathEngineAvx512)
+            if(WIN32)
+                add_custom_command(TARGET ${TARGET_NAME} POST_BUILD
+                    COMMAND ${CMAKE_COMMAND} -E copy $<TARGET_FILE:NeoMathEngineAvx512> $<TARGET_FILE_DIR:${TARGET_NAME}>
+                    COMMENT "Copy NeoMathEngineAvx512 to ${TARGET_NAME} binary dir to discover tests."
+                )
+            else()
+                add_custom_command(TARGET ${TARGET_NAME} POST_BUILD
+                    COMMAND ${CMAKE_COMMAND} -E copy $<TARGET_FILE:NeoMathEngineAvx512> $<TARGET_FILE_DIR:NeoMathEngine>
+                    COMMENT "Copy NeoMathEngineAvx512 to NeoMathEngine binary dir to discover tests."
+                )
+            endif()
+        endif()
     endif()
 
     string(TOLOWER ${MATH_ENGINE_TYPE} TYPE)